@@ -0,0 +1,865 @@
+/*  Author: Tony Ling
+ *  Summary: Solver daemon.  Keeps solvers running between levels, so a
+ *   stream of small levels does not pay for starting the program, reading
+ *   files and warming up for each one.  See daemon.h.
+ *
+ *  Requests are JSON objects, one per line:
+ *   {"id": 7, "level": "####\n# .#\n...", "search": "as2", "cost": "pushes",
+ *    "macro": true, "optimize": 0.5, "time_limit": 2, "node_limit": 100000,
+ *    "memory_limit": 67108864}
+ *  Only level is needed.  search is one of bfs, dfs, ucs, gbfs1, gbfs2,
+ *  as1, as2, ara, beam or retro, bfs if not given.  cost takes the values
+ *  of the -cost option, and limits of 0 are no limit.  weight is the
+ *  starting weight of ara, and beam_width, heuristic (1, 2 or 3) and
+ *  beam_retry (true or false) set up beam.  pattern_boxes (0 to 3) is the
+ *  set size of the pattern database of ara and beam with heuristic 3, the
+ *  -pdb of the daemon if not given.  visited (scan, exact or filter) and
+ *  fp_rate pick the visited set of bfs, dfs and gbfs, as the -visited and
+ *  -fp options, and dense_limit is the most bytes of its bitmap.
+ *  frontier_layers, as the -frontier option, runs bfs, as1 and as2 as
+ *  frontier search.  threads, as the -threads option, runs gbfs1, gbfs2,
+ *  as1 and as2 on that many threads of the worker, over threads times
+ *  queue_factor heaps, as the -mq option.  retro answers from the state
+ *  table of the level, built by the first retro request of the level on
+ *  each worker, or once for all of them with -pdbdir.  The level may start
+ *  with its size line, as in a level file.
+ *
+ *  Each request gets one response line, in the order the requests finish,
+ *  with the id of the request copied back:
+ *   {"id": 7, "status": "solved", "solution": "uurdl", "moves": 3,
+ *    "pushes": 2, "nodes": 450, "explored": 120, "cached": false,
+ *    "time": 0.0012}
+ *  status is solved, unsolvable when the search ran out of states,
+ *  exhausted when a limit stopped it, or error (with "error" giving the
+ *  reason).  An exhausted response names the limit ("time", "nodes",
+ *  "memory", "width" when beam finds no solution within its width, or
+ *  "cancel" when the daemon is shutting down) and gives the
+ *  moves to the best state reached and its boxes on goals:
+ *   {"id": 8, "status": "exhausted", "limit": "time", "best": "rrdldl",
+ *    "best_goals": 1, "nodes": 3000, "explored": 2890, "cached": false,
+ *    "time": 2.0001}
+ *  ara also sends a line for each better solution it finds before its
+ *  response, and its response gives the bound of the last solution, the
+ *  most its cost can be over the lowest cost as a factor, and the limit
+ *  if one stopped it before it was sure the solution is optimal:
+ *   {"id": 9, "status": "improved", "solution": "uurdl", "moves": 3,
+ *    "pushes": 2, "bound": 1.5}
+ *  beam responses also give beam_width, the width of its last pass, and
+ *  arena_bytes, the memory its nodes took.  With -dl, the workers share
+ *  one DeadlockTable, so a pattern one of them proves dead is pruned by
+ *  all of them, and responses give deadlocks_learned and deadlocks_pruned
+ *  when a search learned or pruned any.  Searches with a visited set give
+ *  visited_states and visited_bytes, the states it holds and its memory,
+ *  frontier searches give frontier_nodes and frontier_bytes, the most
+ *  nodes they held at once and their memory, retro gives table_states and
+ *  table_bytes, the states of its table and its memory, and threaded
+ *  searches give rank_error and rank_error_max, the mean and most queued
+ *  nodes better than the nodes they sampled as they explored them.
+ *  SIGINT or SIGTERM cancels the running searches, answers the requests
+ *  left, and ends the daemon.
+ */
+#include "daemon.h"
+#include "solver.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+//longest request line read, longer ones are answered with an error
+const std::string::size_type MAX_REQUEST = 16 << 20;
+
+//set by SIGINT and SIGTERM, cancels every search running or queued
+volatile bool shutting_down = false;
+
+/* JsonField is a value of a request object.  text is the value of a
+ *  string, or the token of a number, true, false or null, and raw is the
+ *  value as it was written, used to copy the id back.
+ */
+struct JsonField
+{
+	bool is_string;
+	std::string text;
+	std::string raw;
+}; //struct JsonField
+
+/* Function used to skip whitespace in a JSON line.
+ *
+ * Preconditions: JSON line, position in it
+ * Postconditions: pos moved past any whitespace
+ */
+void skip_space(const std::string &line, std::string::size_type &pos)
+{
+	while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' ||
+	 line[pos] == '\r' || line[pos] == '\n'))
+		pos++;
+} //void skip_space(const std::string &line, std::string::size_type &pos)
+
+/* Function used to read a JSON string.  \u escapes outside of ASCII are
+ *  read as '?', since levels and options are plain ASCII.
+ *
+ * Preconditions: JSON line, position of the opening quote, string to
+ *  store the value in
+ * Postconditions: returns true and moves pos past the closing quote if
+ *  the string is valid
+ */
+bool read_string(const std::string &line, std::string::size_type &pos, std::string &out)
+{
+	out.clear();
+	if (pos >= line.size() || line[pos] != '"')
+		return false;
+	for (pos++; pos < line.size(); pos++)
+	{
+		char c = line[pos];
+		if (c == '"')
+		{
+			pos++;
+			return true;
+		}
+		if (c != '\\')
+		{
+			out += c;
+			continue;
+		}
+		if (++pos >= line.size())
+			return false;
+		switch (line[pos])
+		{
+			case 'n': out += '\n'; break;
+			case 't': out += '\t'; break;
+			case 'r': out += '\r'; break;
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'u':
+			{
+				if (pos + 4 >= line.size())
+					return false;
+				long code = strtol(line.substr(pos + 1, 4).c_str(), NULL, 16);
+				out += (code < 128) ? (char)code : '?';
+				pos += 4;
+				break;
+			}
+			default: out += line[pos];
+		}
+	}
+	return false;
+} //bool read_string(const std::string &line, std::string::size_type &pos, std::string &out)
+
+/* Function used to read a flat JSON object.  Values are strings, numbers,
+ *  true, false or null; nested objects and arrays are not accepted.
+ *
+ * Preconditions: JSON line, map to store the fields in
+ * Postconditions: returns true and sets fields if the line is a valid
+ *  object, otherwise false
+ */
+bool read_object(const std::string &line, std::map<std::string, JsonField> &fields)
+{
+	std::string::size_type pos = 0;
+	fields.clear();
+	skip_space(line, pos);
+	if (pos >= line.size() || line[pos++] != '{')
+		return false;
+	skip_space(line, pos);
+	if (pos < line.size() && line[pos] == '}')
+		return true;
+	while (pos < line.size())
+	{
+		std::string key;
+		JsonField field;
+		skip_space(line, pos);
+		if (!read_string(line, pos, key))
+			return false;
+		skip_space(line, pos);
+		if (pos >= line.size() || line[pos++] != ':')
+			return false;
+		skip_space(line, pos);
+		std::string::size_type start = pos;
+		field.is_string = pos < line.size() && line[pos] == '"';
+		if (field.is_string)
+		{
+			if (!read_string(line, pos, field.text))
+				return false;
+		}
+		else
+		{
+			while (pos < line.size() && line[pos] != ',' && line[pos] != '}' &&
+			 line[pos] != ' ' && line[pos] != '\t')
+				pos++;
+			field.text = line.substr(start, pos - start);
+			if (field.text.empty() || field.text[0] == '{' || field.text[0] == '[')
+				return false;
+		}
+		field.raw = line.substr(start, pos - start);
+		fields[key] = field;
+		skip_space(line, pos);
+		if (pos >= line.size())
+			return false;
+		if (line[pos] == '}')
+			return true;
+		if (line[pos++] != ',')
+			return false;
+	}
+	return false;
+} //bool read_object(const std::string &line, std::map<std::string, JsonField> &fields)
+
+/* Function used to write a string as a JSON string.
+ *
+ * Preconditions: string
+ * Postconditions: returns the quoted and escaped string
+ */
+std::string json_quote(const std::string &text)
+{
+	std::string out = "\"";
+	for (std::string::size_type i = 0; i < text.size(); i++)
+	{
+		char c = text[i];
+		if (c == '"' || c == '\\')
+			(out += '\\') += c;
+		else if (c == '\n')
+			out += "\\n";
+		else if ((unsigned char)c < 0x20)
+		{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", c);
+			out += code;
+		}
+		else
+			out += c;
+	}
+	return out + "\"";
+} //std::string json_quote(const std::string &text)
+
+/* Function used to read the search algorithm of a request.
+ *
+ * Preconditions: name of the search algorithm
+ * Postconditions: returns the search_mode, or NONE if the name is unknown
+ */
+int search_by_name(const std::string &name)
+{
+	const char *names[] = {"bfs", "dfs", "ucs", "gbfs1", "gbfs2", "as1", "as2", "ara", "beam", "retro"};
+	const int modes[] = {BFS, DFS, UCS, GBFSH1, GBFSH2, ASH1, ASH2, ARA, BEAM, RETRO};
+	for (int i = 0; i < 10; i++)
+		if (name == names[i])
+			return modes[i];
+	return NONE;
+} //int search_by_name(const std::string &name)
+
+/* Function used to turn a request into a level and solver options.
+ *
+ * Preconditions: fields of the request, level string and SolverOptions
+ *  object to set, string to store an error in
+ * Postconditions: returns true and sets level and options if the request
+ *  is valid, otherwise false with error set
+ */
+bool read_request(std::map<std::string, JsonField> &fields, std::string &level,
+ SolverOptions &options, std::string &error)
+{
+	std::map<std::string, JsonField>::iterator it;
+
+	it = fields.find("level");
+	if (it == fields.end() || !it->second.is_string)
+	{
+		error = "request has no level";
+		return false;
+	}
+	level = it->second.text;
+	//the size line of a level file is skipped
+	std::string::size_type first = level.find('\n');
+	if (first != std::string::npos && first > 0 &&
+	 level.find_first_not_of("0123456789") == first)
+		level.erase(0, first + 1);
+	if (!level.empty() && level[level.size() - 1] != '\n')
+		level += '\n';
+
+	if ((it = fields.find("search")) != fields.end())
+	{
+		options.search = search_by_name(it->second.text);
+		if (options.search == NONE)
+		{
+			error = "unknown search " + it->second.text;
+			return false;
+		}
+	}
+	if ((it = fields.find("cost")) != fields.end() &&
+	 !parse_cost_model(it->second.text, options.costs))
+	{
+		error = "unknown cost model " + it->second.text;
+		return false;
+	}
+	if ((it = fields.find("macro")) != fields.end())
+		options.macro_moves = it->second.text == "true";
+	if ((it = fields.find("optimize")) != fields.end())
+		options.optimize_budget = atof(it->second.text.c_str());
+	if ((it = fields.find("time_limit")) != fields.end())
+		options.time_limit = atof(it->second.text.c_str());
+	if ((it = fields.find("node_limit")) != fields.end())
+		options.node_limit = atol(it->second.text.c_str());
+	if ((it = fields.find("memory_limit")) != fields.end())
+		options.memory_limit = atol(it->second.text.c_str());
+	if ((it = fields.find("weight")) != fields.end())
+	{
+		options.ara_weight = atof(it->second.text.c_str());
+		if (options.ara_weight < 1)
+		{
+			error = "weight is below 1";
+			return false;
+		}
+	}
+	if ((it = fields.find("beam_width")) != fields.end())
+	{
+		options.beam_width = atoi(it->second.text.c_str());
+		if (options.beam_width < 1)
+		{
+			error = "beam_width is below 1";
+			return false;
+		}
+	}
+	if ((it = fields.find("heuristic")) != fields.end())
+	{
+		options.beam_heuristic = atoi(it->second.text.c_str());
+		if (options.beam_heuristic < 1 || options.beam_heuristic > 3)
+		{
+			error = "unknown heuristic " + it->second.text;
+			return false;
+		}
+	}
+	if ((it = fields.find("beam_retry")) != fields.end())
+		options.beam_retry = it->second.text == "true";
+	if ((it = fields.find("pattern_boxes")) != fields.end())
+	{
+		options.pattern_boxes = atoi(it->second.text.c_str());
+		if (options.pattern_boxes < 0 || options.pattern_boxes > 3)
+		{
+			error = "pattern_boxes is not 0 to 3";
+			return false;
+		}
+	}
+	if ((it = fields.find("visited")) != fields.end() &&
+	 !parse_visited_mode(it->second.text, options.visited))
+	{
+		error = "unknown visited set " + it->second.text;
+		return false;
+	}
+	if ((it = fields.find("fp_rate")) != fields.end())
+	{
+		options.filter_rate = atof(it->second.text.c_str());
+		if (options.filter_rate <= 0 || options.filter_rate >= 1)
+		{
+			error = "fp_rate is not between 0 and 1";
+			return false;
+		}
+	}
+	if ((it = fields.find("dense_limit")) != fields.end())
+		options.dense_limit = atol(it->second.text.c_str());
+	if ((it = fields.find("frontier_layers")) != fields.end())
+	{
+		options.frontier_layers = atoi(it->second.text.c_str());
+		if (options.frontier_layers < 0)
+		{
+			error = "frontier_layers is below 0";
+			return false;
+		}
+	}
+	if ((it = fields.find("threads")) != fields.end())
+	{
+		options.threads = atoi(it->second.text.c_str());
+		if (options.threads < 1 || options.threads > 256)
+		{
+			error = "threads is not between 1 and 256";
+			return false;
+		}
+	}
+	if ((it = fields.find("queue_factor")) != fields.end())
+	{
+		options.queue_factor = atoi(it->second.text.c_str());
+		if (options.queue_factor < 1 || options.queue_factor > 64)
+		{
+			error = "queue_factor is not between 1 and 64";
+			return false;
+		}
+	}
+	return true;
+} //bool read_request(std::map<std::string, JsonField> &fields, std::string &level, SolverOptions &options, std::string &error)
+
+/* Function used to write the response line of a solved request.
+ *
+ * Preconditions: id of the request as written, SolveResult
+ * Postconditions: returns the response line
+ */
+std::string result_line(const std::string &id, const SolveResult &result)
+{
+	std::stringstream ss;
+	ss << "{\"id\": " << id << ", \"status\": \"" << status_name(result.status) << "\"";
+	if (result.status == STATUS_ERROR)
+		ss << ", \"error\": " << json_quote(result.error);
+	else if (result.status == STATUS_SOLVED)
+	{
+		const State &node = result.optimized ? result.optimized_node : result.stat.node;
+		ss << ", \"solution\": " << json_quote(compact_moves(node.move_list))
+			<< ", \"moves\": " << node.moves << ", \"pushes\": " << node.pushes;
+		if (result.stat.bound > 0)
+			ss << ", \"bound\": " << result.stat.bound;
+		if (result.stat.limit != LIMIT_NONE)
+			ss << ", \"limit\": \"" << limit_name(result.stat.limit) << "\"";
+	}
+	else if (result.status == STATUS_EXHAUSTED)
+		ss << ", \"limit\": \"" << limit_name(result.stat.limit) << "\", \"best\": "
+			<< json_quote(compact_moves(result.stat.best.move_list))
+			<< ", \"best_goals\": " << result.stat.best_goals;
+	//beam search memory is set by its width
+	if (result.stat.beam_width > 0)
+		ss << ", \"beam_width\": " << result.stat.beam_width << ", \"arena_bytes\": "
+			<< result.stat.arena_bytes;
+	if (result.stat.deadlocks_learned > 0 || result.stat.deadlocks_pruned > 0)
+		ss << ", \"deadlocks_learned\": " << result.stat.deadlocks_learned
+			<< ", \"deadlocks_pruned\": " << result.stat.deadlocks_pruned;
+	if (result.stat.visited_states > 0)
+		ss << ", \"visited_states\": " << result.stat.visited_states
+			<< ", \"visited_bytes\": " << result.stat.visited_bytes;
+	if (result.stat.table_states > 0)
+		ss << ", \"table_states\": " << result.stat.table_states
+			<< ", \"table_bytes\": " << result.stat.table_bytes;
+	if (result.stat.frontier_nodes > 0)
+		ss << ", \"frontier_nodes\": " << result.stat.frontier_nodes
+			<< ", \"frontier_bytes\": " << result.stat.frontier_bytes;
+	if (result.stat.rank_samples > 0)
+		ss << ", \"rank_error\": " << result.stat.rank_error
+			<< ", \"rank_error_max\": " << result.stat.rank_error_max;
+	ss << ", \"nodes\": " << result.stat.node_count << ", \"explored\": "
+		<< result.stat.explored_count << ", \"cached\": "
+		<< (result.from_cache ? "true" : "false") << ", \"time\": " << result.run_time << "}\n";
+	return ss.str();
+} //std::string result_line(const std::string &id, const SolveResult &result)
+
+/* Function used to write the response line of a request that could not
+ *  be solved.
+ *
+ * Preconditions: id of the request as written, reason
+ * Postconditions: returns the response line
+ */
+std::string error_line(const std::string &id, const std::string &error)
+{
+	return "{\"id\": " + id + ", \"status\": \"error\", \"error\": " + json_quote(error) + "}\n";
+} //std::string error_line(const std::string &id, const std::string &error)
+
+/* DaemonClient is where requests come from and responses go: stdin and
+ *  stdout, or a socket connection.  It is freed once its reader has hit
+ *  the end of input and none of its requests are queued or running.
+ */
+struct DaemonClient
+{
+	int in_fd;
+	int out_fd;
+	bool owns_fds;
+	bool reading;
+	int pending;
+	pthread_mutex_t write_lock;
+}; //struct DaemonClient
+
+/* Job is a request line waiting for a worker.
+ */
+struct Job
+{
+	DaemonClient *client;
+	std::string line;
+}; //struct Job
+
+/* Daemon holds the job queue shared by the readers and workers, and the
+ *  options the daemon was started with.  active counts the jobs queued or
+ *  running, and idle is signaled when a job finishes.
+ */
+struct Daemon
+{
+	const DaemonOptions *options;
+	std::deque<Job> jobs;
+	int active;
+	bool stopping;
+	pthread_mutex_t lock;
+	pthread_cond_t ready;
+	pthread_cond_t idle;
+}; //struct Daemon
+
+/* Worker is one thread of the pool and the Solver it keeps, and the
+ *  DeadlockTable shared by all workers, NULL if deadlocks are not learned.
+ */
+struct Worker
+{
+	Daemon *daemon;
+	Solver *solver;
+	DeadlockTable *deadlocks;
+	pthread_t thread;
+}; //struct Worker
+
+/* Function used to write all of a response, even if the socket takes it
+ *  in parts.  Responses to a client that has gone away are dropped.
+ *
+ * Preconditions: DaemonClient, response line
+ * Postconditions: response written to the client
+ */
+void send_line(DaemonClient *client, const std::string &line)
+{
+	pthread_mutex_lock(&client->write_lock);
+	std::string::size_type done = 0;
+	while (done < line.size())
+	{
+		ssize_t n = write(client->out_fd, line.data() + done, line.size() - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		done += n;
+	}
+	pthread_mutex_unlock(&client->write_lock);
+} //void send_line(DaemonClient *client, const std::string &line)
+
+/* Function used to free a client once nothing uses it.  The daemon lock
+ *  must be held.
+ *
+ * Preconditions: DaemonClient
+ * Postconditions: client freed if its reader and jobs are done
+ */
+void release_client(DaemonClient *client)
+{
+	if (client->reading || client->pending > 0)
+		return;
+	if (client->owns_fds)
+		close(client->in_fd);
+	pthread_mutex_destroy(&client->write_lock);
+	delete client;
+} //void release_client(DaemonClient *client)
+
+/* Function used to read the request lines of a client and queue them for
+ *  the workers, until the client closes its end.
+ *
+ * Preconditions: Daemon, DaemonClient
+ * Postconditions: every request of the client queued
+ */
+void read_requests(Daemon *daemon, DaemonClient *client)
+{
+	std::string buffer;
+	char block[65536];
+	bool too_long = false;
+
+	while (true)
+	{
+		ssize_t n = read(client->in_fd, block, sizeof(block));
+		if (n < 0 && errno == EINTR && !shutting_down)
+			continue;
+		if (n <= 0)
+			break;
+		buffer.append(block, n);
+
+		std::string::size_type start = 0, end;
+		while ((end = buffer.find('\n', start)) != std::string::npos)
+		{
+			std::string line = buffer.substr(start, end - start);
+			start = end + 1;
+			//the end of a line too long to read is skipped
+			if (too_long)
+			{
+				too_long = false;
+				continue;
+			}
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+			if (shutting_down)
+				break;
+			Job job;
+			job.client = client;
+			job.line = line;
+			pthread_mutex_lock(&daemon->lock);
+			client->pending++;
+			daemon->active++;
+			daemon->jobs.push_back(job);
+			pthread_cond_signal(&daemon->ready);
+			pthread_mutex_unlock(&daemon->lock);
+		}
+		buffer.erase(0, start);
+		if (buffer.size() > MAX_REQUEST)
+		{
+			send_line(client, error_line("null", "request longer than 16 MB"));
+			buffer.clear();
+			too_long = true;
+		}
+	}
+
+	pthread_mutex_lock(&daemon->lock);
+	client->reading = false;
+	release_client(client);
+	pthread_mutex_unlock(&daemon->lock);
+} //void read_requests(Daemon *daemon, DaemonClient *client)
+
+/* ImprovedSink is where a search sends the better solutions it finds
+ *  before it is done: the client of the request and its id.
+ */
+struct ImprovedSink
+{
+	DaemonClient *client;
+	std::string id;
+}; //struct ImprovedSink
+
+/* Function used to send a better solution of a request to its client,
+ *  called by the search through SolverOptions::improved.
+ *
+ * Preconditions: solution found, its bound, ImprovedSink of the request
+ * Postconditions: improved line sent
+ */
+void send_improved(const State &solution, const double bound, void *context)
+{
+	ImprovedSink *sink = (ImprovedSink *)context;
+	std::stringstream ss;
+	ss << "{\"id\": " << sink->id << ", \"status\": \"improved\", \"solution\": "
+		<< json_quote(compact_moves(solution.move_list)) << ", \"moves\": " << solution.moves
+		<< ", \"pushes\": " << solution.pushes << ", \"bound\": " << bound << "}\n";
+	send_line(sink->client, ss.str());
+} //void send_improved(const State &solution, const double bound, void *context)
+
+/* Function used to solve one request with the Solver of a worker.
+ *
+ * Preconditions: Worker, client of the request, request line
+ * Postconditions: returns the response line
+ */
+std::string solve_request(Worker &worker, DaemonClient *client, const std::string &line)
+{
+	Solver &solver = *worker.solver;
+	std::map<std::string, JsonField> fields;
+	std::string id = "null", level, error;
+	SolverOptions options;
+	ImprovedSink sink;
+
+	if (!read_object(line, fields))
+		return error_line(id, "request is not a JSON object");
+	if (fields.count("id"))
+		id = fields["id"].raw;
+	options.pattern_boxes = worker.daemon->options->pattern_boxes;
+	options.pattern_dir = worker.daemon->options->pattern_dir;
+	if (!read_request(fields, level, options, error))
+		return error_line(id, error);
+	if (!solver.load_level(level))
+		return error_line(id, "level has no player");
+	options.cancel = &shutting_down;
+	options.deadlocks = worker.deadlocks;
+	sink.client = client;
+	sink.id = id;
+	options.improved = send_improved;
+	options.improved_context = &sink;
+	solver.options() = options;
+	return result_line(id, solver.solve());
+} //std::string solve_request(Worker &worker, DaemonClient *client, const std::string &line)
+
+void *worker_main(void *arg)
+{
+	Worker *worker = (Worker *)arg;
+	Daemon *daemon = worker->daemon;
+
+	pthread_mutex_lock(&daemon->lock);
+	while (true)
+	{
+		while (daemon->jobs.empty() && !daemon->stopping)
+			pthread_cond_wait(&daemon->ready, &daemon->lock);
+		if (daemon->jobs.empty())
+			break;
+		Job job = daemon->jobs.front();
+		daemon->jobs.pop_front();
+		pthread_mutex_unlock(&daemon->lock);
+
+		//responses go out as soon as each request is done
+		send_line(job.client, solve_request(*worker, job.client, job.line));
+
+		pthread_mutex_lock(&daemon->lock);
+		job.client->pending--;
+		release_client(job.client);
+		daemon->active--;
+		pthread_cond_broadcast(&daemon->idle);
+	}
+	pthread_mutex_unlock(&daemon->lock);
+	return NULL;
+} //void *worker_main(void *arg)
+
+/* Function used to make a client for a pair of file descriptors.
+ *
+ * Preconditions: descriptor to read requests from and to write responses
+ *  to, whether the client closes them when done
+ * Postconditions: returns the new DaemonClient
+ */
+DaemonClient *new_client(const int in_fd, const int out_fd, const bool owns_fds)
+{
+	DaemonClient *client = new DaemonClient;
+	client->in_fd = in_fd;
+	client->out_fd = out_fd;
+	client->owns_fds = owns_fds;
+	client->reading = true;
+	client->pending = 0;
+	pthread_mutex_init(&client->write_lock, NULL);
+	return client;
+} //DaemonClient *new_client(const int in_fd, const int out_fd, const bool owns_fds)
+
+/* Function used to start a thread with SIGINT and SIGTERM blocked, so
+ *  they are taken by the main thread and wake it up from accept or read.
+ *
+ * Preconditions: pthread_t to store the thread in, thread function and
+ *  its argument
+ * Postconditions: returns 0 if the thread was started
+ */
+int start_thread(pthread_t &thread, void *(*start)(void *), void *arg)
+{
+	sigset_t stop, old;
+	sigemptyset(&stop);
+	sigaddset(&stop, SIGINT);
+	sigaddset(&stop, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stop, &old);
+	int status = pthread_create(&thread, NULL, start, arg);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	return status;
+} //int start_thread(pthread_t &thread, void *(*start)(void *), void *arg)
+
+/* ReaderArg passes a socket client to its reader thread.
+ */
+struct ReaderArg
+{
+	Daemon *daemon;
+	DaemonClient *client;
+}; //struct ReaderArg
+
+void *reader_main(void *arg)
+{
+	ReaderArg *reader = (ReaderArg *)arg;
+	read_requests(reader->daemon, reader->client);
+	delete reader;
+	return NULL;
+} //void *reader_main(void *arg)
+
+/* Function used to accept socket clients, each read by a thread of its
+ *  own, until the socket fails.
+ *
+ * Preconditions: Daemon, path of the socket
+ * Postconditions: returns false if the socket could not be opened
+ */
+bool serve_socket(Daemon *daemon, const char *path)
+{
+	sockaddr_un addr;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (fd < 0 || strlen(path) >= sizeof(addr.sun_path))
+	{
+		std::cerr << "  can not open socket " << path << std::endl;
+		return false;
+	}
+	strcpy(addr.sun_path, path);
+	unlink(path);
+	if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0)
+	{
+		std::cerr << "  can not listen on socket " << path << ": " << strerror(errno) << std::endl;
+		close(fd);
+		return false;
+	}
+	std::cerr << "  listening on " << path << std::endl;
+
+	while (true)
+	{
+		int conn = accept(fd, NULL, NULL);
+		if (conn < 0 && errno == EINTR && !shutting_down)
+			continue;
+		if (conn < 0)
+			break;
+		ReaderArg *reader = new ReaderArg;
+		reader->daemon = daemon;
+		reader->client = new_client(conn, conn, true);
+		pthread_t thread;
+		if (start_thread(thread, reader_main, reader) != 0)
+		{
+			close(conn);
+			delete reader->client;
+			delete reader;
+			continue;
+		}
+		pthread_detach(thread);
+	}
+	close(fd);
+	unlink(path);
+	return true;
+} //bool serve_socket(Daemon *daemon, const char *path)
+
+void stop_daemon(int)
+{
+	shutting_down = true;
+}
+
+/* Function used to run the daemon.  Each worker thread keeps its own
+ *  Solver for its whole life, so the node arena, the symmetries and macro
+ *  move analysis of the last level, and the mapping of the solution cache
+ *  stay warm from one request to the next.  On stdin, the daemon returns
+ *  after the end of input once every request has been answered.
+ *
+ * Preconditions: DaemonOptions
+ * Postconditions: returns the exit status of the program
+ */
+int run_daemon(const DaemonOptions &options)
+{
+	Daemon daemon;
+	std::vector<Worker> workers(options.workers > 0 ? options.workers : 1);
+	//one table for every worker, which add to it without a lock
+	DeadlockTable deadlocks(options.deadlocks ? 22 : 0);
+	std::string error;
+	int status = 0;
+
+	//a client closing early must not end the daemon
+	signal(SIGPIPE, SIG_IGN);
+	//without SA_RESTART, so a signal wakes up accept and read
+	struct sigaction stop;
+	memset(&stop, 0, sizeof(stop));
+	stop.sa_handler = stop_daemon;
+	sigaction(SIGINT, &stop, NULL);
+	sigaction(SIGTERM, &stop, NULL);
+	daemon.options = &options;
+	daemon.active = 0;
+	daemon.stopping = false;
+	pthread_mutex_init(&daemon.lock, NULL);
+	pthread_cond_init(&daemon.ready, NULL);
+	pthread_cond_init(&daemon.idle, NULL);
+
+	//solvers are made before any thread starts, see Solver::Solver
+	for (std::vector<Worker>::size_type i = 0; i < workers.size(); i++)
+	{
+		workers[i].daemon = &daemon;
+		workers[i].solver = new Solver;
+		workers[i].deadlocks = options.deadlocks ? &deadlocks : NULL;
+		if (options.cache_path != NULL && !workers[i].solver->open_cache(options.cache_path, error))
+			std::cerr << "  " << error << ", solving without cache" << std::endl;
+	}
+	for (std::vector<Worker>::size_type i = 0; i < workers.size(); i++)
+		start_thread(workers[i].thread, worker_main, &workers[i]);
+
+	if (options.socket_path != NULL)
+		status = serve_socket(&daemon, options.socket_path) ? 0 : 1;
+	else
+		read_requests(&daemon, new_client(0, 1, false));
+
+	pthread_mutex_lock(&daemon.lock);
+	while (daemon.active > 0)
+		pthread_cond_wait(&daemon.idle, &daemon.lock);
+	daemon.stopping = true;
+	pthread_cond_broadcast(&daemon.ready);
+	pthread_mutex_unlock(&daemon.lock);
+	for (std::vector<Worker>::size_type i = 0; i < workers.size(); i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		delete workers[i].solver;
+	}
+	pthread_mutex_destroy(&daemon.lock);
+	pthread_cond_destroy(&daemon.ready);
+	pthread_cond_destroy(&daemon.idle);
+	return status;
+} //int run_daemon(const DaemonOptions &options)
@@ -0,0 +1,34 @@
+/*  Author: Tony Ling
+ *  Summary: Solver daemon, see daemon.cpp.  Requests are levels with their
+ *   options as JSON lines, read from stdin or from clients of a Unix domain
+ *   socket, and solved on a pool of worker threads.
+ */
+#ifndef SKB_DAEMON_H
+#define SKB_DAEMON_H
+
+#include <cstddef>
+
+/* DaemonOptions are the choices made when the daemon starts: the socket
+ *  to listen on (NULL to read stdin and write stdout), the number of
+ *  worker threads, the solution cache file the workers share (NULL for
+ *  none), whether the workers learn deadlock patterns into a table they
+ *  share, and the pattern database of requests that do not choose one:
+ *  its set size (0 for none) and the directory of its files (NULL to keep
+ *  it in memory).
+ */
+struct DaemonOptions
+{
+	const char *socket_path;
+	int workers;
+	const char *cache_path;
+	bool deadlocks;
+	int pattern_boxes;
+	const char *pattern_dir;
+
+	DaemonOptions() : socket_path(NULL), workers(4), cache_path(NULL), deadlocks(false),
+	 pattern_boxes(0), pattern_dir(NULL) {}
+}; //struct DaemonOptions
+
+int run_daemon(const DaemonOptions &options);
+
+#endif
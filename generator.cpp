@@ -0,0 +1,402 @@
+/*  Author: Tony Ling
+ *  Summary: Level generator and scaling benchmark.  See generator.h.
+ *
+ *  A level is made in three steps.  The room is stamped from 3x3 block
+ *   templates, each turned and mirrored at random, and only its largest
+ *   connected stretch of floor is kept.  Goals are then picked on the
+ *   floor with a box on each, and the player is put on the floor.  Last,
+ *   the boxes are pulled away from the goals by reverse play: a pull moves
+ *   the player one cell away from a box next to it and drags the box
+ *   along, so pushing it back undoes it, and the level is solvable by
+ *   playing the pulls backward.  The state furthest from solved along the
+ *   pulls, with the most boxes off goals and then the most steps from the
+ *   boxes to their nearest goals, is the level made.
+ *
+ *  The scaling benchmark makes levels of 1 box up to the boxes given,
+ *   solves each with every search algorithm, and writes a table of the
+ *   levels solved, the mean run time, nodes and arena bytes of each search
+ *   at each box count, one block per search, for plotting.  A search that
+ *   solves none of the levels of a box count is not run on larger ones.
+ */
+#include "generator.h"
+#include "solver.h"
+#include <stdint.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+
+//3x3 room templates, '#' for wall, turned and mirrored as they are stamped
+const char *room_templates[][3] = {
+	{"   ", "   ", "   "},
+	{"#  ", "   ", "   "},
+	{"## ", "   ", "   "},
+	{"###", "   ", "   "},
+	{"#  ", "#  ", "   "},
+	{"   ", " # ", "   "},
+	{"#  ", "   ", "  #"},
+	{"## ", "#  ", "   "},
+	{"###", "#  ", "#  "},
+	{"# #", "   ", "   "},
+	{"###", "###", "   "}
+};
+const int ROOM_TEMPLATES = sizeof(room_templates) / sizeof(room_templates[0]);
+
+//offsets of the directions 'u', 'r', 'd' and 'l' as x and y
+const int GEN_DX[4] = {0, 1, 0, -1};
+const int GEN_DY[4] = {-1, 0, 1, 0};
+
+/* LevelRandom is the random number generator of the generator, splitmix64,
+ *  so the same seed makes the same level on every platform.
+ */
+struct LevelRandom
+{
+	uint64_t state;
+
+	LevelRandom(const unsigned long seed) : state(seed) {}
+
+	uint64_t next()
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	//random int from 0 to n - 1
+	int below(const int n) { return (int)(next() % (uint64_t)n); }
+}; //struct LevelRandom
+
+/* Function used to stamp a room from the templates and keep its largest
+ *  connected floor.
+ *
+ * Preconditions: width and height of the board, random numbers, wall
+ *  vector to fill, one char per cell
+ * Postconditions: returns the floor cells left, walls set
+ */
+int stamp_room(const int width, const int height, LevelRandom &random, std::vector<char> &walls)
+{
+	walls.assign(width * height, 1);
+	for (int by = 1; by < height - 1; by += 3)
+		for (int bx = 1; bx < width - 1; bx += 3)
+		{
+			int t = random.below(ROOM_TEMPLATES), turn = random.below(4);
+			bool mirror = random.below(2) == 1;
+			for (int y = 0; y < 3; y++)
+				for (int x = 0; x < 3; x++)
+				{
+					//cell of the template stamped at x, y
+					int tx = mirror ? 2 - x : x, ty = y;
+					for (int r = 0; r < turn; r++)
+					{
+						int old = tx;
+						tx = ty;
+						ty = 2 - old;
+					}
+					int cx = bx + x, cy = by + y;
+					if (cx < width - 1 && cy < height - 1)
+						walls[cy * width + cx] = room_templates[t][ty][tx] == '#';
+				}
+		}
+
+	//largest connected floor kept, the rest walled up
+	std::vector<int> part(width * height, -1);
+	int best = -1, best_size = 0, parts = 0;
+	for (int start = 0; start < width * height; start++)
+	{
+		if (walls[start] || part[start] >= 0)
+			continue;
+		int size = 0;
+		std::deque<int> frontier(1, start);
+		part[start] = parts;
+		while (!frontier.empty())
+		{
+			int cell = frontier.front();
+			frontier.pop_front();
+			size++;
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int next = cell + GEN_DY[dir] * width + GEN_DX[dir];
+				if (!walls[next] && part[next] < 0)
+				{
+					part[next] = parts;
+					frontier.push_back(next);
+				}
+			}
+		}
+		if (size > best_size)
+		{
+			best = parts;
+			best_size = size;
+		}
+		parts++;
+	}
+	for (int cell = 0; cell < width * height; cell++)
+		if (part[cell] != best)
+			walls[cell] = 1;
+	return best_size;
+} //int stamp_room(const int width, const int height, LevelRandom &random, std::vector<char> &walls)
+
+/* Function used to write a generated level in the text form of a level
+ *  file, without the size line.  Walls with no floor around them are left
+ *  out as empty space, and lines end at their last wall.
+ *
+ * Preconditions: board width and height, walls, goals and boxes of the
+ *  board, one char per cell, and the cell of the player
+ * Postconditions: returns the level string
+ */
+std::string write_level(const int width, const int height, const std::vector<char> &walls,
+ const std::vector<char> &goals, const std::vector<char> &boxes, const int player)
+{
+	std::string level;
+	for (int y = 0; y < height; y++)
+	{
+		std::string line;
+		for (int x = 0; x < width; x++)
+		{
+			int cell = y * width + x;
+			char c = ' ';
+			if (cell == player)
+				c = goals[cell] ? '+' : '@';
+			else if (boxes[cell])
+				c = goals[cell] ? '*' : '$';
+			else if (goals[cell])
+				c = '.';
+			else if (walls[cell])
+			{
+				//a wall is only drawn if it borders the floor
+				c = ' ';
+				for (int dy = -1; dy <= 1; dy++)
+					for (int dx = -1; dx <= 1; dx++)
+					{
+						int nx = x + dx, ny = y + dy;
+						if (nx >= 0 && ny >= 0 && nx < width && ny < height &&
+						 !walls[ny * width + nx])
+							c = '#';
+					}
+			}
+			line += c;
+		}
+		line.erase(line.find_last_not_of(' ') + 1);
+		if (!line.empty())
+			level.append(line) += "\n";
+	}
+	return level;
+} //std::string write_level(const int width, const int height, const std::vector<char> &walls, const std::vector<char> &goals, const std::vector<char> &boxes, const int player)
+
+/* Function used to generate a level by reverse play, see the top of this
+ *  file.  The difficulty sets the pulls made, 8 per box per level of
+ *  difficulty, and how often a pull moves the same box as the one before,
+ *  which takes boxes further from their goals.
+ *
+ * Preconditions: GeneratorOptions of the level, string to store an error
+ * Postconditions: returns the level string, without the size line, or an
+ *  empty string with error set if no level could be made
+ */
+std::string generate_level(const GeneratorOptions &options, std::string &error)
+{
+	const int width = options.width, height = options.height;
+	if (width < 5 || height < 5 || width > 64 || height > 64)
+	{
+		error = "board size must be from 5x5 to 64x64";
+		return "";
+	}
+	if (options.boxes < 1 || options.difficulty < 1 || options.difficulty > 5)
+	{
+		error = "need at least 1 box and a difficulty from 1 to 5";
+		return "";
+	}
+
+	LevelRandom random(options.seed);
+	std::vector<char> walls, goals, boxes, best_boxes, seen;
+	std::vector<int> floor, distance, reached;
+	for (int attempt = 0; attempt < 100; attempt++)
+	{
+		//room with space to move the boxes around
+		if (stamp_room(width, height, random, walls) < 3 * options.boxes + 4)
+			continue;
+		floor.clear();
+		for (int cell = 0; cell < width * height; cell++)
+			if (!walls[cell])
+				floor.push_back(cell);
+
+		//goals with a box on each, and the player on another cell
+		goals.assign(width * height, 0);
+		for (int placed = 0; placed < options.boxes; )
+		{
+			int cell = floor[random.below(floor.size())];
+			if (!goals[cell])
+			{
+				goals[cell] = 1;
+				placed++;
+			}
+		}
+		boxes = goals;
+		int player;
+		do
+			player = floor[random.below(floor.size())];
+		while (goals[player]);
+
+		//steps from each cell to the nearest goal, for scoring states
+		distance.assign(width * height, -1);
+		std::deque<int> frontier;
+		for (int cell = 0; cell < width * height; cell++)
+			if (goals[cell])
+			{
+				distance[cell] = 0;
+				frontier.push_back(cell);
+			}
+		while (!frontier.empty())
+		{
+			int cell = frontier.front();
+			frontier.pop_front();
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int next = cell + GEN_DY[dir] * width + GEN_DX[dir];
+				if (!walls[next] && distance[next] < 0)
+				{
+					distance[next] = distance[cell] + 1;
+					frontier.push_back(next);
+				}
+			}
+		}
+
+		//reverse play, keeping the state furthest from solved
+		long best_score = 0;
+		int best_player = player, last_box = -1;
+		int pulls = 8 * options.boxes * options.difficulty;
+		for (int pull = 0; pull < pulls; pull++)
+		{
+			//cells the player can reach without moving a box
+			seen.assign(width * height, 0);
+			reached.assign(1, player);
+			seen[player] = 1;
+			for (std::vector<int>::size_type i = 0; i < reached.size(); i++)
+				for (int dir = 0; dir < 4; dir++)
+				{
+					int next = reached[i] + GEN_DY[dir] * width + GEN_DX[dir];
+					if (!walls[next] && !boxes[next] && !seen[next])
+					{
+						seen[next] = 1;
+						reached.push_back(next);
+					}
+				}
+
+			//pulls the player can make, as cell * 4 + direction of the box,
+			//with the ones that move the last box pulled kept apart
+			std::vector<int> moves, same;
+			for (std::vector<int>::size_type i = 0; i < reached.size(); i++)
+				for (int dir = 0; dir < 4; dir++)
+				{
+					int off = GEN_DY[dir] * width + GEN_DX[dir];
+					int box = reached[i] + off, back = reached[i] - off;
+					if (!boxes[box] || walls[back] || boxes[back])
+						continue;
+					moves.push_back(reached[i] * 4 + dir);
+					if (box == last_box)
+						same.push_back(reached[i] * 4 + dir);
+				}
+			if (moves.empty())
+				break;
+			int move = (!same.empty() && random.below(6) < options.difficulty) ?
+			 same[random.below(same.size())] : moves[random.below(moves.size())];
+			int cell = move / 4, off = GEN_DY[move % 4] * width + GEN_DX[move % 4];
+			boxes[cell + off] = 0;
+			boxes[cell] = 1;
+			player = cell - off;
+			last_box = cell;
+
+			long score = 0;
+			for (std::vector<int>::size_type i = 0; i < floor.size(); i++)
+				if (boxes[floor[i]] && !goals[floor[i]])
+					score += 1000 + distance[floor[i]];
+			if (score > best_score)
+			{
+				best_score = score;
+				best_boxes = boxes;
+				best_player = player;
+			}
+		}
+		if (best_score == 0)
+			continue;
+		return write_level(width, height, walls, goals, best_boxes, best_player);
+	}
+	error = "no level could be made with that many boxes on that board";
+	return "";
+} //std::string generate_level(const GeneratorOptions &options, std::string &error)
+
+/* Function used to run the scaling benchmark, see the top of this file.
+ *  The levels of b boxes are made with seeds seed + 1000 * b + i, so any
+ *  of them can be made again with the -gen option.
+ *
+ * Preconditions: ScaleOptions of the benchmark, stream to write the table
+ * Postconditions: returns 0, or 1 if a level could not be made
+ */
+int run_scale_bench(const ScaleOptions &options, std::ostream &out)
+{
+	const char *names[] = {"bfs", "dfs", "ucs", "gbfs1", "gbfs2", "as1", "as2", "ara", "beam"};
+	const int modes[] = {BFS, DFS, UCS, GBFSH1, GBFSH2, ASH1, ASH2, ARA, BEAM};
+	const GeneratorOptions &level = options.level;
+	std::vector< std::vector<std::string> > levels(level.boxes + 1);
+	std::string error;
+
+	//the same levels are given to every search
+	for (int boxes = 1; boxes <= level.boxes; boxes++)
+		for (int i = 0; i < options.levels; i++)
+		{
+			GeneratorOptions gen = level;
+			gen.boxes = boxes;
+			gen.seed = level.seed + 1000 * boxes + i;
+			levels[boxes].push_back(generate_level(gen, error));
+			if (levels[boxes].back().empty())
+			{
+				out << "# " << boxes << " boxes: " << error << std::endl;
+				return 1;
+			}
+		}
+
+	Solver solver;
+	SolverOptions &solve = solver.options();
+	solve.time_limit = options.time_limit;
+	solve.node_limit = options.node_limit;
+	solve.memory_limit = options.memory_limit;
+	if (solve.time_limit <= 0 && solve.node_limit <= 0 && solve.memory_limit <= 0)
+		solve.time_limit = 10;
+	out << "# scaling benchmark: " << level.width << "x" << level.height << " boards, difficulty "
+		<< level.difficulty << ", " << options.levels << " levels per box count, seed "
+		<< level.seed << std::endl;
+	out << "# search\tboxes\tsolved\ttime\tnodes\tarena_bytes" << std::endl;
+	for (int s = 0; s < 9; s++)
+	{
+		solve.search = modes[s];
+		out << "# " << search_title(modes[s]) << std::endl;
+		for (int boxes = 1; boxes <= level.boxes; boxes++)
+		{
+			int solved = 0;
+			double run_time = 0;
+			double nodes = 0, bytes = 0;
+			for (int i = 0; i < options.levels; i++)
+			{
+				solver.load_level(levels[boxes][i]);
+				SolveResult result = solver.search();
+				if (result.status == STATUS_SOLVED)
+					solved++;
+				run_time += result.run_time;
+				nodes += result.stat.node_count;
+				bytes += result.stat.arena_bytes;
+			}
+			out << names[s] << "\t" << boxes << "\t" << solved << "/" << options.levels << "\t"
+				<< run_time / options.levels << "\t" << (long)(nodes / options.levels) << "\t"
+				<< (long)(bytes / options.levels) << std::endl;
+			//a search that solves nothing here will not solve larger levels
+			if (solved == 0)
+			{
+				out << "# " << names[s] << " stops scaling at " << boxes << " boxes" << std::endl;
+				break;
+			}
+		}
+		//two blank lines end a block, a gnuplot index
+		out << std::endl << std::endl;
+	}
+	return 0;
+} //int run_scale_bench(const ScaleOptions &options, std::ostream &out)
@@ -0,0 +1,48 @@
+/*  Author: Tony Ling
+ *  Summary: Level generator and scaling benchmark, see generator.cpp.
+ *   Levels are made by pulling boxes away from their goals in a random
+ *   room, so every level made can be solved, and the same seed always
+ *   makes the same level.
+ */
+#ifndef SKB_GENERATOR_H
+#define SKB_GENERATOR_H
+
+#include <ostream>
+#include <string>
+
+/* GeneratorOptions are the choices of a generated level: the board size,
+ *  outer walls included (5 to 64 cells each way), the number of boxes,
+ *  the difficulty from 1 to 5, which sets how many pulls are made, and
+ *  the seed of the random numbers.
+ */
+struct GeneratorOptions
+{
+	int width;
+	int height;
+	int boxes;
+	int difficulty;
+	unsigned long seed;
+
+	GeneratorOptions() : width(10), height(9), boxes(3), difficulty(2), seed(1) {}
+}; //struct GeneratorOptions
+
+/* ScaleOptions are the choices of the scaling benchmark: the levels are
+ *  made with level, with 1 to level.boxes boxes and levels of each box
+ *  count, and each search is stopped by the limits given, or after 10
+ *  seconds if none is.
+ */
+struct ScaleOptions
+{
+	GeneratorOptions level;
+	int levels;
+	double time_limit;
+	long node_limit;
+	long memory_limit;
+
+	ScaleOptions() : levels(3), time_limit(0), node_limit(0), memory_limit(0) {}
+}; //struct ScaleOptions
+
+std::string generate_level(const GeneratorOptions &options, std::string &error);
+int run_scale_bench(const ScaleOptions &options, std::ostream &out);
+
+#endif
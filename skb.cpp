@@ -9,6 +9,61 @@
  *                     search and A* search. enum search_mode added.
  *         9/16/2013 - Heuristics function 2 implemented for greedy best first
  *                     search and A* search.
+ *         10/18/2026 - Persistent solution cache added.  Solutions are stored
+ *                     in a memory-mapped file keyed by a hash of the level,
+ *                     search algorithm and cost model.
+ *         10/18/2026 - Grid symmetries added.  Symmetric states are merged
+ *                     when checking for duplicates, and cached solutions
+ *                     are shared by rotated and mirrored levels.
+ *         10/18/2026 - Tunnel and goal room macro moves added (-m option).
+ *         10/18/2026 - Searches keep their nodes in a NodeArena and refer to
+ *                     them by index.  Heap allocations and peak memory are
+ *                     reported after each search.
+ *         10/18/2026 - Cost models added (-cost option).  Uniform cost and
+ *                     A* search use a bucket queue for their open lists.
+ *         10/18/2026 - Solution optimizer added (-o option).
+ *         10/18/2026 - Searches, state generation and heuristics compiled
+ *                     for fixed board sizes, with states packed as bitboards.
+ *         10/18/2026 - Goal test and heuristics use bitboard masks, with
+ *                     SSE4.1 and AVX2 bit kernels chosen at startup.
+ *         10/18/2026 - Bit parallel player reachability flood fill added,
+ *                     with a benchmark against breadth first search (-bench).
+ *         10/18/2026 - Solver split out into solver.h and solver.cpp, so it
+ *                     can be embedded.  This file is the command line
+ *                     program built on it.
+ *         10/18/2026 - Daemon mode added (-daemon option), solving JSON line
+ *                     requests from stdin or a Unix socket on worker threads.
+ *         10/18/2026 - Time, node and memory limits added (-t, -n and -mem
+ *                     options).  A search stopped by one is exhausted and
+ *                     reports the best state it reached.
+ *         10/18/2026 - Anytime repairing A* search added, reporting better
+ *                     solutions as it finds them (-w option).
+ *         10/18/2026 - Beam search added, keeping the best nodes of each
+ *                     depth (-beam and -retry options).
+ *         10/18/2026 - Levels trimmed to the cells the player can reach, and
+ *                     states packed by floor cell in the node arena.
+ *         10/18/2026 - Seeded level generator (-gen option) and scaling
+ *                     benchmark over box counts (-scale option) added.
+ *         10/18/2026 - Deadlock patterns learned by small searches and kept
+ *                     in a lock-free table shared by searches (-dl option).
+ *         10/18/2026 - Pattern database for heuristics function 3, stored in
+ *                     memory-mapped files (-pdb and -pdbdir options).
+ *         10/18/2026 - Distributed search over worker processes for breadth
+ *                     first, uniform cost and A* search (-procs option).
+ *         10/18/2026 - Exact and fingerprint filter visited sets for breadth
+ *                     first, depth first and greedy best first search
+ *                     (-visited and -fp options).
+ *         10/18/2026 - Frontier search for breadth first and A* search,
+ *                     keeping only the last layers of closed nodes and
+ *                     rebuilding the path by divide and conquer (-frontier
+ *                     option).
+ *         10/18/2026 - Exact visited sets become a bitmap indexed by the
+ *                     rank of each state on small levels (-dense option).
+ *         10/18/2026 - Retrograde state table of the fewest moves from
+ *                     every state of small levels (menu option 8).
+ *         10/18/2026 - Greedy best first and A* search on threads sharing
+ *                     a relaxed multi-queue open list (-threads and -mq
+ *                     options).
  * 
  *  Sokoban level character key:
  *   	(empty) 	Empty floor
@@ -22,1989 +77,233 @@
  *  Resources: 
  *    Runtime:
  *      http://pubs.opengroup.org/onlinepubs/7908799/xsh/systime.h.html
+ *    Solution cache:
+ *      http://pubs.opengroup.org/onlinepubs/7908799/xsh/mmap.html
+ *      http://www.isthe.com/chongo/tech/comp/fnv/
  *    Heuristics:
  *      http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.164.9379&rep=rep1&type=pdf
  *      http://fragfrog.nl/papers/solving_the_sokoban_problem.pdf
  */
+#include "solver.h"
+#include "daemon.h"
+#include "generator.h"
 #include <sys/time.h>
+#include <sys/resource.h>
 #include <iostream>
 #include <cstdlib>
-#include <sstream>
-#include <vector>
-#include <queue>
-#include <deque>
+#include <cstdio>
 #include <string>
 #include <fstream>
+#include <vector>
+#include <new>
 
-enum search_mode {NONE, UCS, GBFSH1, GBFSH2, ASH1, ASH2, BFS, DFS};
-
-/* States contain the level, how many moves/pushes and move list to get
- * to that state, and how deep that state is in node terms
+/* HeapStat counts heap use through the replacement operator new and
+ *  delete below, so a search can report how many allocations it made and
+ *  its peak heap size.  Counters are updated with atomic builtins.
  */
-struct State
+struct HeapStat
 {
-	std::string state_str;
-	std::string move_list;
-	int depth;
-	int moves;
-	int pushes;
-	int total_cost;
-	int hscore;
-}; //struct State
+	long allocs;
+	long bytes_in_use;
+	long peak_bytes;
+}; //struct HeapStat
 
-/* SearchStat used to count search algorithm information, such as amount
- * of nodes, duplicate nodes, fringe nodes and explored nodes.
- */
-struct SearchStat
-{
-	State node;
-	int node_count;
-	int rep_node_count;
-	int fringe_node;
-	int explored_count;
-}; //struct SearchStat
+HeapStat heap_stat = {0, 0, 0};
 
-/* Function used to check if state is the goal state. Goal state is a
- *  state with no empty goals, nor player on goal. Assumes that there
- *  exists at least 1 empty goal, ie a level with at least 1 empty goal
- *  to fill, with the same amount of goals as boxes, and only 1 player.
- * 
- * Preconditions: State object representing current state in agent prog
- * Postconditions: Returns true if goal state is found, otherwise false
- */
-bool is_goal(State &cur_state)
-{
-	//std::cout << cur_state.state_str<<std::endl;
-	bool goal = false;
-	//if there are no empty goals
-	if ((cur_state.state_str.find_first_of('.')) == std::string::npos)
-	{
-		//if there are no players standing on an empty goal,
-		//then we are in goal state
-		if ((cur_state.state_str.find_first_of('+')) == std::string::npos)
-		{
-			//and there are no boxes not on a goal
-			if ((cur_state.state_str.find_first_of('$')) == std::string::npos)
-				goal = true;
-		}
-	}
-	return goal;
-} //bool is_goal(State &cur_state)
+#if __cplusplus < 201103L
+#define SKB_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define SKB_NOTHROW throw()
+#else
+#define SKB_THROW_BAD_ALLOC
+#define SKB_NOTHROW noexcept
+#endif
 
-/* Function used to print out a level state if that state is stored in a
- *  vector of vector<char>.  It iterattes through the vector, printing
- *  out each char of each vector.
+/* Function used to allocate a counted heap block.  Each block starts with
+ *  its size, padded to keep the returned pointer 16 byte aligned.
  * 
- * Preconditions: vector<vector<char>> object
- * Postcoditions: prints out each element in the vector of vectors, with
- *  new line seperated each vector
+ * Preconditions: size of the block
+ * Postconditions: returns the block, or NULL if out of memory
  */
-void print_level(std::vector< std::vector<char> > &map)
+void *counted_alloc(std::size_t size)
 {
-	for (int i = 0; i < map.size(); i++)
-	{
-		std::vector<char> vec = map[i];
-		std::vector<char>::iterator itr;
-		for (itr = vec.begin(); itr != vec.end(); itr++)
-			std::cout << *itr;
-		std::cout << std::endl;
-	}
-} //void print_level(std::vector< std::vector<char> > &map)
+	char *block = (char *)malloc(size + 16);
+	if (block == NULL)
+		return NULL;
+	*(std::size_t *)block = size;
+	__sync_fetch_and_add(&heap_stat.allocs, 1);
+	long in_use = __sync_add_and_fetch(&heap_stat.bytes_in_use, (long)size);
+	long peak = heap_stat.peak_bytes;
+	while (in_use > peak && !__sync_bool_compare_and_swap(&heap_stat.peak_bytes, peak, in_use))
+		peak = heap_stat.peak_bytes;
+	return block + 16;
+} //void *counted_alloc(std::size_t size)
 
-/* Heuristics function uses Manhattan distance between player and
- *  nearest box, and between the boxes and the goals.
- *  Assumes only 1 player on level.
+/* Function used to free a block from counted_alloc.
  * 
- * Preconditions: State object
- * Postcoditions: int return representing heuristics score
+ * Preconditions: block from counted_alloc, or NULL
+ * Postconditions: block freed
  */
-int h1(const State &cur_state)
+void counted_free(void *ptr)
 {
-	std::stringstream ss(cur_state.state_str);
-	std::string line;
-	int x, y, counter = 0;
-	std::vector< std::vector<int> > box_list;
-	std::vector< std::vector<int> > goal_list;
-	int score = 0;
-	int playerdist = 1000;
+	if (ptr == NULL)
+		return;
+	char *block = (char *)ptr - 16;
+	__sync_fetch_and_sub(&heap_stat.bytes_in_use, (long)*(std::size_t *)block);
+	free(block);
+} //void counted_free(void *ptr)
 
-	while (getline(ss,line, '\n'))
-	{
-		for (int i = 0; i <line.length() ; i++)
-		{
-			//assumes only 1 player exists in any given state
-			//if found user, set x, y positions
-			if (line[i] == '@')
-			{
-				x = i;
-				y = counter;
-			}
-			//if player is on an empty goal, pos of player
-			//is the same as an empty goal
-			else if (line[i] == '+' )
-			{
-				x = i;
-				y = counter;
-				std::vector<int> goal_loc;
-				goal_loc.push_back(i);
-				goal_loc.push_back(counter);
-				goal_list.push_back(goal_loc);
-			}
-			//if box on floor, add to box list
-			else if (line[i] == '$' )
-			{
-				std::vector<int> box_loc;
-				box_loc.push_back(i);
-				box_loc.push_back(counter);
-				box_list.push_back(box_loc);
-			}
-			//if empty goal, add to goal list
-			else if (line[i] == '.' )
-			{
-				std::vector<int> goal_loc;
-				goal_loc.push_back(i);
-				goal_loc.push_back(counter);
-				goal_list.push_back(goal_loc);
-			}
-			//if there is a box on a goal, then it should take
-			//precidence over non fill goals in case there are multiple
-			//boxes and goals.  we want the program to let the box remain
-			//on the goal.  to this end, -1000 is added to the score
-			else if(line[i] == '*')
-			{
-				score -= 1000;
-			}
-		}
-		counter++;
-	}
-
-	//for each box on the floor, calculate the distance to each empty goal
-	for (int i = 0; i < box_list.size(); i++)
-	{
-		for (int j = 0; j < goal_list.size(); j++)
-		{
-			//calculate distance of x and y cords
-			int xdist = box_list[i][0] - goal_list[j][0];
-			int ydist = box_list[i][1] - goal_list[j][1];
-			//take absolute value of distance
-			if (xdist < 0)
-				xdist *= -1;
-			if (ydist < 0)
-				ydist *= -1;
-			//add distance to score, lower score = better
-			score += xdist;
-			score += ydist;
-		}
-		//calculate player to box distances
-		int p_to_box_x = box_list[i][0] - x;
-		int p_to_box_y = box_list[i][1] - y;
-		//take absolute value of distance
-		if (p_to_box_x < 0)
-			p_to_box_x *= -1;
-		if (p_to_box_y < 0)
-			p_to_box_y *= -1;
-		//stores shortest distance to any box
-		//NOTE: This only works if shortest distance is within 1000 tiles
-		if (playerdist > (p_to_box_y + p_to_box_x))
-			playerdist = (p_to_box_y + p_to_box_x);
-	}
-	score += playerdist;
-	return score;
-} //int h1(const State &cur_state)
-
-/* Heuristics function checks to see if boxes not on goals are in any
- *  'unsafe' position.  Unsafe positions are corners with no goals, and
- *  tiles along unbroken walls of 2 unsafe corners with no goals along
- *  the wall.  Unlike heuristics function 1, this function calculates
- *  no distances between any objects, nor prioritizes boxes already on
- *  goals.
- * 
- * Preconditions: State object
- * Postcoditions: int return representing heuristics score
- */
-int h2(const State &cur_state)
+void *operator new(std::size_t size) SKB_THROW_BAD_ALLOC
 {
-	std::stringstream ss(cur_state.state_str);
-	std::vector< std::vector<int> > box_list;
-	std::vector< std::vector<char> > level_map;
-	std::string line;
-	int score = 0, counter = 0;
-
-	//generates level map and marks where boxes are level map stored as
-	//(y,x) cordinates since reads lines by line first (y plane) and
-	//then char by char (x plane)
-	while (getline(ss,line, '\n'))
-	{
-		std::vector<char> temp;
-		level_map.push_back(temp);
-		for (int i = 0; i <line.length() ; i++)
-		{
-			//if box on floor, add to box list
-			//ignores boxes on goals since they cannot
-			//be unsafe positions
-			if (line[i] == '$' )
-			{
-				std::vector<int> box_loc;
-				box_loc.push_back(i);
-				box_loc.push_back(counter);
-				box_list.push_back(box_loc);
-			}
-			level_map[counter].push_back(line[i]);
-		}
-		counter++;
-	}
-
-	//for each box on the floor, check if it is adjacent to a wall
-	//if adjacent against 2 walls that are next to each other,
-	//then  it is a corner
-	for (int i = 0; i < box_list.size(); i++)
-	{
-		bool N_wall = false;
-		bool E_wall = false;
-		bool S_wall = false;
-		bool W_wall = false;
-		bool in_corner = false;
-		
-		int cur_box_x = box_list[i][0];
-		int cur_box_y = box_list[i][1];
-		
-		//check if there is a wall north of the box
-		if (level_map[cur_box_y - 1][cur_box_x] == '#')
-			N_wall = true;
-		//check if there is a wall east of the box
-		if (level_map[cur_box_y][cur_box_x + 1] == '#')
-			E_wall = true;
-		//check if there is a wall south of the box
-		if (level_map[cur_box_y + 1][cur_box_x] == '#')
-			S_wall = true;
-		//check if there is a wall west of the box
-		if (level_map[cur_box_y][cur_box_x - 1] == '#')
-			W_wall = true;
-		
-		//first check if box is in a corner
-		//check if box in NE corner
-		if (N_wall && E_wall)
-		{
-			in_corner = true;
-		}
-		//check if box in NW corner
-		else if (N_wall && W_wall)
-		{
-			in_corner = true;
-		}
-		//check if box in SE corner
-		else if (S_wall && E_wall)
-		{
-			in_corner = true;
-		}
-		//check if box in SW corner
-		else if (S_wall && W_wall)
-		{
-			in_corner = true;
-		}
-		
-		//if box is ever in a corner, then box is in a deadlock position
-		if (in_corner)
-		{
-			score += 1000;
-		}
-		//if box is next to a wall, check to see if wall is unbroken with
-		//2 unsafe corners and no goals along the wall
-		else
-		{
-			//if wall north of box, search for and east-most and west-most wall
-			if (N_wall)
-			{
-				bool safe = false;
-				bool corner_E = false;
-				bool corner_W = false;
-				
-				//search east to see if there are accessible tiles along unbroken
-				//north walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_x + 1; i < level_map[cur_box_y].size(); i++)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[cur_box_y][i] == '.') ||
-					 (level_map[cur_box_y][i] == '*') || (level_map[cur_box_y][i] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if north tile is not a wall, then it is safe
-					if (level_map[cur_box_y - 1][i] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if NE corner
-					if ((level_map[cur_box_y][i] == '#') && (level_map[cur_box_y - 1][i] == '#'))
-					{
-						corner_E = true;
-						break;
-					}
-				}
-				
-				//search west to see if there are accessible tiles along unbroken
-				//north walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_x - 1; i >= 0 ; i--)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[cur_box_y][i] == '.') ||
-					 (level_map[cur_box_y][i] == '*') || (level_map[cur_box_y][i] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if north tile is not a wall, then it is safe
-					if (level_map[cur_box_y - 1][i] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if NW corner
-					if ((level_map[cur_box_y][i] == '#') && (level_map[cur_box_y - 1][i] == '#'))
-					{
-						corner_W = true;
-						break;
-					}
-				}
-				
-				//if unbroken wall along path east and west of the box to corners with any goal
-				//increment score to signify unsafe position
-				if (!safe)
-				{
-					if(corner_E && corner_W)
-						score += 1000;
-				}	
-			}
-			
-			//if wall north of box, search for and north-most and south-most wall
-			if (E_wall)
-			{
-				bool safe = false;
-				bool corner_N = false;
-				bool corner_S = false;
-				
-				//search north to see if there are accessible tiles along unbroken
-				//east walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_y - 1; i >=0; i--)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[i][cur_box_x] == '.') ||
-					 (level_map[i][cur_box_x] == '*') || (level_map[i][cur_box_x] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if east tile is not a wall, then it is safe
-					if (level_map[i][cur_box_x + 1] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if NE corner
-					if ((level_map[i][cur_box_x] == '#') && (level_map[i][cur_box_x + 1] == '#'))
-					{
-						corner_N = true;
-						break;
-					}
-				}
-				
-				//search south to see if there are accessible tiles along unbroken
-				//east walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_y + 1; i < level_map.size(); i++)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[i][cur_box_x] == '.') ||
-					 (level_map[i][cur_box_x] == '*') || (level_map[i][cur_box_x] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if east tile is not a wall, then it is safe
-					if (level_map[i][cur_box_x + 1] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if SE corner
-					if ((level_map[i][cur_box_x] == '#') && (level_map[i][cur_box_x + 1] == '#'))
-					{
-						corner_S = true;
-						break;
-					}
-				}
-				
-				//if unbroken wall along path east and west of the box to corners with any goal
-				//increment score to signify unsafe position
-				if (!safe)
-				{
-					if(corner_N && corner_S)
-						score += 1000;
-				}	
-			}
-			
-			//if wall south of box, search for and east-most and west-most wall
-			if (S_wall)
-			{
-				bool safe = false;
-				bool corner_E = false;
-				bool corner_W = false;
-				
-				//search east to see if there are accessible tiles along unbroken
-				//south walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_x + 1; i < level_map[cur_box_y].size(); i++)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[cur_box_y][i] == '.') ||
-					 (level_map[cur_box_y][i] == '*') || (level_map[cur_box_y][i] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if south tile is not a wall, then it is safe
-					if (level_map[cur_box_y + 1][i] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if SE corner
-					if ((level_map[cur_box_y][i] == '#') && (level_map[cur_box_y + 1][i] == '#'))
-					{
-						corner_E = true;
-						break;
-					}
-				}
-				
-				//search west to see if there are accessible tiles along unbroken
-				//south walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_x - 1; i >= 0 ; i--)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[cur_box_y][i] == '.') ||
-					 (level_map[cur_box_y][i] == '*') || (level_map[cur_box_y][i] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if south tile is not a wall, then it is safe
-					if (level_map[cur_box_y + 1][i] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if SW corner
-					if ((level_map[cur_box_y][i] == '#') && (level_map[cur_box_y + 1][i] == '#'))
-					{
-						corner_W = true;
-						break;
-					}
-				}
-				
-				//if unbroken wall along path east and west of the box to corners with any goal
-				//increment score to signify unsafe position
-				if (!safe)
-				{
-					if(corner_E && corner_W)
-						score += 1000;
-				}	
-			}
-			
-			//if wall north of box, search for and north-most and south-most wall
-			if (W_wall)
-			{
-				bool safe = false;
-				bool corner_N = false;
-				bool corner_S = false;
-				
-				//search north to see if there are accessible tiles along unbroken
-				//east walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_y - 1; i >=0; i--)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[i][cur_box_x] == '.') ||
-					 (level_map[i][cur_box_x] == '*') || (level_map[i][cur_box_x] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if east tile is not a wall, then it is safe
-					if (level_map[i][cur_box_x - 1] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if NW corner
-					if ((level_map[i][cur_box_x] == '#') && (level_map[i][cur_box_x - 1] == '#'))
-					{
-						corner_N = true;
-						break;
-					}
-				}
-				
-				//search south to see if there are accessible tiles along unbroken
-				//east walls until a corner is found.  boxes and players are ignored
-				//and considered accessible tiles since they can move
-				for (int i = cur_box_y + 1; i < level_map.size(); i++)
-				{
-					//if goal is found along the way then it cannot be an unsafe position
-					if ((level_map[i][cur_box_x] == '.') ||
-					 (level_map[i][cur_box_x] == '*') || (level_map[i][cur_box_x] == '+'))
-					{
-						safe = true;
-						break;
-					}
-					
-					//if east tile is not a wall, then it is safe
-					if (level_map[i][cur_box_x - 1] != '#')
-					{
-						safe = true;
-						break;
-					}
-					
-					//if SW corner
-					if ((level_map[i][cur_box_x] == '#') && (level_map[i][cur_box_x - 1] == '#'))
-					{
-						corner_S = true;
-						break;
-					}
-				}
-				
-				//if unbroken wall along path east and west of the box to corners with any goal
-				//increment score to signify unsafe position
-				if (!safe)
-				{
-					if(corner_N && corner_S)
-						score += 1000;
-				}	
-			}
-		}
-	}
-	return score;
-} //int h2(const State &cur_state)
+	void *ptr = counted_alloc(size);
+	if (ptr == NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
 
+void *operator new[](std::size_t size) SKB_THROW_BAD_ALLOC
+{
+	void *ptr = counted_alloc(size);
+	if (ptr == NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
 
-/* Function is used to generate all valid states from current state
- * A valid level is assumed.  Meaning only 1 player agent, and 1 goal
- *  for each box, with at least 1 goal and 1 box.
- * Called in search algorithm functions.
- * 
- * smode cases:
- *  NONE - totalcost of moves are ignored in bfs/dfs
- *  UCS - totalcost of moves are calculated
- *  GBFSH1 - totalcost of moves ignored, heuristics function 1 used
- *  GBFSH2 - totalcost of moves ignored, heuristics function 2 used
- *  ASH1 - totalcost of moves calculated, heuristics function 1 used with totalcost
- *  ASH2 - totalcost of moves calculated, heuristics function 2 used with totalcost
- * 
- * Preconditions: State object representing current state in the agent,
- *  int representing what searching algorithm used
- * Postconditions: Returns a queue of state objects representing all possible 
- *  states from the current state
- */
-std::queue<State> gen_valid_states (const State &cur_state, const int smode = NONE)
+void *operator new(std::size_t size, const std::nothrow_t &) SKB_NOTHROW
 {
-	std::queue<State> valid_moves;
-	std::stringstream ss(cur_state.state_str);
-	std::vector< std::vector<char> > new_level_map;
-	State new_state;
-	std::string line;
-	bool found = false;
-	char player, box_move;
-	int x, y, counter = 0, MOVE_COST = 1, PUSH_COST = 1;
+	return counted_alloc(size);
+}
 
-	//if search algorithm is uniformed cost search, set push_cost to 2
-	if (smode == UCS)
-		PUSH_COST = 2;
+void *operator new[](std::size_t size, const std::nothrow_t &) SKB_NOTHROW
+{
+	return counted_alloc(size);
+}
 
-	//generate vector array since indexes used for movement
-	//are easier, eg moving down at pos [1,2] leads to [2,2]
-	//level_map stored as (y,x) cordinates due to reading line by line
-	std::vector< std::vector<char> > level_map;
-	while (getline(ss,line, '\n'))
-	{
-		std::vector<char> temp;
-		level_map.push_back(temp);
-		for (int i = 0; i <line.length() ; i++)
-		{
-			if (!found)
-			{
-				//assumes only 1 player exists in any given state
-				//if found user, set found to true, and x, y positions
-				if (line[i] == '@' | line[i] == '+' )
-				{
-					player = line[i];
-					x = i;
-					y = counter;
-					found = true;
-				}
-			}
-			level_map[counter].push_back(line[i]);
-		}
-		counter++;
-	}
-	if (!found)
-	{
-		std::cout<<"No player found on level"<<std::endl;
-		return valid_moves;
-	}
-	
-	//north tile pos= x, y-1
-	//generate north move
-	char north = level_map[y-1][x];
-	switch (north)
-	{
-		//move to empty spot
-		case ' ':
-			new_level_map = level_map;
-			//adjusting for player tile and tile north of player
-			new_level_map[y-1][x] = '@';
-			//if player = @, then was standing on empty floor
-			//otherwise player was standing on goal
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("u, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;	
-			valid_moves.push(new_state);
-			break;
-		//move to empty goal
-		case '.':
-			new_level_map = level_map;
-			//adjusting for player tile and tile north of player
-			new_level_map[y-1][x] = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("u, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on floor
-		case '$':
-			new_level_map = level_map;
-			//adjusting for player tile and tile north of player
-			new_level_map[y-1][x] = '@';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile north of box
-			box_move = new_level_map[y-2][x];
-			//if north of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if north of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y-2][x] = '$';
-			}
-			//if north of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y-2][x] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("u, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on goal
-		case '*':
-			new_level_map = level_map;
-			//adjusting for player tile and tile north of player
-			new_level_map[y-1][x] = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile north of box
-			box_move = new_level_map[y-2][x];
-			//if north of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if north of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y-2][x] = '$';
-			}
-			//if north of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y-2][x] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("u, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to wall
-		case '#':
-			break;
-		default:
-			break;
-	}
-	
-	//east tile pos= x, y-1
-	//generate east move
-	char east = level_map[y][x+1];
-	switch (east)
-	{
-		//move to empty spot
-		case ' ':
-			new_level_map = level_map;
-			//adjusting for player tile and tile east of player
-			new_level_map[y][x+1] = '@';
-			//if player = @, then was standing on empty floor
-			//otherwise player was standing on goal
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("r, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			//std::cout<<new_state.state_str<<std::endl;
-			valid_moves.push(new_state);
-			break;
-		//move to empty goal
-		case '.':
-			new_level_map = level_map;
-			//adjusting for player tile and tile east of player
-			new_level_map[y][x+1] = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("r, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on floor
-		case '$':
-			new_level_map = level_map;
-			//adjusting for player tile and tile east of player
-			new_level_map[y][x+1] = '@';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile east of box
-			box_move = new_level_map[y][x+2];
-			//if east of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if east of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y][x+2] = '$';
-			}
-			//if east of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y][x+2] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("r, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1|| smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on goal
-		case '*':
-			new_level_map = level_map;
-			//adjusting for player tile and tile east of player
-			new_level_map[y][x+1] = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile east of box
-			box_move = new_level_map[y][x+2];
-			//if east of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if east of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y][x+2] = '$';
-			}
-			//if east of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y][x+2] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("r, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to wall
-		case '#':
-			break;
-		default:
-			break;
-	}
-	
-	//south tile pos= x, y-1
-	//generate south move
-	char south = level_map[y+1][x];
-	switch (south)
-	{
-		//move to empty spot
-		case ' ':
-			new_level_map = level_map;
-			//adjusting for player tile and tile south of player
-			new_level_map[y+1][x] = '@';
-			//if player = @, then was standing on empty floor
-			//otherwise player was standing on goal
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("d, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to empty goal
-		case '.':
-			new_level_map = level_map;
-			//adjusting for player tile and tile south of player
-			new_level_map[y+1][x]= '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("d, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on floor
-		case '$':
-			new_level_map = level_map;
-			//adjusting for player tile and tile south of player
-			new_level_map[y+1][x] = '@';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile south of box
-			box_move = new_level_map[y+2][x];
-			//if south of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if south of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y+2][x]= '$';
-			}
-			//if south of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y+2][x] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("d, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on goal
-		case '*':
-			new_level_map = level_map;
-			//adjusting for player tile and tile south of player
-			new_level_map[y+1][x] = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile south of box
-			box_move = new_level_map[y+2][x];
-			//if south of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if south of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y+2][x] = '$';
-			}
-			//if south of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y+2][x] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("d, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to wall
-		case '#':
-			break;
-		default:
-			break;
-	}
+void operator delete(void *ptr) SKB_NOTHROW
+{
+	counted_free(ptr);
+}
 
-	//west tile pos= x, y-1
-	//generate west move
-	char west = level_map[y][x-1];
-	switch (west)
-	{
-		//move to empty spot
-		case ' ':
-			new_level_map = level_map;
-			//adjusting for player tile and tile west of player
-			new_level_map[y][x-1] = '@';
-			//if player = @, then was standing on empty floor
-			//otherwise player was standing on goal
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("l, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to empty goal
-		case '.':
-			new_level_map = level_map;
-			//adjusting for player tile and tile west of player
-			new_level_map[y][x-1]  = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("l, ");
-			new_state.depth++;
-			new_state.moves++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += MOVE_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on floor
-		case '$':
-			new_level_map = level_map;
-			//adjusting for player tile and tile west of player
-			new_level_map[y][x-1]  = '@';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile west of box
-			box_move = new_level_map[y][x-2];
-			//if west of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if west of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y][x-2] = '$';
-			}
-			//if west of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y][x-2] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("l, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to box on goal
-		case '*':
-			new_level_map = level_map;
-			//adjusting for player tile and tile west of player
-			new_level_map[y][x-1]  = '+';
-			(player == '@') ? new_level_map[y][x] = ' ' : new_level_map[y][x] = '.';
-			
-			//adjusting for box tile and tile west of box
-			box_move = new_level_map[y][x-2];
-			//if west of box is a wall or another box
-			if (box_move == '#')
-				break;
-			else if (box_move == '$')
-				break;
-			else if (box_move == '*')
-				break;
-			//if west of box is an empty floor
-			else if (box_move == ' ')
-			{
-				new_level_map[y][x-2] = '$';
-			}
-			//if west of box is an empty goal
-			else if (box_move == '.')
-			{
-				new_level_map[y][x-2] = '*';
-			}
-			else
-				break;
-			
-			//create and update new state
-			new_state = cur_state;
-			new_state.state_str = "";
-			//turning vector<vector<char>> back to string
-			for (int i = 0; i < new_level_map.size(); i++)
-			{
-				std::vector<char> temp = new_level_map[i];
-				std::vector<char>::iterator itr;
-				for (itr = temp.begin(); itr != temp.end(); itr++)
-					new_state.state_str.push_back( *itr);
-				new_state.state_str.append("\n");
-			}
-			
-			//update state stats
-			new_state.move_list.append("l, ");
-			new_state.depth++;
-			new_state.pushes++;
-			if (smode == UCS || smode == ASH1 || smode == ASH2)
-				new_state.total_cost += PUSH_COST;
-			if (smode == GBFSH1 || smode == ASH1)
-				new_state.hscore = h1(new_state);
-			if (smode == GBFSH2 || smode == ASH2)
-				new_state.hscore = h2(new_state);
-			if (smode == ASH1 || smode == ASH2)
-				new_state.hscore += new_state.total_cost;
-			valid_moves.push(new_state);
-			break;
-		//move to wall
-		case '#':
-			break;
-		default:
-			break;
-	}
+void operator delete[](void *ptr) SKB_NOTHROW
+{
+	counted_free(ptr);
+}
 
-	return valid_moves;
-} //std::queue<State> gen_valid_states (const State &cur_state, const int smode = NONE)
+void operator delete(void *ptr, const std::nothrow_t &) SKB_NOTHROW
+{
+	counted_free(ptr);
+}
 
-/* Function executes depth first search algorithm on an inital state.
- *  Due to sokoban puzzles having infinite depth, an explored list is
- *  used to prevent infinite loops. 
- * 
- * Preconditions: Takes in a State object for initial state of level
- * Postconditions: Returns a SearchStat object for search results stats
- */
-SearchStat bfs(State &initial_state)
+void operator delete[](void *ptr, const std::nothrow_t &) SKB_NOTHROW
 {
-	std::deque<State> open;
-	std::vector<State> closed;
-	SearchStat report;
-	report.rep_node_count = 0;
-	report.fringe_node = 0;
-	report.explored_count = 1;//will be replaced, just to stop cout spam
-	report.node_count = 1;
-	report.node.state_str = "NULL";
-	State current_state;
-	
-	//push first state into queue
-	open.push_back(initial_state);
-	while (!open.empty())
-	{
-		//take N from OPEN
-		current_state = open.front();
-		open.pop_front();
-		//push N onto CLOSED
-		closed.push_back(current_state);
-		
-		//print out in case a long time is taken and wondering if it froze
-		if ((closed.size() % 5000) == 0)
-			std::cout << "...explored "<< closed.size() <<" nodes..."<<std::endl;
-			
-		//if found, set report node to current node, set explored count to closed list size
-		if (is_goal(current_state))
-		{
-			report.node = current_state;
-			report.explored_count = closed.size();
-			open.pop_front();
-			break;
-		}
-		
-		//generate valid states
-		std::queue<State> valid_states = gen_valid_states(current_state);
-		std::deque<State>::iterator it;
-		std::vector<State>::iterator itr;
-		
-		//while queue is not empty of states
-		while (!valid_states.empty())
-		{
-			bool already_seen = false;
-			State temp_state = valid_states.front();
-			//check if state has already been seen on open list
-			for (it = open.begin(); it != open.end(); it++)
-			{
-				if (it->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//check if state has already been seen on closed list
-			for (itr = closed.begin(); itr != closed.end(); itr++)
-			{
-				if (itr->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//if not duplicate, then add state to open queue
-			if (!already_seen)
-			{
-				report.node_count++;
-				//add to back of open
-				open.push_back(temp_state);
-			}
-			else
-				report.rep_node_count++;
-			valid_states.pop();
-		}
-	}
-	report.fringe_node = open.size();
-	return report;
-} //SearchStat bfs(State &initial_state)
+	counted_free(ptr);
+}
 
-/* Function executes depth first search algorithm on an inital state.
- *  Due to sokoban puzzles having infinite depth, an explored list is
- *  used to prevent infinite loops.
- * 
- * Preconditions: Takes in a State object for initial state of level
- * Postconditions: Returns a SearchStat object for search results stats
- */
-SearchStat dfs(State &initial_state)
+//sized versions, called instead of the ones above when the size is known
+void operator delete(void *ptr, std::size_t) SKB_NOTHROW
 {
-	std::deque<State> open;
-	std::vector<State> closed;
-	SearchStat report;
-	report.rep_node_count = 0;
-	report.fringe_node = 0;
-	report.explored_count = 1;//will be replaced, just to stop cout spam
-	report.node_count = 1;
-	report.node.state_str = "NULL";
-	State current_state;
-	
-	//push first state into queue
-	open.push_back(initial_state);
-	while (!open.empty())
-	{
-		//take N from OPEN
-		current_state = open.front();
-		open.pop_front();
-		//push N onto CLOSED
-		closed.push_back(current_state);
-		
-		//print out in case a long time is taken and wondering if it froze
-		if ((closed.size() % 5000) == 0)
-			std::cout << "...explored "<< closed.size() <<" nodes..."<<std::endl;
-			
-		//if found, set report node to current node, set explored count to closed list size
-		if (is_goal(current_state))
-		{
-			report.node = current_state;
-			report.explored_count = closed.size();
-			open.pop_front();
-			break;
-		}
-		
-		//generate valid states
-		std::queue<State> valid_states = gen_valid_states(current_state);
-		std::deque<State>::iterator it;
-		std::vector<State>::iterator itr;
-		std::deque<State> temp_open;
-		
-		//while queue is not empty of states
-		while (!valid_states.empty())
-		{
-			bool already_seen = false;
-			State temp_state = valid_states.front();
-			//check if state has already been seen on open list
-			for (it = open.begin(); it != open.end(); it++)
-			{
-				if (it->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//check if state has already been seen on closed list
-			for (itr = closed.begin(); itr != closed.end(); itr++)
-			{
-				if (itr->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//if not duplicate, then add state to open queue
-			if (!already_seen)
-			{
-				report.node_count++;
-				//uses a temporary queue to reverse the node order
-				temp_open.push_front(temp_state);
-			}
-			else
-				report.rep_node_count++;
-			valid_states.pop();
-		}
-		//reverses the reversed queue to keep left to right searches in the dfs
-		while (!temp_open.empty())
-		{
-			State temp_state = temp_open.front();
-			open.push_front(temp_state);
-			temp_open.pop_front();
-		}
-	}
-	report.fringe_node = open.size();
-	return report;
-} //SearchStat dfs(State &initial_state)
+	operator delete(ptr);
+}
 
-/* Function executes uniform cost search algorithm on an inital state.
- *  Due to sokoban puzzles having infinite depth, an explored list is
- *  used to prevent infinite loops.
- * 
- * Preconditions: Takes in a State object for initial state of level
- * Postconditions: Returns a SearchStat object for search results stats
- */
-SearchStat ucs(State &initial_state)
+void operator delete[](void *ptr, std::size_t) SKB_NOTHROW
 {
-	std::deque<State> open;
-	std::vector<State> closed;
-	SearchStat report;
-	report.rep_node_count = 0;
-	report.fringe_node = 0;
-	report.explored_count = 1;//will be replaced, just to stop cout spam
-	report.node_count = 1;
-	report.node.state_str = "NULL";
-	State current_state;
-	
-	//push first state into queue
-	open.push_back(initial_state);
-	while (!open.empty())
-	{
-		//take N from OPEN
-		current_state = open.front();
-		open.pop_front();
-		//push N onto CLOSED
-		closed.push_back(current_state);
-		
-		//print out in case a long time is taken and wondering if it froze
-		if ((closed.size() % 5000) == 0)
-			std::cout << "...explored "<< closed.size() <<" nodes..."<<std::endl;
-			
-		//if found, set report node to current node, set explored count to closed list size
-		if (is_goal(current_state))
-		{
-			report.node = current_state;
-			report.explored_count = closed.size();
-			open.pop_front();
-			break;
-		}
-		
-		//generate valid states
-		std::queue<State> valid_states = gen_valid_states(current_state, UCS);
-		std::deque<State>::iterator it;
-		std::vector<State>::iterator itr;
-		
-		//while queue is not empty of states
-		while (!valid_states.empty())
-		{
-			bool already_seen = false;
-			bool inserted = false;
-			State temp_state = valid_states.front();
-			//check if state has already been seen on open list
-			for (it = open.begin(); it != open.end(); it++)
-			{
-				if (it->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//check if state has already been seen on closed list
-			for (itr = closed.begin(); itr != closed.end(); itr++)
-			{
-				if (itr->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//if not duplicate, then add state to open queue
-			if (!already_seen)
-			{
-				report.node_count++;
-				//add to beginning of node with greater total cost
-				//used to maintain generated node order
-				for (it = open.begin(); it != open.end(); it++)
-				{
-					//priority of lowest total cost first
-					if (it->total_cost > temp_state.total_cost)
-					{
-						open.insert(it, temp_state);
-						inserted = true;
-						break;
-					}
-				}
-				//if no node has greater priority, push back
-				if (!inserted)
-					open.push_back(temp_state);
-			}
-			else
-				report.rep_node_count++;
-			valid_states.pop();
-		}
-	}
-	report.fringe_node = open.size();
-	return report;
-} //SearchStat ucs(State &initial_state)
+	operator delete[](ptr);
+}
 
-/* Function executes greedy best first search algorithm on an inital
- *  state with a given heuristics function.
- *  Due to sokoban puzzles having infinite depth, an explored list is
- *  used to prevent infinite loops.  
+/* Function used to print out a level state if that state is stored in a
+ *  vector of vector<char>.  It iterattes through the vector, printing
+ *  out each char of each vector.
  * 
- * Preconditions: Takes in a State object for initial state of level, and
- *  and integer representing which heuristics function to use
- * Postconditions: Returns a SearchStat object for search results stats
+ * Preconditions: vector<vector<char>> object
+ * Postcoditions: prints out each element in the vector of vectors, with
+ *  new line seperated each vector
  */
-SearchStat gbfs(State &initial_state, int hfchoice)
+void print_level(std::vector< std::vector<char> > &map)
 {
-	std::deque<State> open;
-	std::vector<State> closed;
-	SearchStat report;
-	report.rep_node_count = 0;
-	report.fringe_node = 0;
-	report.explored_count = 1;//will be replaced, just to stop cout spam
-	report.node_count = 1;
-	report.node.state_str = "NULL";
-	State current_state;
-	
-	//push first state into queue
-	open.push_back(initial_state);
-	while (!open.empty())
+	for (int i = 0; i < map.size(); i++)
 	{
-		//take N from OPEN
-		current_state = open.front();
-		open.pop_front();
-		//push N onto CLOSED
-		closed.push_back(current_state);
-		
-		//print out in case a long time is taken and wondering if it froze
-		if ((closed.size() % 5000) == 0)
-			std::cout << "...explored "<< closed.size() <<" nodes..."<<std::endl;
-			
-		//if found, set report node to current node, set explored count to closed list size
-		if (is_goal(current_state))
-		{
-			report.node = current_state;
-			report.explored_count = closed.size();
-			open.pop_front();
-			break;
-		}
-		
-		//generate valid states
-		std::queue<State> valid_states;
-		valid_states = gen_valid_states(current_state, hfchoice);
-		std::deque<State>::iterator it;
-		std::vector<State>::iterator itr;
-		
-		//while queue is not empty of states
-		while (!valid_states.empty())
-		{
-			bool already_seen = false;
-			bool inserted = false;
-			State temp_state = valid_states.front();
-			//check if state has already been seen on open list
-			for (it = open.begin(); it != open.end(); it++)
-			{
-				if (it->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//check if state has already been seen on closed list
-			for (itr = closed.begin(); itr != closed.end(); itr++)
-			{
-				if (itr->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//if not duplicate, then add state to open queue
-			if (!already_seen)
-			{
-				report.node_count++;
-				//add to beginning of node with greater total cost
-				//used to maintain generated node order
-				for (it = open.begin(); it != open.end(); it++)
-				{
-					//priority of lowest hscore first
-					if (it->hscore > temp_state.hscore)
-					{
-						open.insert(it, temp_state);
-						inserted = true;
-						break;
-					}
-				}
-				//if no node has greater priority, push back
-				if (!inserted)
-					open.push_back(temp_state);
-			}
-			else
-				report.rep_node_count++;
-			valid_states.pop();
-		}
+		std::vector<char> vec = map[i];
+		std::vector<char>::iterator itr;
+		for (itr = vec.begin(); itr != vec.end(); itr++)
+			std::cout << *itr;
+		std::cout << std::endl;
 	}
-	report.fringe_node = open.size();
-	return report;
-} //SearchStat gbfs(State &initial_state, int hfchoice)
+} //void print_level(std::vector< std::vector<char> > &map)
 
-/* Function executes A* search search algorithm on an inital state with
- *  a given heuristics function.
- *  Due to sokoban puzzles having infinite depth, an explored list is
- *  used to prevent infinite loops.  
+/* Function used to print the solution shortened by the optimizer, if
+ *  it ran, after a search or a solution cache hit.
  * 
- * Preconditions: Takes in a State object for initial state of level, and
- *  and integer representing which heuristics function to use
- * Postconditions: Returns a SearchStat object for search results stats
+ * Preconditions: SolveResult of the solve
+ * Postconditions: optimized solution and optimizer stats printed
  */
-SearchStat as(State &initial_state, int hfchoice)
+void print_optimized(const SolveResult &result)
 {
-	std::deque<State> open;
-	std::vector<State> closed;
-	SearchStat report;
-	report.rep_node_count = 0;
-	report.fringe_node = 0;
-	report.explored_count = 1;//will be replaced, just to stop cout spam
-	report.node_count = 1;
-	report.node.state_str = "NULL";
-	State current_state;
-	
-	//push first state into queue
-	open.push_back(initial_state);
-	while (!open.empty())
+	if (result.optimized)
 	{
-		//take N from OPEN
-		current_state = open.front();
-		open.pop_front();
-		//push N onto CLOSED
-		closed.push_back(current_state);
-		
-		//print out in case a long time is taken and wondering if it froze
-		if ((closed.size() % 5000) == 0)
-			std::cout << "...explored "<< closed.size() <<" nodes..."<<std::endl;
-			
-		//if found, set report node to current node, set explored count to closed list size
-		if (is_goal(current_state))
-		{
-			report.node = current_state;
-			report.explored_count = closed.size();
-			open.pop_front();
-			break;
-		}
-				
-		//generate valid states
-		std::queue<State> valid_states;
-		valid_states = gen_valid_states(current_state, hfchoice);
-		std::deque<State>::iterator it;
-		std::vector<State>::iterator itr;
-		
-		//while queue is not empty of states
-		while (!valid_states.empty())
-		{
-			bool already_seen = false;
-			bool inserted = false;
-			State temp_state = valid_states.front();
-			//check if state has already been seen on open list
-			for (it = open.begin(); it != open.end(); it++)
-			{
-				if (it->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//check if state has already been seen on closed list
-			for (itr = closed.begin(); itr != closed.end(); itr++)
-			{
-				if (itr->state_str == temp_state.state_str)
-				{
-					already_seen = true;
-					break;
-				}
-			}
-			//if not duplicate, then add state to open queue
-			if (!already_seen)
-			{
-				report.node_count++;
-				//add to beginning of node with greater total cost
-				//used to maintain generated node order
-				for (it = open.begin(); it != open.end(); it++)
-				{
-					//priority of lowest hscore first
-					if (it->hscore > temp_state.hscore)
-					{
-						open.insert(it, temp_state);
-						inserted = true;
-						break;
-					}
-				}
-				//if no node has greater priority, push back
-				if (!inserted)
-					open.push_back(temp_state);
-			}
-			else
-				report.rep_node_count++;
-			valid_states.pop();
-		}
+		const State &opt_state = result.optimized_node;
+		const OptimizeStat &opt_stat = result.optimize;
+		std::cout << "  Optimized solution: " << std::endl;
+		std::cout << "    "
+			<< opt_state.move_list.substr(0,(opt_state.move_list.size()-2))
+			<< std::endl;
+		std::cout << "    # of moves (pushes included): " << result.stat.node.moves +
+			result.stat.node.pushes << " -> " << opt_state.moves + opt_state.pushes
+			<< ", # of pushes: " << result.stat.node.pushes << " -> "
+			<< opt_state.pushes << std::endl;
+		std::cout << "    # of walks shortened: " << opt_stat.walks_shortened << std::endl;
+		std::cout << "    # of windows searched: " << opt_stat.windows_searched
+			<< ", shortened: " << opt_stat.windows_shortened << std::endl;
+		std::cout << "    # of optimizer nodes: " << opt_stat.node_count
+			<< (opt_stat.timed_out ? " (time budget spent)" : "") << std::endl;
+		std::cout << "  Optimizer run time: ";
+		std::cout << result.optimize_time << " seconds" << std::endl;
 	}
-	report.fringe_node = open.size();
-	return report;
-} //SearchStat as(State &initial_state, int hfchoice)
+} //void print_optimized(const SolveResult &result)
 
-/* Function used to execute a search algorithm on a given initial state.
- *  Reports back search results.
+/* Function used to execute a search algorithm on the loaded level.
+ *  Reports back search results.  If the solver has a solution cache, it
+ *  is checked before searching.
  * 
- * Preconditions: Takes in a state object and an int representing search algo
+ * Preconditions: Takes in the Solver with the level loaded, and an int
+ *  representing search algo
  * Postconditions:  Executes search algo and prints search stats.
  */
-void choose_search(State &init_state, int search_choice)
+void choose_search(Solver &solver, int search_choice)
 {
-	timeval start, end;
-	long sec, microsec;
-	int level_size;
-	SearchStat final_stat;
-	std::string user_choice;
+	SolveResult result;
+	HeapStat heap_start;
+	rusage usage;
 	
-	switch (search_choice)
+	solver.options().search = search_choice;
+	//a validated cached solution replaces the search
+	if (solver.lookup(result))
 	{
-		case BFS:
-			std::cout << "BREADTH FIRST SEARCH:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = bfs(init_state);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case DFS:
-			std::cout << "DEPTH FIRST SEARCH:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = dfs(init_state);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case UCS:
-			std::cout << "UNIFORM COST SEARCH:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = ucs(init_state);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case GBFSH1:
-			std::cout << "GREEDY BEST FIRST SEARCH, HEURISTICS FUNCTION 1:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = gbfs(init_state, GBFSH1);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case GBFSH2:
-			std::cout << "GREEDY BEST FIRST SEARCH, HEURISTICS FUNCTION 2:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = gbfs(init_state, GBFSH2);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case ASH1:
-			std::cout << "A* SEARCH, HEURISTICS FUNCTION 1:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = as(init_state, ASH1);
-			gettimeofday(&end, NULL);
-			break;
-			
-		case ASH2:
-			std::cout << "A* SEARCH, HEURISTICS FUNCTION 2:" << std::endl;
-			gettimeofday(&start, NULL);
-			final_stat = as(init_state, ASH2);
-			gettimeofday(&end, NULL);
-			break;
-			
-		default:
-			std::cout << "Unrecognized choice" << std::endl;
+		const State &end_state = result.stat.node;
+		std::cout << "SOLUTION CACHE HIT:" << std::endl;
+		std::cout << "  Solution: " << std::endl;
+		std::cout << "    "
+			<< end_state.move_list.substr(0,(end_state.move_list.size()-2))
+			<< std::endl;
+		std::cout << "    # of moves: " << end_state.moves
+			<< ", # of pushes: " << end_state.pushes << std::endl;
+		std::cout << "    # of nodes generated when solved: ";
+		std::cout << result.stat.node_count << std::endl;
+		std::cout << "    # of explored nodes when solved: ";
+		std::cout << result.stat.explored_count << std::endl;
+		std::cout << "  Optimality: " << result.optimality << std::endl;
+		std::cout << "  Cache lookup time: ";
+		std::cout << (long)(result.run_time * 1000000 + 0.5) << " microseconds" << std::endl;
+		print_optimized(result);
+		return;
 	}
+	
+	//heap counters measured from here, peak restarted at current use
+	heap_start = heap_stat;
+	heap_stat.peak_bytes = heap_stat.bytes_in_use;
+	result = solver.search();
+	if (!result.error.empty())
+		std::cout << "  " << result.error << std::endl;
 
+	const SearchStat &final_stat = result.stat;
 	//substring used to remove ending ', ' in string
 	std::cout << "  Solution: " << std::endl;
 	std::cout << "    "
@@ -2018,13 +317,64 @@ void choose_search(State &init_state, int search_choice)
 	std::cout << final_stat.fringe_node<<std::endl;
 	std::cout << "    # of explored nodes: ";
 	std::cout << final_stat.explored_count<<std::endl;
+	//threads pop near the best node queued, not always the best one
+	if (final_stat.rank_samples > 0)
+		std::cout << "    rank error: " << final_stat.rank_error << " mean, "
+			<< final_stat.rank_error_max << " max (" << final_stat.rank_samples
+			<< " samples)" << std::endl;
+	//a search stopped by a limit reports the best state it reached
+	if (result.status == STATUS_EXHAUSTED)
+	{
+		const char *limits[] = {"no", "time", "node", "memory", "cancel", "width"};
+		std::cout << "  Search exhausted, " << limits[final_stat.limit]
+			<< " limit reached." << std::endl;
+		std::cout << "  Best state reached, " << final_stat.best_goals
+			<< " boxes on goals: " << std::endl;
+		std::cout << "    "
+			<< final_stat.best.move_list.substr(0,(final_stat.best.move_list.size()-2))
+			<< std::endl;
+		std::cout << final_stat.best.state_str;
+	}
+	//patterns proven dead stay in the table for the next search
+	if (solver.options().deadlocks)
+		std::cout << "  Deadlocks: " << final_stat.deadlocks_learned << " patterns learned, "
+			<< final_stat.deadlocks_pruned << " states pruned, "
+			<< solver.options().deadlocks->size() << " patterns in table" << std::endl;
+	std::cout << "  Optimality: " << result.optimality << std::endl;
 	//report search algorithm runtime
 	std::cout << "  Actual run time: ";
-	sec = end.tv_sec - start.tv_sec;
-	microsec = end.tv_usec - start.tv_usec;
-	std::cout << (sec + (microsec/1000000.0))<< " seconds" << std::endl;
+	std::cout << result.run_time << " seconds" << std::endl;
+	//report memory used by the search
+	getrusage(RUSAGE_SELF, &usage);
+	std::cout << "  Memory: " << std::endl;
+	//beam search memory is set by its width
+	if (final_stat.beam_width > 0)
+		std::cout << "    beam width: " << final_stat.beam_width << std::endl;
+	std::cout << "    # of nodes in arena: " << final_stat.arena_nodes
+		<< " (" << final_stat.arena_bytes << " bytes)" << std::endl;
+	//a visited set replaces scanning the open and closed lists
+	if (final_stat.visited_states > 0)
+		std::cout << "    # of states in visited set: " << final_stat.visited_states
+			<< " (" << final_stat.visited_bytes << " bytes, "
+			<< (double)final_stat.visited_bytes / final_stat.visited_states
+			<< " bytes per state)" << std::endl;
+	//frontier search frees its closed nodes, the arena only holds relays
+	if (final_stat.frontier_nodes > 0)
+		std::cout << "    peak frontier: " << final_stat.frontier_nodes << " nodes ("
+			<< final_stat.frontier_bytes << " bytes)" << std::endl;
+	//the state table is kept for the next state of the level
+	if (final_stat.table_states > 0)
+		std::cout << "    # of states in state table: " << final_stat.table_states
+			<< " (" << final_stat.table_bytes << " bytes)" << std::endl;
+	std::cout << "    # of heap allocations: "
+		<< (heap_stat.allocs - heap_start.allocs) << std::endl;
+	std::cout << "    peak heap use: "
+		<< (heap_stat.peak_bytes - heap_start.bytes_in_use) << " bytes" << std::endl;
+	std::cout << "    peak resident memory: " << usage.ru_maxrss << " kB" << std::endl;
 	
-} //bool choose_search(State &init_state, int search_choice)
+	//solution shortened within the optimizer time budget
+	print_optimized(result);
+} //void choose_search(Solver &solver, int search_choice)
 
 int main(int argc, char** argv)
 {	
@@ -2034,24 +384,169 @@ int main(int argc, char** argv)
 	std::ifstream fs;
 	std::string line;
 	std::string input_level = "";
+	const char *level_file = NULL;
+	const char *cache_file = NULL;
+	bool bench = false;
+	bool daemon = false;
+	bool learn_deadlocks = false;
+	DaemonOptions daemon_options;
+	bool generate = false;
+	int scale_boxes = 0;
+	GeneratorOptions gen_options;
+	ScaleOptions scale_options;
+	Solver solver;
+	SolverOptions &options = solver.options();
+	std::string error;
+
+	//reads options, the last argument is the level txt file
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "-c" && i + 1 < argc)
+			cache_file = argv[++i];
+		else if (arg == "-m")
+			options.macro_moves = true;
+		else if (arg == "-bench")
+			bench = true;
+		else if (arg == "-daemon")
+			daemon = true;
+		else if (arg == "-socket" && i + 1 < argc)
+			daemon_options.socket_path = argv[++i];
+		else if (arg == "-workers" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			daemon_options.workers = atoi(argv[++i]);
+		else if (arg == "-cost" && i + 1 < argc && parse_cost_model(argv[i + 1], options.costs))
+			i++;
+		else if (arg == "-o" && i + 1 < argc && atof(argv[i + 1]) > 0)
+			options.optimize_budget = atof(argv[++i]);
+		else if (arg == "-t" && i + 1 < argc && atof(argv[i + 1]) > 0)
+			options.time_limit = atof(argv[++i]);
+		else if (arg == "-n" && i + 1 < argc && atol(argv[i + 1]) > 0)
+			options.node_limit = atol(argv[++i]);
+		else if (arg == "-mem" && i + 1 < argc && atol(argv[i + 1]) > 0)
+			options.memory_limit = atol(argv[++i]) << 20;
+		else if (arg == "-w" && i + 1 < argc && atof(argv[i + 1]) >= 1)
+			options.ara_weight = atof(argv[++i]);
+		else if (arg == "-beam" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			options.beam_width = atoi(argv[++i]);
+		else if (arg == "-retry")
+			options.beam_retry = true;
+		else if (arg == "-dl")
+			learn_deadlocks = true;
+		else if (arg == "-pdb" && i + 1 < argc && atoi(argv[i + 1]) >= 1 && atoi(argv[i + 1]) <= 3)
+			options.pattern_boxes = atoi(argv[++i]);
+		else if (arg == "-pdbdir" && i + 1 < argc)
+			options.pattern_dir = argv[++i];
+		else if (arg == "-procs" && i + 1 < argc && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= 64)
+			options.processes = atoi(argv[++i]);
+		else if (arg == "-visited" && i + 1 < argc && parse_visited_mode(argv[i + 1], options.visited))
+			i++;
+		else if (arg == "-fp" && i + 1 < argc && atof(argv[i + 1]) > 0 && atof(argv[i + 1]) < 1)
+			options.filter_rate = atof(argv[++i]);
+		else if (arg == "-dense" && i + 1 < argc && atol(argv[i + 1]) >= 0)
+			options.dense_limit = atol(argv[++i]) << 20;
+		else if (arg == "-frontier" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			options.frontier_layers = atoi(argv[++i]);
+		else if (arg == "-threads" && i + 1 < argc && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= 256)
+			options.threads = atoi(argv[++i]);
+		else if (arg == "-mq" && i + 1 < argc && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= 64)
+			options.queue_factor = atoi(argv[++i]);
+		else if (arg == "-gen")
+			generate = true;
+		else if (arg == "-scale" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			scale_boxes = atoi(argv[++i]);
+		else if (arg == "-size" && i + 1 < argc &&
+		 sscanf(argv[i + 1], "%dx%d", &gen_options.width, &gen_options.height) == 2)
+			i++;
+		else if (arg == "-boxes" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			gen_options.boxes = atoi(argv[++i]);
+		else if (arg == "-difficulty" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			gen_options.difficulty = atoi(argv[++i]);
+		else if (arg == "-seed" && i + 1 < argc)
+			gen_options.seed = strtoul(argv[++i], NULL, 10);
+		else if (arg == "-levels" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			scale_options.levels = atoi(argv[++i]);
+		else if (level_file == NULL && arg[0] != '-')
+			level_file = argv[i];
+		else
+		{
+			level_file = NULL;
+			break;
+		}
+	}
+
+	//levels come in as requests instead of a level file
+	if (daemon)
+	{
+		daemon_options.cache_path = cache_file;
+		daemon_options.deadlocks = learn_deadlocks;
+		daemon_options.pattern_boxes = options.pattern_boxes;
+		daemon_options.pattern_dir = options.pattern_dir;
+		return run_daemon(daemon_options);
+	}
+
+	//a generated level is written as a level file
+	if (generate)
+	{
+		std::string level = generate_level(gen_options, error);
+		if (level.empty())
+		{
+			std::cerr << "  " << error << std::endl;
+			return 1;
+		}
+		int lines = 0;
+		for (std::string::size_type i = 0; i < level.size(); i++)
+			lines += level[i] == '\n';
+		std::cout << lines << std::endl << level;
+		return 0;
+	}
+
+	//levels are generated for the benchmark, no level file is read
+	if (scale_boxes > 0)
+	{
+		scale_options.level = gen_options;
+		scale_options.level.boxes = scale_boxes;
+		scale_options.time_limit = options.time_limit;
+		scale_options.node_limit = options.node_limit;
+		scale_options.memory_limit = options.memory_limit;
+		return run_scale_bench(scale_options, std::cout);
+	}
 
 	//checks if argument exists, can't input level if no txt file
-	if (argc != 2)
+	if (level_file == NULL)
 	{
-		std::cerr << "  usage: " << argv[0] << "<sokoban_level>.txt"
-			<< std::endl;
+		std::cerr << "  usage: " << argv[0] << " [-c <cache_file>] [-m]"
+			<< " [-cost moves|pushes|<move>,<push>] [-o <seconds>]"
+			<< " [-t <seconds>] [-n <nodes>] [-mem <megabytes>] [-w <weight>]"
+			<< " [-beam <width>] [-retry] [-dl] [-pdb 1-3] [-pdbdir <dir>] [-procs <count>]"
+			<< " [-visited scan|exact|filter] [-fp <rate>] [-dense <megabytes>] [-frontier <layers>]"
+			<< " [-threads <count>] [-mq <queues>] [-bench] <sokoban_level>.txt" << std::endl;
+		std::cerr << "         " << argv[0] << " -daemon [-socket <path>] [-workers <count>]"
+			<< " [-c <cache_file>] [-dl] [-pdb 1-3] [-pdbdir <dir>]" << std::endl;
+		std::cerr << "         " << argv[0] << " -gen [-size <width>x<height>] [-boxes <count>]"
+			<< " [-difficulty 1-5] [-seed <seed>]" << std::endl;
+		std::cerr << "         " << argv[0] << " -scale <max_boxes> [-levels <count>]"
+			<< " [-size <width>x<height>] [-difficulty 1-5] [-seed <seed>]"
+			<< " [-t <seconds>] [-n <nodes>] [-mem <megabytes>]" << std::endl;
 		return 0;
 	}
 	
 	//opens sokoban level txt file and store as string
-	fs.open (argv[1]);
+	fs.open (level_file);
 	if (!fs)
 	{
-		std::cerr << "  error opening file " << argv[1]
+		std::cerr << "  error opening file " << level_file
 			<< std::endl;
 		return 0;
 	}
 	
+	//opens the solution cache shared with other solver processes
+	if (cache_file != NULL && !solver.open_cache(cache_file, error))
+	{
+		std::cerr << "  " << error << std::endl;
+		std::cerr << "  error opening solution cache " << cache_file
+			<< ", solving without cache" << std::endl;
+	}
+	
 	//get size of array from first line of input level
 	std::getline(fs, line, '\n');
 	level_size = atoi(line.c_str());
@@ -2063,16 +558,27 @@ int main(int argc, char** argv)
 	}
 	fs.close();
 	
-	State init_state;
-	init_state.state_str = input_level;
-	init_state.move_list = "";
-	init_state.moves = init_state.pushes =
-	init_state.total_cost = init_state.depth =
-	init_state.hscore = 0;
-	
 	std::cout << "Sokoban level input:" << std::endl;
 	std::cout << level_size << std::endl;
-	std::cout << init_state.state_str;
+	std::cout << input_level;
+	if (!solver.load_level(input_level))
+	{
+		std::cerr << "  level in " << level_file << " has no player" << std::endl;
+		return 0;
+	}
+	//what the solver does is printed as it runs
+	options.log = &std::cout;
+	//learned deadlocks are kept from one search of the level to the next
+	DeadlockTable deadlocks(learn_deadlocks ? 20 : 0);
+	if (learn_deadlocks)
+		options.deadlocks = &deadlocks;
+	
+	//benchmark runs instead of the search menu
+	if (bench)
+	{
+		solver.bench_reachability(std::cout);
+		return 0;
+	}
 	
 	//while loop used to repeat search algorithms
 	while (repeat)
@@ -2088,25 +594,28 @@ int main(int argc, char** argv)
 				<< "  2) Depth first search\n"
 				<< "  3) Uniform cost search\n"
 				<< "  4) Greedy best first search\n"
-				<< "  5) A* search"
+				<< "  5) A* search\n"
+				<< "  6) Anytime repairing A* search\n"
+				<< "  7) Beam search\n"
+				<< "  8) Retrograde state table"
 			<< std::endl;
 			
 			std::cin >> usr_input;
 			if (usr_input == "1")
 			{
-				choose_search(init_state, BFS);
+				choose_search(solver, BFS);
 				valid_input = true;
 				loop = false;
 			}
 			else if (usr_input == "2")
 			{
-				choose_search(init_state, DFS);
+				choose_search(solver, DFS);
 				valid_input = true;
 				loop = false;
 			}
 			else if (usr_input == "3")
 			{
-				choose_search(init_state, UCS);
+				choose_search(solver, UCS);
 				valid_input = true;
 				loop = false;
 			}
@@ -2116,13 +625,13 @@ int main(int argc, char** argv)
 				std::cin >> usr_input;
 				if (usr_input == "1")
 				{
-					choose_search(init_state, GBFSH1);
+					choose_search(solver, GBFSH1);
 					valid_input = true;
 					loop = false;
 				}
 				else if (usr_input == "2")
 				{
-					choose_search(init_state, GBFSH2);
+					choose_search(solver, GBFSH2);
 					valid_input = true;
 					loop = false;
 				}
@@ -2138,13 +647,36 @@ int main(int argc, char** argv)
 				std::cin >> usr_input;
 				if (usr_input == "1")
 				{
-					choose_search(init_state, ASH1);
+					choose_search(solver, ASH1);
 					valid_input = true;
 					loop = false;
 				}
 				else if (usr_input == "2")
 				{
-					choose_search(init_state, ASH2);
+					choose_search(solver, ASH2);
+					valid_input = true;
+					loop = false;
+				}
+				else
+				{
+					std::cout << "Invalid heuristics choice." << std::endl;
+					valid_input = false;
+				}
+			}
+			else if (usr_input == "6")
+			{
+				choose_search(solver, ARA);
+				valid_input = true;
+				loop = false;
+			}
+			else if (usr_input == "7")
+			{
+				std::cout << "  Choose heuristics function 1, 2 or 3 for Beam Search: ";
+				std::cin >> usr_input;
+				if (usr_input == "1" || usr_input == "2" || usr_input == "3")
+				{
+					options.beam_heuristic = atoi(usr_input.c_str());
+					choose_search(solver, BEAM);
 					valid_input = true;
 					loop = false;
 				}
@@ -2154,6 +686,12 @@ int main(int argc, char** argv)
 					valid_input = false;
 				}
 			}
+			else if (usr_input == "8")
+			{
+				choose_search(solver, RETRO);
+				valid_input = true;
+				loop = false;
+			}
 			else
 			{
 				std::cout << "Invalid choice.  Please choose again." << std::endl;
@@ -0,0 +1,8894 @@
+/*  Author: Tony Ling
+ *  Summary: Sokoban solver library, see solver.h.  Everything the searches
+ *   need is held by a Solver or passed down from it, so a process can run
+ *   one Solver per thread.
+ */
+#include "solver.h"
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <sstream>
+#include <vector>
+#include <queue>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <set>
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SKB_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Function used to get the seconds passed since a start time.
+ * 
+ * Preconditions: start time from gettimeofday
+ * Postconditions: returns seconds passed
+ */
+double seconds_since(const timeval &start)
+{
+	timeval now;
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) / 1000000.0;
+} //double seconds_since(const timeval &start)
+
+/* Function used to check if state is the goal state. Goal state is a
+ *  state with no empty goals, nor player on goal. Assumes that there
+ *  exists at least 1 empty goal, ie a level with at least 1 empty goal
+ *  to fill, with the same amount of goals as boxes, and only 1 player.
+ * 
+ * Preconditions: State object representing current state in agent prog
+ * Postconditions: Returns true if goal state is found, otherwise false
+ */
+bool is_goal(State &cur_state)
+{
+	//std::cout << cur_state.state_str<<std::endl;
+	bool goal = false;
+	//if there are no empty goals
+	if ((cur_state.state_str.find_first_of('.')) == std::string::npos)
+	{
+		//if there are no players standing on an empty goal,
+		//then we are in goal state
+		if ((cur_state.state_str.find_first_of('+')) == std::string::npos)
+		{
+			//and there are no boxes not on a goal
+			if ((cur_state.state_str.find_first_of('$')) == std::string::npos)
+				goal = true;
+		}
+	}
+	return goal;
+} //bool is_goal(State &cur_state)
+
+/* Function used to put a level string in canonical text form.  Trailing
+ *  whitespace on each line and trailing empty lines are removed so that
+ *  the same level saved by different editors hashes the same.
+ * 
+ * Preconditions: string representing a level
+ * Postconditions: returns the normalized level string
+ */
+std::string normalize_level(const std::string &level)
+{
+	std::stringstream ss(level);
+	std::string line, normal, blank_lines;
+
+	while (getline(ss, line, '\n'))
+	{
+		std::string::size_type end = line.find_last_not_of(" \t\r");
+		if (end == std::string::npos)
+		{
+			//keep empty lines only if more level follows them
+			blank_lines.append("\n");
+			continue;
+		}
+		normal.append(blank_lines);
+		blank_lines = "";
+		normal.append(line.substr(0, end + 1)) += "\n";
+	}
+	return normal;
+} //std::string normalize_level(const std::string &level)
+
+/* Function used to trim a level to the cells the player can reach.  The
+ *  floor is flood filled from the player, through boxes, and floor cells
+ *  it does not reach, such as the space outside the walls, become walls.
+ *  The level is then cropped to the reached cells and a border of wall
+ *  around them, so a smaller board may fit it.  Boxes and goals out of
+ *  reach are kept, since they still decide if the level can be solved.
+ *  Moves are the same on the trimmed level as on the level.
+ * 
+ * Preconditions: level string
+ * Postconditions: returns the trimmed level string, or the level if it
+ *  has no player
+ */
+std::string trim_level(const std::string &level)
+{
+	std::vector<std::string> lines;
+	std::stringstream ss(level);
+	std::string line, trimmed;
+	std::vector<int> frontier;
+	int width = 0, height;
+	const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+
+	while (getline(ss, line, '\n'))
+	{
+		width = std::max(width, (int)line.size());
+		lines.push_back(line);
+	}
+	height = lines.size();
+	std::vector<char> reached(width * height, 0);
+	for (int y = 0; y < height && frontier.empty(); y++)
+	{
+		std::string::size_type x = lines[y].find_first_of("@+");
+		if (x != std::string::npos)
+			frontier.push_back(y * width + x);
+	}
+	if (frontier.empty())
+		return level;
+
+	//flood fill through everything but walls, cells past the end of a
+	//line are walls as well
+	int left = width, right = -1, top = height, bottom = -1;
+	reached[frontier[0]] = 1;
+	while (!frontier.empty())
+	{
+		int cell = frontier.back(), x = cell % width, y = cell / width;
+		frontier.pop_back();
+		left = std::min(left, x);
+		right = std::max(right, x);
+		top = std::min(top, y);
+		bottom = std::max(bottom, y);
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int nx = x + dx[dir], ny = y + dy[dir];
+			if (ny < 0 || ny >= height || nx < 0 || nx >= (int)lines[ny].size() ||
+			 lines[ny][nx] == '#' || reached[ny * width + nx])
+				continue;
+			reached[ny * width + nx] = 1;
+			frontier.push_back(ny * width + nx);
+		}
+	}
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < (int)lines[y].size(); x++)
+			if (lines[y][x] != ' ' && lines[y][x] != '#')
+			{
+				left = std::min(left, x);
+				right = std::max(right, x);
+				top = std::min(top, y);
+				bottom = std::max(bottom, y);
+			}
+
+	for (int y = std::max(0, top - 1); y <= std::min(height - 1, bottom + 1); y++)
+	{
+		for (int x = std::max(0, left - 1); x <= std::min(width - 1, right + 1); x++)
+		{
+			char c = x < (int)lines[y].size() ? lines[y][x] : '#';
+			trimmed += (c == ' ' && !reached[y * width + x]) ? '#' : c;
+		}
+		trimmed += '\n';
+	}
+	return trimmed;
+} //std::string trim_level(const std::string &level)
+
+/* LevelSymmetry holds the grid symmetries of a level.  A level is drawn
+ *  on a width x height grid, and each of the 8 symmetries of that grid is
+ *  numbered by a transform: bit 4 mirrors the grid left to right, and the
+ *  low 2 bits rotate it clockwise that many times afterwards.  transforms
+ *  lists the symmetries that map the walls and goals onto themselves,
+ *  starting with the identity, and source maps each char of a transformed
+ *  state string back to the char of the original state string.
+ */
+struct LevelSymmetry
+{
+	int width;
+	int height;
+	std::vector<int> transforms;
+	std::vector< std::vector<int> > source;
+}; //struct LevelSymmetry
+
+/* Function used to build the char mapping of a grid transform.  Each line
+ *  of the level is padded with spaces up to the grid width, so ragged
+ *  lines are handled.  In the returned mapping, -1 stands for a padding
+ *  space and -2 for the end of a line.
+ * 
+ * Preconditions: level string, grid width and height, transform number
+ * Postconditions: returns, for each char of the transformed level, the
+ *  index of the char in the level string it comes from
+ */
+std::vector<int> transform_source(const std::string &level, const int width,
+ const int height, const int transform)
+{
+	int out_w = (transform & 1) ? height : width;
+	int out_h = (transform & 1) ? width : height;
+	std::vector<int> source((out_w + 1) * out_h, -1);
+	std::string::size_type pos = 0;
+
+	for (int y = 0; y < out_h; y++)
+		source[y * (out_w + 1) + out_w] = -2;
+
+	for (int y = 0; y < height && pos < level.size(); y++)
+	{
+		for (int x = 0; pos < level.size() && level[pos] != '\n'; x++, pos++)
+		{
+			if (x >= width)
+				continue;
+			//mirror first, then rotate clockwise
+			int tx = (transform & 4) ? width - 1 - x : x;
+			int ty = y, w = width, h = height;
+			for (int r = 0; r < (transform & 3); r++)
+			{
+				int rx = h - 1 - ty;
+				ty = tx;
+				tx = rx;
+				std::swap(w, h);
+			}
+			source[ty * (out_w + 1) + tx] = pos;
+		}
+		pos++;
+	}
+	return source;
+} //std::vector<int> transform_source(const std::string &level, const int width, const int height, const int transform)
+
+/* Function used to apply a char mapping made by transform_source.
+ * 
+ * Preconditions: level string, mapping from transform_source
+ * Postconditions: returns the transformed level string
+ */
+std::string apply_transform(const std::string &level, const std::vector<int> &source)
+{
+	std::string out(source.size(), ' ');
+	for (std::vector<int>::size_type i = 0; i < source.size(); i++)
+	{
+		if (source[i] == -2)
+			out[i] = '\n';
+		else if (source[i] >= 0)
+			out[i] = level[source[i]];
+	}
+	return out;
+} //std::string apply_transform(const std::string &level, const std::vector<int> &source)
+
+/* Function used to transform a single move the same way a grid transform
+ *  moves the level.  Mirroring swaps left and right, and each clockwise
+ *  rotation turns up into right, right into down, and so on.
+ * 
+ * Preconditions: move char 'u', 'r', 'd' or 'l', transform number
+ * Postconditions: returns the transformed move char
+ */
+char transform_move(const char move, const int transform)
+{
+	const std::string order = "urdl";
+	std::string::size_type dir = order.find(move);
+	if (dir == std::string::npos)
+		return move;
+	if ((transform & 4) && (move == 'l' || move == 'r'))
+		dir = (dir + 2) % 4;
+	return order[(dir + (transform & 3)) % 4];
+} //char transform_move(const char move, const int transform)
+
+/* Function used to transform a compact move string, or to undo that
+ *  transform when inverse is set.
+ * 
+ * Preconditions: compact move string, transform number, bool for inverse
+ * Postconditions: returns the transformed move string
+ */
+std::string transform_moves(const std::string &moves, const int transform,
+ const bool inverse = false)
+{
+	const std::string order = "urdl";
+	std::string out = moves;
+	for (std::string::size_type i = 0; i < out.size(); i++)
+	{
+		if (!inverse)
+		{
+			out[i] = transform_move(out[i], transform);
+			continue;
+		}
+		for (int d = 0; d < 4; d++)
+		{
+			if (transform_move(order[d], transform) == moves[i])
+			{
+				out[i] = order[d];
+				break;
+			}
+		}
+	}
+	return out;
+} //std::string transform_moves(const std::string &moves, const int transform, const bool inverse = false)
+
+/* Function used to find the grid size of a level, with the width being
+ *  the longest line once trailing whitespace is removed.
+ * 
+ * Preconditions: level string, int references for width and height
+ * Postconditions: width and height set
+ */
+void level_dimensions(const std::string &level, int &width, int &height)
+{
+	std::stringstream ss(normalize_level(level));
+	std::string line;
+	width = height = 0;
+	while (getline(ss, line, '\n'))
+	{
+		if ((int)line.size() > width)
+			width = line.size();
+		height++;
+	}
+} //void level_dimensions(const std::string &level, int &width, int &height)
+
+/* Function used to find the canonical orientation of a level.  All 8
+ *  grid transforms of the level are compared and the smallest level
+ *  string is used, so rotated and mirrored copies of a level give the
+ *  same canonical level.
+ * 
+ * Preconditions: level string, int reference to store the transform in
+ * Postconditions: returns the canonical level and sets the transform that
+ *  turns the level into it
+ */
+std::string canonical_level(const std::string &level, int &transform)
+{
+	std::string normal = normalize_level(level), best;
+	int width, height;
+
+	level_dimensions(normal, width, height);
+	transform = 0;
+	for (int t = 0; t < 8; t++)
+	{
+		std::string cur = normalize_level(apply_transform(normal,
+		 transform_source(normal, width, height, t)));
+		if (t == 0 || cur < best)
+		{
+			best = cur;
+			transform = t;
+		}
+	}
+	return best;
+} //std::string canonical_level(const std::string &level, int &transform)
+
+/* Function used to find the symmetries of a level.  Only walls and goals
+ *  are compared, since boxes and the player move during the search.  A
+ *  symmetry that rotates by 90 degrees needs a square grid.
+ * 
+ * Preconditions: level string of the initial state
+ * Postconditions: returns LevelSymmetry object, with no transforms if the
+ *  identity is the only symmetry
+ */
+LevelSymmetry find_symmetry(const std::string &level)
+{
+	LevelSymmetry sym;
+	std::string layout = level;
+	std::vector<int> identity;
+
+	level_dimensions(level, sym.width, sym.height);
+	//keep only what does not change during a search
+	for (std::string::size_type i = 0; i < layout.size(); i++)
+	{
+		if (layout[i] == '.' || layout[i] == '+' || layout[i] == '*')
+			layout[i] = '.';
+		else if (layout[i] != '#' && layout[i] != '\n')
+			layout[i] = ' ';
+	}
+
+	identity = transform_source(level, sym.width, sym.height, 0);
+	std::string base = apply_transform(layout, identity);
+	for (int t = 0; t < 8; t++)
+	{
+		if ((t & 1) && sym.width != sym.height)
+			continue;
+		std::vector<int> source = transform_source(level, sym.width, sym.height, t);
+		if (apply_transform(layout, source) == base)
+		{
+			sym.transforms.push_back(t);
+			sym.source.push_back(source);
+		}
+	}
+	if (sym.transforms.size() == 1)
+	{
+		sym.transforms.clear();
+		sym.source.clear();
+	}
+	return sym;
+} //LevelSymmetry find_symmetry(const std::string &level)
+
+/* Bit kernels are the bitboard operations run on every expanded node, on
+ *  arrays of 64 bit words: checking that every set bit of a is also set in
+ *  b (the goal test, boxes & ~goals == 0), counting the bits set in both
+ *  (boxes on goals and boxes on unsafe cells), and one dilation step of
+ *  the player reachability flood fill.  Scalar, SSE4.1 and AVX2 versions
+ *  are built, and the best one the CPU supports is chosen when the program
+ *  starts, see select_bit_kernels.
+ */
+struct BitKernels
+{
+	const char *name;
+	bool (*subset)(const uint64_t *a, const uint64_t *b, const int words);
+	int (*count_and)(const uint64_t *a, const uint64_t *b, const int words);
+	bool (*dilate)(const uint64_t *cur, const uint64_t *open, uint64_t *out,
+	 const int words, const int width);
+}; //struct BitKernels
+
+bool scalar_subset(const uint64_t *a, const uint64_t *b, const int words)
+{
+	uint64_t outside = 0;
+	for (int i = 0; i < words; i++)
+		outside |= a[i] & ~b[i];
+	return outside == 0;
+} //bool scalar_subset(const uint64_t *a, const uint64_t *b, const int words)
+
+int scalar_count_and(const uint64_t *a, const uint64_t *b, const int words)
+{
+	int count = 0;
+	for (int i = 0; i < words; i++)
+		count += __builtin_popcountll(a[i] & b[i]);
+	return count;
+} //int scalar_count_and(const uint64_t *a, const uint64_t *b, const int words)
+
+/* Function used to grow a region of a board by one cell in each direction,
+ *  kept to the open cells.  A cell is bit (cell % 64) of word (cell / 64),
+ *  so east and west are shifts by 1, and south and north shifts by the
+ *  board width, with bits carried between words.  cur needs width / 64 + 1
+ *  zero words before and after its words, the words a row away and the
+ *  one beyond.  Rows do not wrap, since the last cell of each row is a
+ *  wall and never in the region.
+ * 
+ * Preconditions: region, open cells, output words, number of words, board
+ *  width below 64 or a multiple of 64
+ * Postconditions: out set to the grown region, returns true if it grew
+ */
+bool scalar_dilate(const uint64_t *cur, const uint64_t *open, uint64_t *out,
+ const int words, const int width)
+{
+	const int q = width / 64, r = width % 64;
+	uint64_t grown = 0;
+	for (int i = 0; i < words; i++)
+	{
+		uint64_t c = cur[i];
+		uint64_t next = c | (c << 1) | (cur[i - 1] >> 63) | (c >> 1) | (cur[i + 1] << 63);
+		if (r == 0)
+			next |= cur[i - q] | cur[i + q];
+		else
+			next |= (c << r) | (cur[i - 1] >> (64 - r)) | (c >> r) | (cur[i + 1] << (64 - r));
+		out[i] = next & open[i];
+		grown |= out[i] ^ c;
+	}
+	return grown != 0;
+} //bool scalar_dilate(const uint64_t *cur, const uint64_t *open, uint64_t *out, const int words, const int width)
+
+#ifdef SKB_X86_SIMD
+__attribute__((target("sse4.1")))
+bool sse_subset(const uint64_t *a, const uint64_t *b, const int words)
+{
+	int i = 0;
+	for (; i + 2 <= words; i += 2)
+	{
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		//testc is set when (~vb & va) is zero
+		if (!_mm_testc_si128(vb, va))
+			return false;
+	}
+	return scalar_subset(a + i, b + i, words - i);
+} //bool sse_subset(const uint64_t *a, const uint64_t *b, const int words)
+
+__attribute__((target("sse4.1,popcnt")))
+int sse_count_and(const uint64_t *a, const uint64_t *b, const int words)
+{
+	int count = 0, i = 0;
+	for (; i + 2 <= words; i += 2)
+	{
+		__m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *)(a + i)),
+		 _mm_loadu_si128((const __m128i *)(b + i)));
+		count += _mm_popcnt_u64(_mm_extract_epi64(v, 0)) + _mm_popcnt_u64(_mm_extract_epi64(v, 1));
+	}
+	for (; i < words; i++)
+		count += _mm_popcnt_u64(a[i] & b[i]);
+	return count;
+} //int sse_count_and(const uint64_t *a, const uint64_t *b, const int words)
+
+__attribute__((target("avx2")))
+bool avx2_subset(const uint64_t *a, const uint64_t *b, const int words)
+{
+	int i = 0;
+	for (; i + 4 <= words; i += 4)
+	{
+		__m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+		if (!_mm256_testc_si256(vb, va))
+			return false;
+	}
+	return scalar_subset(a + i, b + i, words - i);
+} //bool avx2_subset(const uint64_t *a, const uint64_t *b, const int words)
+
+__attribute__((target("avx2,popcnt")))
+int avx2_count_and(const uint64_t *a, const uint64_t *b, const int words)
+{
+	uint64_t lanes[4];
+	int count = 0, i = 0;
+	for (; i + 4 <= words; i += 4)
+	{
+		__m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(a + i)),
+		 _mm256_loadu_si256((const __m256i *)(b + i)));
+		//most words of a board are empty, skip the popcounts for them
+		if (_mm256_testz_si256(v, v))
+			continue;
+		_mm256_storeu_si256((__m256i *)lanes, v);
+		count += _mm_popcnt_u64(lanes[0]) + _mm_popcnt_u64(lanes[1]) +
+		 _mm_popcnt_u64(lanes[2]) + _mm_popcnt_u64(lanes[3]);
+	}
+	for (; i < words; i++)
+		count += _mm_popcnt_u64(a[i] & b[i]);
+	return count;
+} //int avx2_count_and(const uint64_t *a, const uint64_t *b, const int words)
+
+__attribute__((target("avx2")))
+bool avx2_dilate(const uint64_t *cur, const uint64_t *open, uint64_t *out,
+ const int words, const int width)
+{
+	const int q = width / 64, r = width % 64;
+	const __m128i rs = _mm_cvtsi32_si128(r), rb = _mm_cvtsi32_si128(64 - r);
+	__m256i grown = _mm256_setzero_si256();
+	int i = 0;
+	for (; i + 4 <= words; i += 4)
+	{
+		//the words before and after are loaded unaligned, one word over
+		__m256i c = _mm256_loadu_si256((const __m256i *)(cur + i));
+		__m256i prev = _mm256_loadu_si256((const __m256i *)(cur + i - 1));
+		__m256i after = _mm256_loadu_si256((const __m256i *)(cur + i + 1));
+		__m256i next = _mm256_or_si256(c, _mm256_or_si256(
+		 _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(prev, 63)),
+		 _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(after, 63))));
+		if (r == 0)
+			next = _mm256_or_si256(next, _mm256_or_si256(
+			 _mm256_loadu_si256((const __m256i *)(cur + i - q)),
+			 _mm256_loadu_si256((const __m256i *)(cur + i + q))));
+		else
+			next = _mm256_or_si256(next, _mm256_or_si256(
+			 _mm256_or_si256(_mm256_sll_epi64(c, rs), _mm256_srl_epi64(prev, rb)),
+			 _mm256_or_si256(_mm256_srl_epi64(c, rs), _mm256_sll_epi64(after, rb))));
+		next = _mm256_and_si256(next, _mm256_loadu_si256((const __m256i *)(open + i)));
+		_mm256_storeu_si256((__m256i *)(out + i), next);
+		grown = _mm256_or_si256(grown, _mm256_xor_si256(next, c));
+	}
+	bool tail = i < words && scalar_dilate(cur + i, open + i, out + i, words - i, width);
+	return !_mm256_testz_si256(grown, grown) || tail;
+} //bool avx2_dilate(const uint64_t *cur, const uint64_t *open, uint64_t *out, const int words, const int width)
+#endif
+
+//bit kernels in use, scalar until select_bit_kernels is called
+BitKernels bit_kernels = {"scalar", scalar_subset, scalar_count_and, scalar_dilate};
+
+/* Function used to choose the bit kernels for the CPU the program runs on.
+ *  The SKB_KERNELS environment variable can name a kernel set, scalar, sse
+ *  or avx2, to use a slower one than detected.
+ *
+ * Preconditions: none
+ * Postconditions: bit_kernels set
+ */
+void select_bit_kernels()
+{
+	const char *forced = getenv("SKB_KERNELS");
+	std::string limit = forced ? forced : "avx2";
+
+	bit_kernels.name = "scalar";
+	bit_kernels.subset = scalar_subset;
+	bit_kernels.count_and = scalar_count_and;
+	bit_kernels.dilate = scalar_dilate;
+#ifdef SKB_X86_SIMD
+	__builtin_cpu_init();
+	if (limit == "scalar")
+		return;
+	if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt"))
+	{
+		bit_kernels.name = "sse4.1";
+		bit_kernels.subset = sse_subset;
+		bit_kernels.count_and = sse_count_and;
+	}
+	if (limit == "sse")
+		return;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+	{
+		bit_kernels.name = "avx2";
+		bit_kernels.subset = avx2_subset;
+		bit_kernels.count_and = avx2_count_and;
+		bit_kernels.dilate = avx2_dilate;
+	}
+#endif
+} //void select_bit_kernels()
+
+/* BoardSize is a board size class the solver kernels are compiled for.
+ *  A level is drawn on a WIDTH x HEIGHT board with one bit per cell, so
+ *  the number of bitboard words and the offsets between neighboring cells
+ *  are compile time constants.  Cells of the board outside the level are
+ *  treated as walls.  GUARD is the zero words dilate reads before and
+ *  after the words of a board.
+ */
+template <int W, int H>
+struct BoardSize
+{
+	enum { WIDTH = W, HEIGHT = H, CELLS = W * H, WORDS = (W * H + 63) / 64, GUARD = W / 64 + 1 };
+}; //struct BoardSize
+
+typedef BoardSize<8, 8> Board64;
+typedef BoardSize<16, 8> Board128;
+typedef BoardSize<16, 16> Board256;
+typedef BoardSize<32, 32> Board1024;
+typedef BoardSize<64, 64> Board4096;
+//only for levels too large for 64x64, which few searches can finish
+typedef BoardSize<128, 128> Board16384;
+typedef BoardSize<256, 256> Board65536;
+
+enum board_size {BOARD64, BOARD128, BOARD256, BOARD1024, BOARD4096, BOARD16384, BOARD65536,
+ BOARD_NONE};
+
+/* Bitboard holds one bit for each cell of a board.  Boards of one word
+ *  are handled inline, larger boards use the bit kernels.
+ */
+template <class B>
+struct Bitboard
+{
+	uint64_t word[B::WORDS];
+
+	void clear() { memset(word, 0, sizeof(word)); }
+	bool test(const int cell) const { return (word[cell >> 6] >> (cell & 63)) & 1; }
+	void set(const int cell) { word[cell >> 6] |= (uint64_t)1 << (cell & 63); }
+	void reset(const int cell) { word[cell >> 6] &= ~((uint64_t)1 << (cell & 63)); }
+
+	//true if every bit set here is set in other
+	bool subset_of(const Bitboard &other) const
+	{
+		if (B::WORDS == 1)
+			return (word[0] & ~other.word[0]) == 0;
+		return bit_kernels.subset(word, other.word, B::WORDS);
+	}
+
+	//number of bits set both here and in other
+	int count_and(const Bitboard &other) const
+	{
+		if (B::WORDS == 1)
+			return __builtin_popcountll(word[0] & other.word[0]);
+		return bit_kernels.count_and(word, other.word, B::WORDS);
+	}
+}; //struct Bitboard
+
+/* BoardState is a packed search state, the boxes and the cell of the
+ *  player.  pad keeps the struct free of unset bytes, so states can be
+ *  compared with memcmp.
+ */
+template <class B>
+struct BoardState
+{
+	Bitboard<B> boxes;
+	int32_t player;
+	int32_t pad;
+}; //struct BoardState
+
+/* Successor is a state made by gen_valid_states.  Like a State, it holds
+ *  the counts and scores of the state, but path only holds the moves made
+ *  from its parent, and key is the symmetry key of the state, only set on
+ *  symmetric levels.
+ */
+template <class B>
+struct Successor
+{
+	BoardState<B> state;
+	BoardState<B> key;
+	std::string path;
+	int depth;
+	int moves;
+	int pushes;
+	int total_cost;
+	int hscore;
+}; //struct Successor
+
+/* Function used to check if a box next to a wall is on an unsafe stretch
+ *  of that wall: the wall is unbroken in both directions along it up to a
+ *  corner, with no goal on the way.  along is the direction of the wall
+ *  stretch, 1 for east and west, or B::WIDTH for north and south, and
+ *  side is the offset from a cell to the wall beside it.
+ *
+ * Preconditions: walls and goals of the level, cell of the box, offsets
+ *  along and to the wall
+ * Postconditions: returns true if the box is on an unsafe wall stretch
+ */
+template <class B>
+bool unsafe_wall(const Bitboard<B> &walls, const Bitboard<B> &goals,
+ const int cell, const int along, const int side)
+{
+	for (int dir = -1; dir <= 1; dir += 2)
+	{
+		bool corner = false;
+		//boxes and players are ignored and considered accessible tiles
+		//since they can move
+		for (int i = cell + dir * along; i >= 0 && i < B::CELLS; i += dir * along)
+		{
+			//if goal is found along the way then it cannot be an unsafe position
+			if (goals.test(i))
+				return false;
+			//if the tile beside is not a wall, then it is safe
+			if (!walls.test(i + side))
+				return false;
+			if (walls.test(i))
+			{
+				corner = true;
+				break;
+			}
+			//rows end at the board edge
+			if (along == 1 && (i % B::WIDTH == 0 || i % B::WIDTH == B::WIDTH - 1))
+				break;
+		}
+		if (!corner)
+			return false;
+	}
+	return true;
+} //bool unsafe_wall(const Bitboard<B> &walls, const Bitboard<B> &goals, const int cell, const int along, const int side)
+
+/* Function used to score a box on a cell the way heuristics function 2
+ *  does.  Boxes in a corner score 1, and boxes next to a wall score 1 for
+ *  each unsafe wall stretch they are on, so at most 2.  Only walls and
+ *  goals are looked at, so the score of each cell is found once per level.
+ * 
+ * Preconditions: walls and goals of the level, cell of a box not on a goal
+ * Postconditions: returns the number of unsafe positions of the box
+ */
+template <class B>
+int unsafe_score(const Bitboard<B> &walls, const Bitboard<B> &goals, const int cell)
+{
+	bool N_wall = walls.test(cell - B::WIDTH);
+	bool E_wall = walls.test(cell + 1);
+	bool S_wall = walls.test(cell + B::WIDTH);
+	bool W_wall = walls.test(cell - 1);
+	int score = 0;
+
+	//if box is ever in a corner, then box is in a deadlock position
+	if ((N_wall || S_wall) && (E_wall || W_wall))
+		return 1;
+	//if box is next to a wall, check to see if wall is unbroken with
+	//2 unsafe corners and no goals along the wall
+	if (N_wall && unsafe_wall(walls, goals, cell, 1, -(int)B::WIDTH))
+		score++;
+	if (E_wall && unsafe_wall(walls, goals, cell, B::WIDTH, 1))
+		score++;
+	if (S_wall && unsafe_wall(walls, goals, cell, 1, B::WIDTH))
+		score++;
+	if (W_wall && unsafe_wall(walls, goals, cell, B::WIDTH, -1))
+		score++;
+	return score;
+} //int unsafe_score(const Bitboard<B> &walls, const Bitboard<B> &goals, const int cell)
+
+/* Tunnel flags of a cell in LevelAnalysis.  A cell with walls north and
+ *  south of it is a tunnel for pushes to the east or west, and a cell with
+ *  walls east and west of it is a tunnel for pushes to the north or south.
+ */
+const char TUNNEL_EW = 1;
+const char TUNNEL_NS = 2;
+
+/* LevelAnalysis holds what is known about the walls and goals of a level
+ *  before searching, used to generate macro moves.  Cells are indexed by
+ *  their position in the state string, which is the same for all states
+ *  of a level.  room marks the cells of the goal room, a part of the level
+ *  with goals that is only reachable through the entrance cell, and
+ *  packing_order lists the goals of the room deepest first.
+ */
+struct LevelAnalysis
+{
+	std::vector<int> row_start;
+	std::vector<int> row_len;
+	std::vector<int> cell_x;
+	std::vector<int> cell_y;
+	std::vector<char> tunnel;
+	std::vector<char> room;
+	int entrance;
+	std::vector<int> packing_order;
+}; //struct LevelAnalysis
+
+/* CellMap numbers the floor cells of a board densely, in board order, so
+ *  the boxes of a state can be stored with one bit per floor cell instead
+ *  of one per board cell.  dense maps a board cell to its number, -1 for
+ *  a wall, and grid maps numbers back.  neighbor holds the number of the
+ *  cell next to each floor cell in direction 0 to 3, 'u', 'r', 'd' and
+ *  'l', at 4 * number + direction, -1 for a wall.  words is the 64 bit
+ *  words a set of floor cells takes.
+ */
+struct CellMap
+{
+	std::vector<int> dense;
+	std::vector<int> grid;
+	std::vector<int> neighbor;
+	int words;
+}; //struct CellMap
+
+/* PatternDb is the pattern database of a level, for heuristics function 3.
+ *  For every set of boxes boxes on the floor cells, ranked by
+ *  pattern_rank, value holds the fewest pushes that put them all on goals
+ *  with no other box on the board, see build_patterns, or PATTERN_DEAD if
+ *  they can not be.  value points into the mapping of the file of the
+ *  table, or into built if it was not stored.  choose holds the binomial
+ *  coefficients of the ranks, n choose r at n * (boxes + 1) + r.
+ */
+const uint8_t PATTERN_DEAD = 255;
+
+struct PatternDb
+{
+	uint64_t level_hash;
+	int boxes;
+	int floor;
+	uint64_t entries;
+	const uint8_t *value;
+	void *map;
+	size_t map_size;
+	std::vector<uint8_t> built;
+	std::vector<uint64_t> choose;
+
+	PatternDb() : level_hash(0), boxes(0), floor(0), entries(0), value(NULL), map(NULL), map_size(0) {}
+}; //struct PatternDb
+
+/* Function used to rank a set of floor cells among all sets of the same
+ *  size, by the combinatorial number system, so the ranks of the sets of
+ *  k of n cells are exactly 0 to n choose k - 1.
+ *
+ * Preconditions: PatternDb with choose filled in, db.boxes floor cell
+ *  numbers in increasing order
+ * Postconditions: returns the rank of the set
+ */
+uint64_t pattern_rank(const PatternDb &db, const int *cells)
+{
+	uint64_t rank = 0;
+	for (int i = 0; i < db.boxes; i++)
+		rank += db.choose[cells[i] * (db.boxes + 1) + i + 1];
+	return rank;
+} //uint64_t pattern_rank(const PatternDb &db, const int *cells)
+
+/* StateRanks numbers every state of a number of boxes on the floor cells
+ *  of a level densely from 0, for the tables holding one entry per state.
+ *  States are packed as by NodeArena::pack.  The boxes are ranked among
+ *  all sets of as many floor cells by the combinatorial number system,
+ *  as pattern_rank does, times the floor cells left for the player, plus
+ *  the rank of the player among them.  reset fails if there are more
+ *  states than limit.  Binomial coefficients are capped above the limit,
+ *  which only caps ones too big to be used, as every term of a rank is
+ *  below the number of box sets.
+ */
+class StateRanks
+{
+public:
+	StateRanks() : floor(0), boxes(0), words(0), count(0) {}
+	bool reset(const int floor, const int words, const int boxes, const uint64_t limit);
+	uint64_t states() const { return count; }
+	uint64_t rank(const uint64_t *packed) const;
+	void unrank(const uint64_t rank, uint64_t *packed) const;
+	long bytes() const { return choose.size() * sizeof(uint64_t); }
+
+private:
+	int floor;
+	int boxes;
+	int words;
+	uint64_t count;
+	//n choose r at n * (boxes + 1) + r
+	std::vector<uint64_t> choose;
+}; //class StateRanks
+
+/* Function used to set up the ranks of the states of a level.
+ *
+ * Preconditions: floor cells of the level, words a set of them takes,
+ *  boxes of the states, most states to rank
+ * Postconditions: returns true if the states are at most limit, and
+ *  states() is their number, otherwise false with none ranked
+ */
+bool StateRanks::reset(const int floor, const int words, const int boxes, const uint64_t limit)
+{
+	this->floor = floor;
+	this->words = words;
+	this->boxes = boxes;
+	count = 0;
+	std::vector<uint64_t>().swap(choose);
+	if (boxes < 0 || boxes >= floor || limit == 0)
+		return false;
+	std::vector<uint64_t> table((floor + 1) * (boxes + 1), 0);
+	for (int n = 0; n <= floor; n++)
+	{
+		table[n * (boxes + 1)] = 1;
+		for (int r = 1; r <= boxes && r <= n; r++)
+			table[n * (boxes + 1) + r] = std::min(limit + 1,
+			 table[(n - 1) * (boxes + 1) + r - 1] + table[(n - 1) * (boxes + 1) + r]);
+	}
+	const uint64_t sets = table[floor * (boxes + 1) + boxes];
+	if (sets > limit / (floor - boxes))
+		return false;
+	choose.swap(table);
+	count = sets * (floor - boxes);
+	return true;
+} //bool StateRanks::reset(const int floor, const int words, const int boxes, const uint64_t limit)
+
+uint64_t StateRanks::rank(const uint64_t *packed) const
+{
+	const uint64_t player = packed[words];
+	uint64_t rank = 0, below = 0;
+	int i = 0;
+	for (int w = 0; w < words; w++)
+		for (uint64_t bits = packed[w]; bits; bits &= bits - 1)
+		{
+			uint64_t cell = w * 64 + __builtin_ctzll(bits);
+			rank += choose[cell * (boxes + 1) + ++i];
+			below += cell < player;
+		}
+	return rank * (floor - boxes) + player - below;
+}
+
+void StateRanks::unrank(const uint64_t rank, uint64_t *packed) const
+{
+	uint64_t sets = rank / (floor - boxes), free = rank % (floor - boxes);
+	memset(packed, 0, (words + 1) * sizeof(uint64_t));
+	//the largest box first, each the largest cell whose term fits
+	int cell = floor - 1;
+	for (int i = boxes; i > 0; i--, cell--)
+	{
+		while (choose[cell * (boxes + 1) + i] > sets)
+			cell--;
+		sets -= choose[cell * (boxes + 1) + i];
+		packed[cell >> 6] |= (uint64_t)1 << (cell & 63);
+	}
+	for (cell = 0; ; cell++)
+		if (!(packed[cell >> 6] >> (cell & 63) & 1) && free-- == 0)
+			break;
+	packed[words] = cell;
+}
+
+/* Kernel holds what does not change during the search of a level on a
+ *  board: the walls and goals, the unsafe cells of heuristics function 2,
+ *  the level string with boxes and the player taken out, the string index
+ *  of each cell, and the cell mapping of each level symmetry.  It converts
+ *  between state strings and BoardStates.  unsafe holds the cells scoring
+ *  at least 1 in unsafe_score, and unsafe_twice the cells scoring 2.  The
+ *  options and level analysis of the solve are kept for gen_valid_states,
+ *  and with macro moves the tunnels, goal room, entrance and packing order
+ *  of the analysis are kept as board cells, so macro moves are made on
+ *  BoardStates.
+ *  cells numbers the floor cells, which are only the cells the player can
+ *  reach once the level is trimmed, see trim_level, and goal_distance
+ *  holds the steps from each floor cell to the nearest goal, by number.
+ *  level_hash is a hash of the walls and goals, so patterns of different
+ *  levels in a shared DeadlockTable do not mix, patterns is the pattern
+ *  database of heuristics function 3, NULL if none, with pattern_sets
+ *  kept for pattern_h to score states without allocating, and the deadlock counts
+ *  of the search are kept here, since the kernel is its only state that
+ *  gen_valid_states sees.
+ */
+template <class B>
+class Kernel
+{
+public:
+	Kernel(const std::string &level, const LevelSymmetry &sym, const SolverOptions &options,
+	 const LevelAnalysis &analysis);
+	void load(const std::string &level, BoardState<B> &state) const;
+	std::string unload(const BoardState<B> &state) const;
+	void set_key(Successor<B> &node) const;
+	bool is_goal(const BoardState<B> &state) const;
+	bool keyed() const { return !sym_cells.empty(); }
+
+	//cell next to a cell in direction 0 to 3, 'u', 'r', 'd' and 'l'
+	static int step(const int cell, const int dir)
+	{
+		return cell + (dir == 0 ? -(int)B::WIDTH : dir == 1 ? 1 : dir == 2 ? (int)B::WIDTH : -1);
+	}
+
+	Bitboard<B> walls;
+	Bitboard<B> goals;
+	Bitboard<B> unsafe;
+	Bitboard<B> unsafe_twice;
+	CellMap cells;
+	std::vector<int> goal_distance;
+	uint64_t level_hash;
+	const PatternDb *patterns;
+	mutable std::vector< std::pair<int, uint64_t> > pattern_sets;
+	mutable int deadlocks_learned;
+	mutable int deadlocks_pruned;
+	const SolverOptions &options;
+	const LevelAnalysis &analysis;
+	Bitboard<B> tunnel_ew;
+	Bitboard<B> tunnel_ns;
+	Bitboard<B> room;
+	int entrance;
+	std::vector<int> packing_order;
+
+private:
+	std::string base;
+	std::vector<int> cell_index;
+	std::vector<int> string_cell;
+	std::vector< std::vector<int> > sym_cells;
+}; //class Kernel
+
+/* Function used to build the kernel of a level.  The level has to fit the
+ *  board, see choose_board.
+ *
+ * Preconditions: level string of the initial state, symmetries of the
+ *  level, options of the solve, analysis of the level for macro moves
+ * Postconditions: Kernel object built
+ */
+template <class B>
+Kernel<B>::Kernel(const std::string &level, const LevelSymmetry &sym,
+ const SolverOptions &options, const LevelAnalysis &analysis)
+ : patterns(NULL), deadlocks_learned(0), deadlocks_pruned(0), options(options), analysis(analysis), entrance(-1),
+ base(level), cell_index(B::CELLS, -1), string_cell(level.size(), -1)
+{
+	int x = 0, y = 0;
+
+	walls.clear();
+	goals.clear();
+	for (std::string::size_type i = 0; i < level.size(); i++)
+	{
+		if (level[i] == '\n')
+		{
+			x = 0;
+			y++;
+			continue;
+		}
+		int cell = y * B::WIDTH + x++;
+		cell_index[cell] = i;
+		string_cell[i] = cell;
+		if (level[i] == '#')
+			walls.set(cell);
+		if (level[i] == '.' || level[i] == '+' || level[i] == '*')
+			goals.set(cell);
+		//boxes and the player are put back in by unload
+		if (level[i] == '$' || level[i] == '@')
+			base[i] = ' ';
+		else if (level[i] == '*' || level[i] == '+')
+			base[i] = '.';
+	}
+	for (int cell = 0; cell < B::CELLS; cell++)
+	{
+		if (cell_index[cell] < 0)
+			walls.set(cell);
+	}
+
+	//tunnels and goal room of macro moves, from string indexes to cells
+	tunnel_ew.clear();
+	tunnel_ns.clear();
+	room.clear();
+	if (options.macro_moves)
+	{
+		for (std::string::size_type i = 0; i < level.size(); i++)
+		{
+			if (string_cell[i] < 0)
+				continue;
+			if (analysis.tunnel[i] & TUNNEL_EW)
+				tunnel_ew.set(string_cell[i]);
+			if (analysis.tunnel[i] & TUNNEL_NS)
+				tunnel_ns.set(string_cell[i]);
+			if (analysis.room[i])
+				room.set(string_cell[i]);
+		}
+		if (analysis.entrance >= 0)
+			entrance = string_cell[analysis.entrance];
+		for (std::vector<int>::size_type i = 0; i < analysis.packing_order.size(); i++)
+			packing_order.push_back(string_cell[analysis.packing_order[i]]);
+	}
+
+	//FNV-1a of the level with boxes and the player taken out
+	level_hash = 14695981039346656037ULL;
+	for (std::string::size_type i = 0; i < base.size(); i++)
+		level_hash = (level_hash ^ (unsigned char)base[i]) * 1099511628211ULL;
+
+	//floor cells numbered densely, with their neighbors
+	cells.dense.assign(B::CELLS, -1);
+	for (int cell = 0; cell < B::CELLS; cell++)
+	{
+		if (walls.test(cell))
+			continue;
+		cells.dense[cell] = cells.grid.size();
+		cells.grid.push_back(cell);
+	}
+	cells.words = (cells.grid.size() + 63) / 64;
+	for (std::vector<int>::size_type i = 0; i < cells.grid.size(); i++)
+	{
+		int x = cells.grid[i] % B::WIDTH, y = cells.grid[i] / B::WIDTH;
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next = step(cells.grid[i], dir);
+			//cells on the edge of the board have no neighbor past it
+			bool edge = (dir == 0 && y == 0) || (dir == 1 && x == B::WIDTH - 1) ||
+			 (dir == 2 && y == B::HEIGHT - 1) || (dir == 3 && x == 0);
+			cells.neighbor.push_back(edge ? -1 : cells.dense[next]);
+		}
+	}
+
+	//steps from each floor cell to the nearest goal, breadth first from
+	//every goal at once, cells that reach no goal get the floor cell count
+	goal_distance.assign(cells.grid.size(), cells.grid.size());
+	std::deque<int> frontier;
+	for (std::vector<int>::size_type i = 0; i < cells.grid.size(); i++)
+		if (goals.test(cells.grid[i]))
+		{
+			goal_distance[i] = 0;
+			frontier.push_back(i);
+		}
+	while (!frontier.empty())
+	{
+		int i = frontier.front();
+		frontier.pop_front();
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next = cells.neighbor[4 * i + dir];
+			if (next >= 0 && goal_distance[next] > goal_distance[i] + 1)
+			{
+				goal_distance[next] = goal_distance[i] + 1;
+				frontier.push_back(next);
+			}
+		}
+	}
+
+	//dead squares, boxes on goals are never unsafe
+	unsafe.clear();
+	unsafe_twice.clear();
+	for (std::vector<int>::size_type i = 0; i < cells.grid.size(); i++)
+	{
+		int cell = cells.grid[i];
+		int x = cell % B::WIDTH, y = cell / B::WIDTH;
+		if (goals.test(cell) || x == 0 || y == 0 || x == B::WIDTH - 1 || y == B::HEIGHT - 1)
+			continue;
+		int score = unsafe_score(walls, goals, cell);
+		if (score > 0)
+			unsafe.set(cell);
+		if (score > 1)
+			unsafe_twice.set(cell);
+	}
+
+	//cell mapping of each symmetry, from the char mapping of the transform
+	for (std::vector<int>::size_type t = 0; t < sym.source.size(); t++)
+	{
+		int out_w = (sym.transforms[t] & 1) ? sym.height : sym.width;
+		std::vector<int> cells(B::CELLS, 0);
+		for (std::vector<int>::size_type pos = 0; pos < sym.source[t].size(); pos++)
+		{
+			if (sym.source[t][pos] < 0)
+				continue;
+			int from = string_cell[sym.source[t][pos]];
+			cells[from] = (pos / (out_w + 1)) * B::WIDTH + pos % (out_w + 1);
+		}
+		sym_cells.push_back(cells);
+	}
+}
+
+/* Function used to read the boxes and the player of a state string.
+ *
+ * Preconditions: state string of the level, BoardState to fill in
+ * Postconditions: BoardState set from the state string
+ */
+template <class B>
+void Kernel<B>::load(const std::string &level, BoardState<B> &state) const
+{
+	state.boxes.clear();
+	state.player = 0;
+	state.pad = 0;
+	for (std::string::size_type i = 0; i < level.size(); i++)
+	{
+		if (level[i] == '$' || level[i] == '*')
+			state.boxes.set(string_cell[i]);
+		else if (level[i] == '@' || level[i] == '+')
+			state.player = string_cell[i];
+	}
+}
+
+/* Function used to turn a BoardState back into a state string.
+ *
+ * Preconditions: BoardState of the level
+ * Postconditions: returns the state string
+ */
+template <class B>
+std::string Kernel<B>::unload(const BoardState<B> &state) const
+{
+	std::string level = base;
+	for (int w = 0; w < B::WORDS; w++)
+	{
+		for (uint64_t bits = state.boxes.word[w]; bits; bits &= bits - 1)
+		{
+			int i = cell_index[w * 64 + __builtin_ctzll(bits)];
+			level[i] = (level[i] == '.') ? '*' : '$';
+		}
+	}
+	int i = cell_index[state.player];
+	level[i] = (level[i] == '.') ? '+' : '@';
+	return level;
+}
+
+/* Function used to set the symmetry key of a state.  States that are
+ *  symmetric copies of each other under the level symmetries share the
+ *  same key, which is the smallest of their transformed states.  If the
+ *  level has no symmetries, the key is left unset and states are compared
+ *  by their BoardStates.
+ *
+ * Preconditions: Successor object
+ * Postconditions: key of the state set
+ */
+template <class B>
+void Kernel<B>::set_key(Successor<B> &node) const
+{
+	for (std::vector< std::vector<int> >::size_type t = 0; t < sym_cells.size(); t++)
+	{
+		BoardState<B> cur;
+		cur.boxes.clear();
+		cur.player = sym_cells[t][node.state.player];
+		cur.pad = 0;
+		for (int w = 0; w < B::WORDS; w++)
+		{
+			for (uint64_t bits = node.state.boxes.word[w]; bits; bits &= bits - 1)
+				cur.boxes.set(sym_cells[t][w * 64 + __builtin_ctzll(bits)]);
+		}
+		if (t == 0 || memcmp(&cur, &node.key, sizeof(cur)) < 0)
+			node.key = cur;
+	}
+}
+
+/* Function used to check if all boxes are on goals, that is if no box is
+ *  outside the goals bitboard.
+ *
+ * Preconditions: BoardState of the level
+ * Postconditions: returns true if every box is on a goal
+ */
+template <class B>
+bool Kernel<B>::is_goal(const BoardState<B> &state) const
+{
+	return state.boxes.subset_of(goals);
+}
+
+/* Heuristics function uses Manhattan distance between player and
+ *  nearest box, and between the boxes and the goals.  Boxes on goals
+ *  take 1000 off the score, so the search lets them remain on the goals.
+ *
+ * Preconditions: Kernel of the level, BoardState object
+ * Postcoditions: int return representing heuristics score
+ */
+template <class B>
+int h1(const Kernel<B> &kernel, const BoardState<B> &state)
+{
+	int box_x[B::CELLS / 2 + 1], box_y[B::CELLS / 2 + 1];
+	int goal_x[B::CELLS / 2 + 1], goal_y[B::CELLS / 2 + 1];
+	int box_count = 0, goal_count = 0;
+	int x = state.player % B::WIDTH, y = state.player / B::WIDTH;
+	int score = 0;
+	int playerdist = 1000;
+
+	score -= 1000 * state.boxes.count_and(kernel.goals);
+	for (int w = 0; w < B::WORDS; w++)
+	{
+		uint64_t boxes = state.boxes.word[w];
+		uint64_t goals = kernel.goals.word[w];
+		for (uint64_t bits = boxes & ~goals; bits; bits &= bits - 1)
+		{
+			int cell = w * 64 + __builtin_ctzll(bits);
+			box_x[box_count] = cell % B::WIDTH;
+			box_y[box_count++] = cell / B::WIDTH;
+		}
+		for (uint64_t bits = goals & ~boxes; bits; bits &= bits - 1)
+		{
+			int cell = w * 64 + __builtin_ctzll(bits);
+			goal_x[goal_count] = cell % B::WIDTH;
+			goal_y[goal_count++] = cell / B::WIDTH;
+		}
+	}
+
+	//for each box on the floor, calculate the distance to each empty goal
+	for (int i = 0; i < box_count; i++)
+	{
+		for (int j = 0; j < goal_count; j++)
+			score += abs(box_x[i] - goal_x[j]) + abs(box_y[i] - goal_y[j]);
+		//stores shortest distance to any box
+		//NOTE: This only works if shortest distance is within 1000 tiles
+		int dist = abs(box_x[i] - x) + abs(box_y[i] - y);
+		if (playerdist > dist)
+			playerdist = dist;
+	}
+	score += playerdist;
+	return score;
+} //int h1(const Kernel<B> &kernel, const BoardState<B> &state)
+
+/* Heuristics function checks to see if boxes not on goals are in any
+ *  'unsafe' position.  Unsafe positions are corners with no goals, and
+ *  tiles along unbroken walls of 2 unsafe corners with no goals along
+ *  the wall.  Unlike heuristics function 1, this function calculates
+ *  no distances between any objects, nor prioritizes boxes already on
+ *  goals.  The unsafe cells are found when the kernel is built, so the
+ *  score is a count of boxes on the unsafe masks, see unsafe_score.
+ *
+ * Preconditions: Kernel of the level, BoardState object
+ * Postcoditions: int return representing heuristics score
+ */
+template <class B>
+int h2(const Kernel<B> &kernel, const BoardState<B> &state)
+{
+	return 1000 * (state.boxes.count_and(kernel.unsafe) +
+	 state.boxes.count_and(kernel.unsafe_twice));
+} //int h2(const Kernel<B> &kernel, const BoardState<B> &state)
+
+/* Function used to score a state by the pattern database.  Each box
+ *  first scores its steps to the nearest goal.  Every set of db.boxes
+ *  boxes is then looked up, and the sets scoring more than their boxes
+ *  alone are taken greedily, by the most they add, as long as they share
+ *  no box with a set already taken.  Each push moves a box of only one
+ *  set, and no set of boxes can be solved in fewer pushes than alone on
+ *  the board, so the sum is a lower bound on the pushes left.
+ *
+ * Preconditions: Kernel of the level with its pattern database, BoardState
+ * Postconditions: int return representing the pushes left at least
+ */
+template <class B>
+int pattern_h(const Kernel<B> &kernel, const BoardState<B> &state)
+{
+	const PatternDb &db = *kernel.patterns;
+	std::vector< std::pair<int, uint64_t> > &sets = kernel.pattern_sets;
+	int cells[B::CELLS], n = 0, score = 0;
+
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = state.boxes.word[w]; bits; bits &= bits - 1)
+		{
+			cells[n] = kernel.cells.dense[w * 64 + __builtin_ctzll(bits)];
+			score += kernel.goal_distance[cells[n++]];
+		}
+	//more boxes than a set mask holds are scored without the database
+	if (n < db.boxes || n > 64)
+		return score;
+
+	//every set of db.boxes boxes, by index into cells, with what it adds
+	int pick[3], group[3];
+	sets.clear();
+	for (int i = 0; i < db.boxes; i++)
+		pick[i] = i;
+	while (true)
+	{
+		uint64_t mask = 0;
+		int alone = 0;
+		for (int i = 0; i < db.boxes; i++)
+		{
+			group[i] = cells[pick[i]];
+			alone += kernel.goal_distance[group[i]];
+			mask |= (uint64_t)1 << pick[i];
+		}
+		int gain = db.value[pattern_rank(db, group)] - alone;
+		if (gain > 0)
+			sets.push_back(std::make_pair(gain, mask));
+		int i = db.boxes - 1;
+		while (i >= 0 && pick[i] == n - db.boxes + i)
+			i--;
+		if (i < 0)
+			break;
+		pick[i]++;
+		for (int j = i + 1; j < db.boxes; j++)
+			pick[j] = pick[j - 1] + 1;
+	}
+	std::sort(sets.begin(), sets.end());
+
+	uint64_t used = 0;
+	for (std::vector< std::pair<int, uint64_t> >::size_type i = sets.size(); i-- > 0; )
+	{
+		if (sets[i].second & used)
+			continue;
+		used |= sets[i].second;
+		score += sets[i].first;
+	}
+	return score;
+} //int pattern_h(const Kernel<B> &kernel, const BoardState<B> &state)
+
+/* Heuristics function 3 is a lower bound on the cost left to the goal,
+ *  for anytime repairing A* search, which needs one to prove a solution
+ *  optimal.  Each box off a goal needs at least as many pushes as the
+ *  steps from its cell to the nearest goal over the floor, which the
+ *  kernel finds once per level.  A push moves one box by one cell, so the
+ *  score never drops by more than the cost of the push, and the function
+ *  is consistent as well as admissible.  With a pattern database, the
+ *  score of pattern_h is used instead, which is never lower and takes
+ *  the pushes boxes make to get out of each other's way into account.
+ *
+ * Preconditions: Kernel of the level, BoardState object, cost of a push
+ * Postcoditions: int return representing heuristics score
+ */
+template <class B>
+int h3(const Kernel<B> &kernel, const BoardState<B> &state, const int push_cost)
+{
+	int score = 0;
+
+	if (kernel.patterns)
+		return pattern_h(kernel, state) * push_cost;
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = state.boxes.word[w] & ~kernel.goals.word[w]; bits; bits &= bits - 1)
+			score += kernel.goal_distance[kernel.cells.dense[w * 64 + __builtin_ctzll(bits)]];
+	return score * push_cost;
+} //int h3(const Kernel<B> &kernel, const BoardState<B> &state, const int push_cost)
+
+
+/* Function used to look up the cost of a move and a push for a search
+ *  mode.  By default every mode uses a cost of 1 for both, except
+ *  uniformed cost search which uses a push cost of 2.  The -cost option
+ *  replaces this with one of the cost models below, where a move is a
+ *  step that does not push a box:
+ *   COST_MOVES - every step costs 1, fewest moves and pushes together
+ *   COST_PUSHES - pushes cost 1 and moves are free, fewest pushes
+ *   COST_WEIGHTED - moves and pushes cost the weights given
+ *  Ties are broken by tie_cost.
+ * 
+ * Preconditions: CostModel in use, int representing what searching
+ *  algorithm used, and two int references to store the costs in
+ * Postconditions: move_cost and push_cost set for the search mode
+ */
+void cost_model(const CostModel &costs, const int smode, int &move_cost, int &push_cost)
+{
+	move_cost = 1;
+	push_cost = 1;
+	switch (costs.mode)
+	{
+		case COST_MOVES:
+			break;
+		case COST_PUSHES:
+			move_cost = 0;
+			break;
+		case COST_WEIGHTED:
+			move_cost = costs.move_weight;
+			push_cost = costs.push_weight;
+			break;
+		default:
+			//if search algorithm is uniformed cost search, set push_cost to 2
+			if (smode == UCS)
+				push_cost = 2;
+	}
+} //void cost_model(const CostModel &costs, const int smode, int &move_cost, int &push_cost)
+
+/* Function used to check if a search mode adds up the cost of the moves
+ *  and pushes of its nodes.
+ * 
+ * Preconditions: int representing what searching algorithm used
+ * Postconditions: returns true if total costs are calculated
+ */
+bool costed(const int smode)
+{
+	return smode == UCS || smode == ASH1 || smode == ASH2 || smode == ARA;
+} //bool costed(const int smode)
+
+/* Function used to look up the tie breaking cost of a move and a push.
+ *  States with the same cost are ordered by this second cost, so moves
+ *  first solving finds the fewest pushes among the fewest steps, and
+ *  pushes first solving finds the fewest steps among the fewest pushes.
+ * 
+ * Preconditions: CostModel in use, two int references to store the costs in
+ * Postconditions: move_cost and push_cost set for the cost model
+ */
+void tie_cost(const CostModel &costs, int &move_cost, int &push_cost)
+{
+	move_cost = push_cost = 0;
+	if (costs.mode == COST_MOVES)
+		push_cost = 1;
+	else if (costs.mode == COST_PUSHES)
+		move_cost = push_cost = 1;
+} //void tie_cost(const CostModel &costs, int &move_cost, int &push_cost)
+
+/* Function used to find the neighbor of a cell in a level.  Directions
+ *  are numbered 0 to 3 for north, east, south and west, in the same order
+ *  as the "urdl" move chars.
+ * 
+ * Preconditions: LevelAnalysis of the level, index of a cell in the state
+ *  string, direction
+ * Postconditions: returns the index of the neighboring cell, or -1 if it
+ *  is outside the level
+ */
+int cell_step(const LevelAnalysis &la, const int cell, const int dir)
+{
+	const int dx[4] = {0, 1, 0, -1};
+	const int dy[4] = {-1, 0, 1, 0};
+	if (cell < 0 || la.cell_x[cell] < 0)
+		return -1;
+	int nx = la.cell_x[cell] + dx[dir];
+	int ny = la.cell_y[cell] + dy[dir];
+	if (ny < 0 || ny >= (int)la.row_len.size() || nx < 0 || nx >= la.row_len[ny])
+		return -1;
+	return la.row_start[ny] + nx;
+} //int cell_step(const LevelAnalysis &la, const int cell, const int dir)
+
+/* Function used to flood fill the floor of a level from a cell.  Boxes
+ *  and the player are ignored, only walls and the blocked cell stop the
+ *  fill.
+ * 
+ * Preconditions: LevelAnalysis of the level, level string, start cell,
+ *  blocked cell or -1, and a vector<char> marking cells already filled
+ * Postconditions: cells reached are marked, and returned in a vector
+ */
+std::vector<int> flood_floor(const LevelAnalysis &la, const std::string &level,
+ const int start, const int blocked, std::vector<char> &filled)
+{
+	std::vector<int> region;
+	if (start < 0 || start == blocked || filled[start] || level[start] == '#')
+		return region;
+	filled[start] = 1;
+	region.push_back(start);
+	for (std::vector<int>::size_type i = 0; i < region.size(); i++)
+	{
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next = cell_step(la, region[i], dir);
+			if (next < 0 || next == blocked || filled[next] || level[next] == '#')
+				continue;
+			filled[next] = 1;
+			region.push_back(next);
+		}
+	}
+	return region;
+} //std::vector<int> flood_floor(const LevelAnalysis &la, const std::string &level, const int start, const int blocked, std::vector<char> &filled)
+
+/* Function used to analyze a level for macro moves.  Tunnel cells are
+ *  marked, and a goal room is searched for by removing each floor cell in
+ *  turn and checking if that cuts off a part of the level holding goals
+ *  but no boxes and not the player.  If more than one is found, the room
+ *  with the most goals is used.  Goals of the room are ordered by their
+ *  distance from the entrance, so the deepest goals are filled first.
+ * 
+ * Preconditions: level string of the initial state, LevelAnalysis object
+ * Postconditions: LevelAnalysis set up for the level
+ */
+void analyze_level(const std::string &level, LevelAnalysis &la)
+{
+	int player = level.find_first_of("@+");
+	int best_goals = 0;
+
+	la = LevelAnalysis();
+	la.entrance = -1;
+	la.cell_x.assign(level.size(), -1);
+	la.cell_y.assign(level.size(), -1);
+	la.tunnel.assign(level.size(), 0);
+	la.room.assign(level.size(), 0);
+	for (std::string::size_type i = 0, start = 0; i < level.size(); i++)
+	{
+		if (level[i] != '\n')
+		{
+			la.cell_x[i] = i - start;
+			la.cell_y[i] = la.row_start.size();
+			continue;
+		}
+		la.row_start.push_back(start);
+		la.row_len.push_back(i - start);
+		start = i + 1;
+	}
+
+	//tunnel cells have walls, or the edge of the level, on both sides
+	for (std::string::size_type i = 0; i < level.size(); i++)
+	{
+		if (level[i] == '#' || level[i] == '\n')
+			continue;
+		int n = cell_step(la, i, 0), e = cell_step(la, i, 1);
+		int s = cell_step(la, i, 2), w = cell_step(la, i, 3);
+		if ((n < 0 || level[n] == '#') && (s < 0 || level[s] == '#'))
+			la.tunnel[i] |= TUNNEL_EW;
+		if ((e < 0 || level[e] == '#') && (w < 0 || level[w] == '#'))
+			la.tunnel[i] |= TUNNEL_NS;
+	}
+
+	//only the part of the level the player can reach is searched for rooms
+	std::vector<char> reached(level.size(), 0);
+	std::vector<int> floor = flood_floor(la, level, player, -1, reached);
+	for (std::vector<int>::size_type i = 0; i < floor.size(); i++)
+	{
+		int entrance = floor[i];
+		if (level[entrance] == '.' || level[entrance] == '*' || level[entrance] == '+')
+			continue;
+		std::vector<char> filled(level.size(), 0);
+		for (int dir = 0; dir < 4; dir++)
+		{
+			std::vector<int> part = flood_floor(la, level, cell_step(la, entrance, dir),
+			 entrance, filled);
+			int goals = 0;
+			bool usable = !part.empty();
+			for (std::vector<int>::size_type j = 0; j < part.size() && usable; j++)
+			{
+				char c = level[part[j]];
+				if (c == '$' || c == '@' || c == '+')
+					usable = false;
+				else if (c == '.' || c == '*')
+					goals++;
+			}
+			if (!usable || goals <= best_goals)
+				continue;
+			best_goals = goals;
+			la.entrance = entrance;
+			la.room.assign(level.size(), 0);
+			for (std::vector<int>::size_type j = 0; j < part.size(); j++)
+				la.room[part[j]] = 1;
+		}
+	}
+
+	//packing order by distance from the entrance, deepest goal first
+	if (la.entrance >= 0)
+	{
+		std::vector<int> dist(level.size(), -1);
+		std::vector<int> order;
+		std::deque<int> frontier;
+		dist[la.entrance] = 0;
+		frontier.push_back(la.entrance);
+		while (!frontier.empty())
+		{
+			int cell = frontier.front();
+			frontier.pop_front();
+			if (level[cell] == '.' || level[cell] == '*')
+				order.push_back(cell);
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int next = cell_step(la, cell, dir);
+				if (next < 0 || !la.room[next] || dist[next] >= 0 || level[next] == '#')
+					continue;
+				dist[next] = dist[cell] + 1;
+				frontier.push_back(next);
+			}
+		}
+		la.packing_order.assign(order.rbegin(), order.rend());
+	}
+} //void analyze_level(const std::string &level, LevelAnalysis &la)
+
+/* Function used to make one player step on a state string, pushing a box
+ *  if there is one in the way.  Same rules as gen_valid_states.
+ * 
+ * Preconditions: LevelAnalysis of the level, CostModel in use, State
+ *  object, index of the player, direction, int representing search algo
+ * Postconditions: returns true and updates the state and player index if
+ *  the step is valid, with move list, counts and total cost updated
+ */
+bool macro_step(const LevelAnalysis &la, const CostModel &costs, State &cur_state,
+ int &player, const int dir, const int smode)
+{
+	const char move_char[4] = {'u', 'r', 'd', 'l'};
+	std::string &str = cur_state.state_str;
+	int move_cost, push_cost;
+	int next = cell_step(la, player, dir);
+	if (next < 0)
+		return false;
+
+	cost_model(costs, smode, move_cost, push_cost);
+	if (str[next] == '$' || str[next] == '*')
+	{
+		int beyond = cell_step(la, next, dir);
+		if (beyond < 0 || (str[beyond] != ' ' && str[beyond] != '.'))
+			return false;
+		str[beyond] = (str[beyond] == '.') ? '*' : '$';
+		str[next] = (str[next] == '*') ? '.' : ' ';
+		cur_state.pushes++;
+		if (costed(smode))
+			cur_state.total_cost += push_cost;
+	}
+	else if (str[next] == ' ' || str[next] == '.')
+	{
+		cur_state.moves++;
+		if (costed(smode))
+			cur_state.total_cost += move_cost;
+	}
+	else
+		return false;
+	str[player] = (str[player] == '+') ? '.' : ' ';
+	str[next] = (str[next] == '.') ? '+' : '@';
+	player = next;
+	cur_state.move_list.push_back(move_char[dir]);
+	cur_state.move_list.append(", ");
+	return true;
+} //bool macro_step(const LevelAnalysis &la, const CostModel &costs, State &cur_state, int &player, const int dir, const int smode)
+
+/* Function used to make one player step on a BoardState, pushing a box
+ *  if there is one in the way, for macro moves.  Same rules as
+ *  gen_valid_states, but the depth is left alone, since a macro move is a
+ *  single node.
+ * 
+ * Preconditions: Kernel of the level, Successor object, direction, int
+ *  representing search algo
+ * Postconditions: returns true and updates the state if the step is
+ *  valid, with path, counts and total cost updated
+ */
+template <class B>
+bool macro_step(const Kernel<B> &kernel, Successor<B> &node, const int dir, const int smode)
+{
+	const char move_char[4] = {'u', 'r', 'd', 'l'};
+	int move_cost, push_cost;
+	int next = Kernel<B>::step(node.state.player, dir);
+	if (kernel.walls.test(next))
+		return false;
+
+	cost_model(kernel.options.costs, smode, move_cost, push_cost);
+	if (node.state.boxes.test(next))
+	{
+		int beyond = Kernel<B>::step(next, dir);
+		if (kernel.walls.test(beyond) || node.state.boxes.test(beyond))
+			return false;
+		node.state.boxes.reset(next);
+		node.state.boxes.set(beyond);
+		node.pushes++;
+		if (costed(smode))
+			node.total_cost += push_cost;
+	}
+	else
+	{
+		node.moves++;
+		if (costed(smode))
+			node.total_cost += move_cost;
+	}
+	node.state.player = next;
+	node.path.push_back(move_char[dir]);
+	return true;
+} //bool macro_step(const Kernel<B> &kernel, Successor<B> &node, const int dir, const int smode)
+
+/* Function used to find the moves that take a box from the goal room
+ *  entrance to a goal in the room.  A breadth first search over box and
+ *  player positions is used, with the player kept inside the room and
+ *  other boxes in the room treated as walls.  Positions are numbered by
+ *  the floor cells of the kernel.
+ * 
+ * Preconditions: Kernel of the level, BoardState, cell of the box, cell
+ *  of the goal to reach
+ * Postconditions: returns the directions of the moves, or an empty vector
+ *  if the goal can not be reached
+ */
+template <class B>
+std::vector<int> room_push_path(const Kernel<B> &kernel, const BoardState<B> &state,
+ const int box, const int goal)
+{
+	const CellMap &cells = kernel.cells;
+	std::vector<int> used, local(cells.grid.size(), -1), path;
+	int player = cells.dense[state.player];
+
+	//cells used are the room, its entrance and where the player stands
+	for (std::vector<int>::size_type i = 0; i < cells.grid.size(); i++)
+	{
+		int cell = cells.grid[i];
+		if ((kernel.room.test(cell) && !state.boxes.test(cell)) || cell == box || cell == state.player)
+		{
+			local[i] = used.size();
+			used.push_back(i);
+		}
+	}
+	int n = used.size();
+	std::vector<int> parent(n * n, -1), parent_dir(n * n, -1);
+	std::deque<int> frontier;
+	int start = local[cells.dense[box]] * n + local[player];
+	parent[start] = start;
+	frontier.push_back(start);
+	while (!frontier.empty())
+	{
+		int node = frontier.front();
+		frontier.pop_front();
+		int b = used[node / n], p = used[node % n];
+		if (cells.grid[b] == goal)
+		{
+			for (; node != start; node = parent[node])
+				path.push_back(parent_dir[node]);
+			std::reverse(path.begin(), path.end());
+			break;
+		}
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next_p = cells.neighbor[4 * p + dir], next_b = b;
+			if (next_p < 0 || local[next_p] < 0)
+				continue;
+			if (next_p == b)
+			{
+				next_b = cells.neighbor[4 * b + dir];
+				if (next_b < 0 || local[next_b] < 0 || next_b == player)
+					continue;
+			}
+			int next = local[next_b] * n + local[next_p];
+			if (parent[next] >= 0)
+				continue;
+			parent[next] = node;
+			parent_dir[next] = dir;
+			frontier.push_back(next);
+		}
+	}
+	return path;
+} //std::vector<int> room_push_path(const Kernel<B> &kernel, const BoardState<B> &state, const int box, const int goal)
+
+/* Function used to turn a push into a macro move.  If the push moved a box
+ *  into a tunnel, the box is pushed on until it leaves the tunnel, reaches
+ *  a goal, or is blocked.  If the push moved a box onto the goal room
+ *  entrance, towards the room, the box is taken to the deepest empty goal
+ *  of the room it can reach.  Both count as a single node.
+ * 
+ * Preconditions: Kernel of the level, Successor object made by a push,
+ *  direction of the push, int representing search algo, int reference to
+ *  store the cell of the box in
+ * Postconditions: returns true if the state was extended into a macro
+ *  move, box holds the cell the box pushed ended on either way
+ */
+template <class B>
+bool apply_macro(const Kernel<B> &kernel, Successor<B> &node, const int dir, const int smode,
+ int &box)
+{
+	bool extended = false;
+	box = Kernel<B>::step(node.state.player, dir);
+
+	//goal room macro, entering the room from its entrance
+	if (box == kernel.entrance && kernel.room.test(Kernel<B>::step(box, dir)))
+	{
+		for (std::vector<int>::size_type i = 0; i < kernel.packing_order.size(); i++)
+		{
+			int goal = kernel.packing_order[i];
+			if (node.state.boxes.test(goal) || node.state.player == goal)
+				continue;
+			std::vector<int> path = room_push_path(kernel, node.state, box, goal);
+			if (path.empty())
+				continue;
+			for (std::vector<int>::size_type j = 0; j < path.size(); j++)
+				macro_step(kernel, node, path[j], smode);
+			box = goal;
+			return true;
+		}
+		return false;
+	}
+
+	//tunnel macro, push on while the box is in a tunnel and not on a goal
+	const Bitboard<B> &tunnel = (dir == 1 || dir == 3) ? kernel.tunnel_ew : kernel.tunnel_ns;
+	while (tunnel.test(box) && node.state.boxes.test(box) && !kernel.goals.test(box))
+	{
+		if (!macro_step(kernel, node, dir, smode))
+			break;
+		box = Kernel<B>::step(node.state.player, dir);
+		extended = true;
+	}
+	return extended;
+} //bool apply_macro(const Kernel<B> &kernel, Successor<B> &node, const int dir, const int smode, int &box)
+
+/* Function used to turn a move list such as "u, r, d, " into the compact
+ *  form stored in the solution cache, such as "urd".
+ * 
+ * Preconditions: move list string from a State object
+ * Postconditions: returns string with one char per move
+ */
+std::string compact_moves(const std::string &move_list)
+{
+	std::string moves;
+	for (std::string::size_type i = 0; i < move_list.size(); i++)
+	{
+		if (move_list[i] == 'u' || move_list[i] == 'r' ||
+		 move_list[i] == 'd' || move_list[i] == 'l')
+			moves.push_back(move_list[i]);
+	}
+	return moves;
+} //std::string compact_moves(const std::string &move_list)
+
+/* Function is used to generate all valid states from current state
+ * A valid level is assumed.  Meaning only 1 player agent, and 1 goal
+ *  for each box, with at least 1 goal and 1 box.
+ * Called in search algorithm functions.  States are generated in the
+ *  order up, right, down, left.
+ *
+ * smode cases:
+ *  NONE - totalcost of moves are ignored in bfs/dfs
+ *  UCS - totalcost of moves are calculated
+ *  GBFSH1 - totalcost of moves ignored, heuristics function 1 used
+ *  GBFSH2 - totalcost of moves ignored, heuristics function 2 used
+ *  ASH1 - totalcost of moves calculated, heuristics function 1 used with totalcost
+ *  ASH2 - totalcost of moves calculated, heuristics function 2 used with totalcost
+ *  ARA - totalcost of moves calculated, heuristics left to the search
+ *
+ * With a DeadlockTable in the options, a push is dropped if the boxes
+ *  near the box pushed are a dead pattern once any macro move it starts
+ *  is made, see learned_deadlock.
+ *
+ * Preconditions: Kernel of the level, Successor object representing
+ *  current state in the agent, int representing what searching algorithm
+ *  used, vector to store the new states in
+ * Postconditions: vector holds all possible states from the current state
+ */
+template <class B>
+bool learned_deadlock(const Kernel<B> &kernel, const BoardState<B> &state, const int box);
+
+template <class B>
+void gen_valid_states(const Kernel<B> &kernel, const Successor<B> &cur_state,
+ const int smode, std::vector< Successor<B> > &valid_moves)
+{
+	const char move_char[4] = {'u', 'r', 'd', 'l'};
+	int move_cost, push_cost;
+
+	cost_model(kernel.options.costs, smode, move_cost, push_cost);
+	valid_moves.clear();
+	for (int dir = 0; dir < 4; dir++)
+	{
+		int next = Kernel<B>::step(cur_state.state.player, dir);
+		//move to wall
+		if (kernel.walls.test(next))
+			continue;
+
+		valid_moves.push_back(cur_state);
+		Successor<B> &new_state = valid_moves.back();
+		bool push = new_state.state.boxes.test(next);
+		if (push)
+		{
+			//box can only be pushed onto floor or an empty goal
+			int beyond = Kernel<B>::step(next, dir);
+			if (kernel.walls.test(beyond) || new_state.state.boxes.test(beyond))
+			{
+				valid_moves.pop_back();
+				continue;
+			}
+			new_state.state.boxes.reset(next);
+			new_state.state.boxes.set(beyond);
+			new_state.pushes++;
+			if (costed(smode))
+				new_state.total_cost += push_cost;
+		}
+		else
+		{
+			new_state.moves++;
+			if (costed(smode))
+				new_state.total_cost += move_cost;
+		}
+		new_state.state.player = next;
+		new_state.depth++;
+		new_state.path.assign(1, move_char[dir]);
+
+		//pushes into tunnels and goal rooms are extended into macro moves,
+		//and box is the cell the box pushed ends on
+		int box = Kernel<B>::step(next, dir);
+		if (push && kernel.options.macro_moves)
+			apply_macro(kernel, new_state, dir, smode, box);
+
+		//pushes leaving a dead pattern of boxes are dropped
+		if (push && kernel.options.deadlocks && learned_deadlock(kernel, new_state.state, box))
+		{
+			valid_moves.pop_back();
+			continue;
+		}
+
+		if (smode == GBFSH1 || smode == ASH1)
+			new_state.hscore = h1(kernel, new_state.state);
+		if (smode == GBFSH2 || smode == ASH2)
+			new_state.hscore = h2(kernel, new_state.state);
+		if (smode == ASH1 || smode == ASH2)
+			new_state.hscore += new_state.total_cost;
+		//the pattern database is not consistent, so a child keeps what is
+		//left of the score of its parent (pathmax)
+		if (smode == ARA)
+			new_state.hscore = std::max(h3(kernel, new_state.state, push_cost),
+			 cur_state.hscore - (new_state.total_cost - cur_state.total_cost));
+
+		//symmetric levels compare states by their symmetry keys
+		if (kernel.keyed())
+			kernel.set_key(new_state);
+	}
+} //void gen_valid_states(const Kernel<B> &kernel, const Successor<B> &cur_state, const int smode, std::vector< Successor<B> > &valid_moves)
+
+/* Function used to find the cells the player can walk to without pushing
+ *  a box.  The region starts at the player and is grown by one cell in
+ *  every direction at a time, kept to cells holding no wall and no box,
+ *  until it stops growing.  Each step works on whole bitboard words, so a
+ *  board is dilated 64 cells at a time, or 256 with the AVX2 bit kernels.
+ * 
+ * Preconditions: Kernel of the level, BoardState object, Bitboard to store
+ *  the region in
+ * Postconditions: region holds the cells reachable by the player
+ */
+template <class B>
+void reachable(const Kernel<B> &kernel, const BoardState<B> &state, Bitboard<B> &region)
+{
+	uint64_t buf[2][B::WORDS + 2 * B::GUARD];
+	uint64_t open[B::WORDS];
+	int cur = 0;
+
+	for (int i = 0; i < B::WORDS; i++)
+		open[i] = ~(kernel.walls.word[i] | state.boxes.word[i]);
+	if (B::WORDS == 1)
+	{
+		uint64_t reach = (uint64_t)1 << state.player, prev;
+		do
+		{
+			prev = reach;
+			reach |= (reach << 1) | (reach >> 1) | (reach << B::WIDTH) | (reach >> B::WIDTH);
+			reach &= open[0];
+		} while (reach != prev);
+		region.word[0] = reach;
+		return;
+	}
+	memset(buf, 0, sizeof(buf));
+	buf[0][B::GUARD + (state.player >> 6)] = (uint64_t)1 << (state.player & 63);
+	//boards narrower than a vector are dilated inline
+	while (B::WORDS < 4 ?
+	 scalar_dilate(buf[cur] + B::GUARD, open, buf[1 - cur] + B::GUARD, B::WORDS, B::WIDTH) :
+	 bit_kernels.dilate(buf[cur] + B::GUARD, open, buf[1 - cur] + B::GUARD, B::WORDS, B::WIDTH))
+		cur = 1 - cur;
+	memcpy(region.word, buf[1 - cur] + B::GUARD, sizeof(region.word));
+} //void reachable(const Kernel<B> &kernel, const BoardState<B> &state, Bitboard<B> &region)
+
+/* Function used to find the cells the player can walk to the plain way, a
+ *  breadth first search over cells.  Used to check and time reachable.
+ * 
+ * Preconditions: Kernel of the level, BoardState object, Bitboard to store
+ *  the region in
+ * Postconditions: region holds the cells reachable by the player
+ */
+template <class B>
+void reachable_bfs(const Kernel<B> &kernel, const BoardState<B> &state, Bitboard<B> &region)
+{
+	int frontier[B::CELLS];
+	int head = 0, tail = 0;
+
+	region.clear();
+	region.set(state.player);
+	frontier[tail++] = state.player;
+	while (head < tail)
+	{
+		int cell = frontier[head++];
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next = Kernel<B>::step(cell, dir);
+			if (region.test(next) || kernel.walls.test(next) || state.boxes.test(next))
+				continue;
+			region.set(next);
+			frontier[tail++] = next;
+		}
+	}
+} //void reachable_bfs(const Kernel<B> &kernel, const BoardState<B> &state, Bitboard<B> &region)
+
+//boxes in a deadlock pattern, and sub-states its search may visit
+const int PATTERN_BOXES = 4;
+const std::set<std::string>::size_type PATTERN_NODES = 2000;
+
+DeadlockTable::DeadlockTable(const int slot_bits) : count(0)
+{
+	mask = ((uint64_t)1 << slot_bits) - 1;
+	slots = new uint64_t[mask + 1];
+	memset((void *)slots, 0, (mask + 1) * sizeof(uint64_t));
+}
+
+DeadlockTable::~DeadlockTable()
+{
+	delete [] slots;
+}
+
+/* Function used to look up a pattern.  Slots are only ever set once, from
+ *  0 to an entry, so a reader sees either nothing or a whole entry.  The
+ *  low bit of an entry is its verdict, and bit 1 is set so no entry is 0.
+ *
+ * Preconditions: fingerprint of the pattern
+ * Postconditions: returns DEAD, ALIVE, or UNKNOWN if it is not held
+ */
+int DeadlockTable::find(const uint64_t key) const
+{
+	uint64_t entry = key | 2;
+	for (int probe = 0; probe < PROBES; probe++)
+	{
+		uint64_t cur = slots[((key >> 2) + probe) & mask];
+		if (cur == 0)
+			return UNKNOWN;
+		if ((cur | 1) == (entry | 1))
+			return (cur & 1) ? DEAD : ALIVE;
+	}
+	return UNKNOWN;
+} //int DeadlockTable::find(const uint64_t key) const
+
+/* Function used to add a proven pattern.  An empty slot is claimed with
+ *  compare and swap, and a thread that loses the race to another one
+ *  adding the same pattern finds its entry in the slot and stops.
+ *
+ * Preconditions: fingerprint of the pattern, true if it is dead
+ * Postconditions: pattern held, unless its probe slots are all taken
+ */
+void DeadlockTable::add(const uint64_t key, const bool dead)
+{
+	uint64_t entry = ((key | 2) & ~(uint64_t)1) | (dead ? 1 : 0);
+	for (int probe = 0; probe < PROBES; probe++)
+	{
+		volatile uint64_t *slot = &slots[((key >> 2) + probe) & mask];
+		uint64_t cur = *slot;
+		if (cur == 0)
+		{
+			if (__sync_bool_compare_and_swap(slot, (uint64_t)0, entry))
+			{
+				__sync_fetch_and_add(&count, 1);
+				return;
+			}
+			cur = *slot;
+		}
+		if ((cur | 1) == (entry | 1))
+			return;
+	}
+} //void DeadlockTable::add(const uint64_t key, const bool dead)
+
+/* Function used to move the player of a state to the first cell of its
+ *  region, so states differing only in where the player stands in it are
+ *  the same.
+ *
+ * Preconditions: Kernel of the level, BoardState object
+ * Postconditions: player of the state moved
+ */
+template <class B>
+void normalize_player(const Kernel<B> &kernel, BoardState<B> &state)
+{
+	Bitboard<B> region;
+	reachable(kernel, state, region);
+	for (int w = 0; w < B::WORDS; w++)
+		if (region.word[w])
+		{
+			state.player = w * 64 + __builtin_ctzll(region.word[w]);
+			return;
+		}
+} //void normalize_player(const Kernel<B> &kernel, BoardState<B> &state)
+
+/* Function used to prove a pattern of boxes dead or alive by a breadth
+ *  first search of pushes of only those boxes, the rest of the boxes
+ *  taken off the board.  Taking boxes off only makes a level easier, so
+ *  if the boxes of the pattern cannot all be pushed onto goals, the state
+ *  they came from cannot be solved either.  Pushes onto dead squares are
+ *  not made, and the search gives up after PATTERN_NODES sub-states.
+ *
+ * Preconditions: Kernel of the level, BoardState holding only the boxes
+ *  of the pattern, with the player normalized
+ * Postconditions: returns DEAD, ALIVE, or UNKNOWN if it gave up
+ */
+template <class B>
+int prove_pattern(const Kernel<B> &kernel, const BoardState<B> &start)
+{
+	std::deque< BoardState<B> > open(1, start);
+	std::set<std::string> seen;
+	Bitboard<B> region;
+
+	seen.insert(std::string((const char *)&start, sizeof(start)));
+	while (!open.empty())
+	{
+		BoardState<B> cur = open.front();
+		open.pop_front();
+		if (kernel.is_goal(cur))
+			return DeadlockTable::ALIVE;
+		reachable(kernel, cur, region);
+		for (int w = 0; w < B::WORDS; w++)
+			for (uint64_t bits = cur.boxes.word[w]; bits; bits &= bits - 1)
+			{
+				int box = w * 64 + __builtin_ctzll(bits);
+				for (int dir = 0; dir < 4; dir++)
+				{
+					//player behind the box, floor in front of it
+					int behind = Kernel<B>::step(box, (dir + 2) % 4), ahead = Kernel<B>::step(box, dir);
+					if (!region.test(behind) || kernel.walls.test(ahead) ||
+					 cur.boxes.test(ahead) || kernel.unsafe.test(ahead))
+						continue;
+					BoardState<B> next = cur;
+					next.boxes.reset(box);
+					next.boxes.set(ahead);
+					next.player = box;
+					normalize_player(kernel, next);
+					if (seen.insert(std::string((const char *)&next, sizeof(next))).second)
+						open.push_back(next);
+				}
+			}
+		if (seen.size() > PATTERN_NODES)
+			return DeadlockTable::UNKNOWN;
+	}
+	return DeadlockTable::DEAD;
+} //int prove_pattern(const Kernel<B> &kernel, const BoardState<B> &start)
+
+/* Function used to check if a push left a dead pattern of boxes.  The
+ *  pattern is the box pushed and up to PATTERN_BOXES - 1 of the boxes
+ *  nearest it, within 2 cells, with the region the player has among only
+ *  those boxes.  It is looked up in the DeadlockTable of the options, and
+ *  if it is not there yet, proven by prove_pattern and added.  A box
+ *  pushed onto a dead square is dead without a lookup.
+ *
+ * Preconditions: Kernel of the level, BoardState after the push, cell of
+ *  the box pushed
+ * Postconditions: returns true if the state cannot be solved
+ */
+template <class B>
+bool learned_deadlock(const Kernel<B> &kernel, const BoardState<B> &state, const int box)
+{
+	if (kernel.unsafe.test(box))
+	{
+		kernel.deadlocks_pruned++;
+		return true;
+	}
+
+	//nearest boxes first, the pushed box at distance 0
+	std::vector< std::pair<int, int> > near;
+	int bx = box % B::WIDTH, by = box / B::WIDTH;
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = state.boxes.word[w]; bits; bits &= bits - 1)
+		{
+			int cell = w * 64 + __builtin_ctzll(bits);
+			int d = std::max(std::abs(cell % B::WIDTH - bx), std::abs(cell / B::WIDTH - by));
+			if (d <= 2)
+				near.push_back(std::make_pair(d, cell));
+		}
+	std::sort(near.begin(), near.end());
+	if ((int)near.size() > PATTERN_BOXES)
+		near.resize(PATTERN_BOXES);
+
+	BoardState<B> pattern;
+	pattern.boxes.clear();
+	pattern.player = state.player;
+	pattern.pad = 0;
+	for (std::vector< std::pair<int, int> >::size_type i = 0; i < near.size(); i++)
+		pattern.boxes.set(near[i].second);
+	//a pattern already on goals is never dead
+	if (kernel.is_goal(pattern))
+		return false;
+	normalize_player(kernel, pattern);
+
+	uint64_t key = kernel.level_hash;
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = pattern.boxes.word[w]; bits; bits &= bits - 1)
+			key = (key ^ (w * 64 + __builtin_ctzll(bits))) * 0x9E3779B97F4A7C15ULL;
+	key = (key ^ (pattern.player + 0x10000)) * 0x9E3779B97F4A7C15ULL;
+	key ^= key >> 29;
+
+	int verdict = kernel.options.deadlocks->find(key);
+	if (verdict == DeadlockTable::UNKNOWN)
+	{
+		verdict = prove_pattern(kernel, pattern);
+		if (verdict != DeadlockTable::UNKNOWN)
+			kernel.options.deadlocks->add(key, verdict == DeadlockTable::DEAD);
+		if (verdict == DeadlockTable::DEAD)
+			kernel.deadlocks_learned++;
+	}
+	if (verdict != DeadlockTable::DEAD)
+		return false;
+	kernel.deadlocks_pruned++;
+	return true;
+} //bool learned_deadlock(const Kernel<B> &kernel, const BoardState<B> &state, const int box)
+
+/* Table file layout, for pattern databases and state tables.  The file
+ *  is a TableHeader followed by the table, one entry per set of boxes or
+ *  state, in rank order.  Files are named by the hash of the level and
+ *  the boxes of an entry, so any level with the same walls and goals uses
+ *  the same file.
+ */
+const char PATTERN_MAGIC[8] = {'S', 'K', 'B', 'P', 'A', 'T', 'D', 'B'};
+const char TABLE_MAGIC[8] = {'S', 'K', 'B', 'S', 'T', 'A', 'T', 'E'};
+const uint32_t PATTERN_VERSION = 1;
+//largest table built, sets of boxes times player cells searched
+const uint64_t PATTERN_MAX_STATES = (uint64_t)1 << 28;
+
+struct TableHeader
+{
+	char magic[8];
+	uint32_t version;
+	int32_t floor;
+	int32_t boxes;
+	int32_t pad;
+	uint64_t level_hash;
+	uint64_t entries;
+}; //struct TableHeader
+
+/* Function used to fill in the header of a table file.
+ *
+ * Preconditions: magic of the file, floor cells and boxes of the level,
+ *  hash of the level, entries of the table
+ * Postconditions: returns the header, padding zeroed so headers compare
+ */
+TableHeader table_header(const char *magic, const int floor, const int boxes,
+ const uint64_t level_hash, const uint64_t entries)
+{
+	TableHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(header.magic));
+	header.version = PATTERN_VERSION;
+	header.floor = floor;
+	header.boxes = boxes;
+	header.level_hash = level_hash;
+	header.entries = entries;
+	return header;
+} //TableHeader table_header(const char *magic, const int floor, const int boxes, const uint64_t level_hash, const uint64_t entries)
+
+/* Function used to map a table file read only.
+ *
+ * Preconditions: path of the file, header it must start with, bytes of
+ *  the table after the header, pointer and size to store the mapping in
+ * Postconditions: returns true if the file holds the table and is mapped
+ */
+bool map_table(const std::string &path, const TableHeader &expect, const uint64_t bytes,
+ void *&map, size_t &map_size)
+{
+	struct stat st;
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	size_t size = sizeof(TableHeader) + bytes;
+	if (fstat(fd, &st) != 0 || st.st_size != (off_t)size)
+	{
+		close(fd);
+		return false;
+	}
+	void *mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED)
+		return false;
+	if (memcmp(mapped, &expect, sizeof(expect)) != 0)
+	{
+		munmap(mapped, size);
+		return false;
+	}
+	map = mapped;
+	map_size = size;
+	return true;
+} //bool map_table(const std::string &path, const TableHeader &expect, const uint64_t bytes, void *&map, size_t &map_size)
+
+/* Function used to store a built table.  It is written to a temporary
+ *  file first and renamed, so another process never maps a file half
+ *  written.
+ *
+ * Preconditions: path of the file, its header, the table and its bytes
+ * Postconditions: returns true if the file was written
+ */
+bool write_table(const std::string &path, const TableHeader &header, const void *table,
+ const uint64_t bytes)
+{
+	std::string temp = path + ".XXXXXX";
+	std::vector<char> name(temp.begin(), temp.end());
+	name.push_back('\0');
+	int fd = mkstemp(&name[0]);
+	if (fd < 0)
+		return false;
+	//readable by the other users of a shared pattern directory
+	fchmod(fd, 0644);
+	bool written = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+	 write(fd, table, bytes) == (ssize_t)bytes;
+	close(fd);
+	if (!written || rename(&name[0], path.c_str()) != 0)
+	{
+		unlink(&name[0]);
+		return false;
+	}
+	return true;
+} //bool write_table(const std::string &path, const TableHeader &header, const void *table, const uint64_t bytes)
+
+/* Function used to release a pattern database.
+ *
+ * Preconditions: PatternDb object
+ * Postconditions: mapping and table released
+ */
+void close_patterns(PatternDb &db)
+{
+	if (db.map != NULL)
+		munmap(db.map, db.map_size);
+	db.map = NULL;
+	db.value = NULL;
+	db.built.clear();
+} //void close_patterns(PatternDb &db)
+
+/* Function used to map the file of a pattern database read only.
+ *
+ * Preconditions: PatternDb with its level, boxes and floor set, path of
+ *  the file
+ * Postconditions: returns true if the file holds the table and is mapped
+ */
+bool map_patterns(PatternDb &db, const std::string &path)
+{
+	if (!map_table(path, table_header(PATTERN_MAGIC, db.floor, db.boxes, db.level_hash, db.entries),
+	 db.entries, db.map, db.map_size))
+		return false;
+	db.value = (const uint8_t *)db.map + sizeof(TableHeader);
+	return true;
+} //bool map_patterns(PatternDb &db, const std::string &path)
+
+/* Function used to store a built pattern database.
+ *
+ * Preconditions: built PatternDb, path of the file
+ * Postconditions: returns true if the file was written
+ */
+bool write_patterns(const PatternDb &db, const std::string &path)
+{
+	return write_table(path, table_header(PATTERN_MAGIC, db.floor, db.boxes, db.level_hash,
+	 db.entries), &db.built[0], db.entries);
+} //bool write_patterns(const PatternDb &db, const std::string &path)
+
+/* Function used to build a pattern database by retrograde breadth first
+ *  search.  It starts from every set of db.boxes goals with a box on each,
+ *  and the player in each region of the floor around them, and pulls the
+ *  boxes, which are pushes played backward, with no other box on the
+ *  board.  The first time a set of boxes is reached, its pulls are the
+ *  fewest pushes that put it on goals.  The player cell only takes part
+ *  in the search: the table has one entry per set of boxes, the fewest
+ *  pushes from wherever the player stands.  Sets never reached can not be
+ *  solved and stay PATTERN_DEAD.  Counts above 254 are kept at 254.
+ *
+ * Preconditions: Kernel of the level, PatternDb with its level, boxes,
+ *  floor and choose set, string to store an error in
+ * Postconditions: returns true with db.built filled in, or false with
+ *  error set if the table is too large
+ */
+template <class B>
+bool build_patterns(const Kernel<B> &kernel, PatternDb &db, std::string &error)
+{
+	const int k = db.boxes, floor = db.floor;
+	if (db.entries * floor > PATTERN_MAX_STATES)
+	{
+		error = "pattern database too large for this level";
+		return false;
+	}
+	db.built.assign(db.entries, PATTERN_DEAD);
+	std::vector<bool> seen(db.entries * floor, false);
+	//states of a layer, k floor cell numbers and the player cell each
+	std::vector<int> layer, next;
+	std::vector<int> goal_cells;
+	BoardState<B> state;
+	Bitboard<B> region;
+	int cells[3];
+
+	for (int i = 0; i < floor; i++)
+		if (kernel.goals.test(kernel.cells.grid[i]))
+			goal_cells.push_back(i);
+	if ((int)goal_cells.size() < k)
+		return true;
+
+	//every set of k goals, with the player in each region around them
+	int pick[3];
+	for (int i = 0; i < k; i++)
+		pick[i] = i;
+	while (true)
+	{
+		state.boxes.clear();
+		state.pad = 0;
+		for (int i = 0; i < k; i++)
+		{
+			cells[i] = goal_cells[pick[i]];
+			state.boxes.set(kernel.cells.grid[cells[i]]);
+		}
+		uint64_t rank = pattern_rank(db, cells);
+		db.built[rank] = 0;
+		for (int p = 0; p < floor; p++)
+		{
+			state.player = kernel.cells.grid[p];
+			if (state.boxes.test(state.player))
+				continue;
+			normalize_player(kernel, state);
+			uint64_t index = rank * floor + kernel.cells.dense[state.player];
+			if (seen[index])
+				continue;
+			seen[index] = true;
+			layer.insert(layer.end(), cells, cells + k);
+			layer.push_back(state.player);
+		}
+		int i = k - 1;
+		while (i >= 0 && pick[i] == (int)goal_cells.size() - k + i)
+			i--;
+		if (i < 0)
+			break;
+		pick[i]++;
+		for (int j = i + 1; j < k; j++)
+			pick[j] = pick[j - 1] + 1;
+	}
+
+	for (int pulls = 1; !layer.empty(); pulls++)
+	{
+		next.clear();
+		for (std::vector<int>::size_type s = 0; s < layer.size(); s += k + 1)
+		{
+			state.boxes.clear();
+			for (int i = 0; i < k; i++)
+				state.boxes.set(kernel.cells.grid[layer[s + i]]);
+			state.player = layer[s + k];
+			reachable(kernel, state, region);
+			for (int i = 0; i < k; i++)
+			{
+				int box = kernel.cells.grid[layer[s + i]];
+				for (int dir = 0; dir < 4; dir++)
+				{
+					//player beside the box steps away from it, dragging it
+					int stand = Kernel<B>::step(box, dir), to = Kernel<B>::step(stand, dir);
+					if (!region.test(stand) || kernel.walls.test(to) || state.boxes.test(to))
+						continue;
+					BoardState<B> pulled = state;
+					pulled.boxes.reset(box);
+					pulled.boxes.set(stand);
+					pulled.player = to;
+					normalize_player(kernel, pulled);
+					for (int j = 0; j < k; j++)
+						cells[j] = (j == i) ? kernel.cells.dense[stand] : layer[s + j];
+					std::sort(cells, cells + k);
+					uint64_t rank = pattern_rank(db, cells);
+					uint64_t index = rank * floor + kernel.cells.dense[pulled.player];
+					if (seen[index])
+						continue;
+					seen[index] = true;
+					if (db.built[rank] == PATTERN_DEAD)
+						db.built[rank] = std::min(pulls, 254);
+					next.insert(next.end(), cells, cells + k);
+					next.push_back(pulled.player);
+				}
+			}
+		}
+		layer.swap(next);
+	}
+	return true;
+} //bool build_patterns(const Kernel<B> &kernel, PatternDb &db, std::string &error)
+
+/* Function used to get the pattern database of a level ready.  The one
+ *  already loaded is kept if it is of the same level and set size, then
+ *  the file in options.pattern_dir is mapped if there is one, and
+ *  otherwise the table is built, and stored there if the directory is set.
+ *
+ * Preconditions: Kernel of the level, PatternDb to set up, options of the
+ *  solve, string to store an error in
+ * Postconditions: returns true if db holds the table of the level
+ */
+template <class B>
+bool load_patterns(const Kernel<B> &kernel, PatternDb &db, const SolverOptions &options,
+ std::string &error)
+{
+	const int floor = kernel.cells.grid.size();
+	//sets larger than the goals of the level could never be solved
+	int goals = 0;
+	for (int i = 0; i < floor; i++)
+		goals += kernel.goals.test(kernel.cells.grid[i]);
+	const int k = std::min(options.pattern_boxes, goals);
+	if (db.value != NULL && db.level_hash == kernel.level_hash && db.boxes == k && db.floor == floor)
+		return true;
+	close_patterns(db);
+	if (k < 1 || k > 3)
+	{
+		error = "pattern database sets must be of 1 to 3 boxes";
+		return false;
+	}
+	db.level_hash = kernel.level_hash;
+	db.boxes = k;
+	db.floor = floor;
+	db.choose.assign((floor + 1) * (k + 1), 0);
+	for (int n = 0; n <= floor; n++)
+	{
+		db.choose[n * (k + 1)] = 1;
+		for (int r = 1; r <= k && r <= n; r++)
+			db.choose[n * (k + 1) + r] = db.choose[(n - 1) * (k + 1) + r - 1] +
+			 (r <= n - 1 ? db.choose[(n - 1) * (k + 1) + r] : 0);
+	}
+	db.entries = db.choose[floor * (k + 1) + k];
+
+	std::string path;
+	if (options.pattern_dir != NULL)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "/%016llx-%d.pdb", (unsigned long long)db.level_hash, k);
+		path = std::string(options.pattern_dir) + name;
+		if (map_patterns(db, path))
+		{
+			if (options.log)
+				*options.log << "  Pattern database: " << db.entries << " sets of " << k
+					<< " boxes, mapped from " << path << std::endl;
+			return true;
+		}
+	}
+
+	timeval start;
+	gettimeofday(&start, NULL);
+	if (!build_patterns(kernel, db, error))
+	{
+		close_patterns(db);
+		return false;
+	}
+	if (options.log)
+		*options.log << "  Pattern database: " << db.entries << " sets of " << k
+			<< " boxes, built in " << seconds_since(start) << " seconds" << std::endl;
+	//a stored table is used through its mapping, like a loaded one
+	if (!path.empty() && write_patterns(db, path) && map_patterns(db, path))
+		std::vector<uint8_t>().swap(db.built);
+	else
+		db.value = &db.built[0];
+	return true;
+} //bool load_patterns(const Kernel<B> &kernel, PatternDb &db, const SolverOptions &options, std::string &error)
+
+/* StateTable is the state table of a level, for retrograde search.  For
+ *  every state of boxes boxes on the floor cells, ranked by ranks,
+ *  distance holds the fewest moves, pushes included, that put every box
+ *  on a goal, or TABLE_UNSOLVABLE if no moves do.  distance points into
+ *  the mapping of the file of the table, or into built if it was not
+ *  stored.
+ */
+const uint16_t TABLE_UNSOLVABLE = 65535;
+//largest state table built, 2 bytes a state
+const uint64_t TABLE_MAX_STATES = (uint64_t)1 << 26;
+
+struct StateTable
+{
+	uint64_t level_hash;
+	int boxes;
+	int floor;
+	StateRanks ranks;
+	const uint16_t *distance;
+	void *map;
+	size_t map_size;
+	std::vector<uint16_t> built;
+
+	StateTable() : level_hash(0), boxes(0), floor(0), distance(NULL), map(NULL), map_size(0) {}
+}; //struct StateTable
+
+/* Function used to release a state table.
+ *
+ * Preconditions: StateTable object
+ * Postconditions: mapping and table released
+ */
+void close_table(StateTable &table)
+{
+	if (table.map != NULL)
+		munmap(table.map, table.map_size);
+	table.map = NULL;
+	table.distance = NULL;
+	std::vector<uint16_t>().swap(table.built);
+} //void close_table(StateTable &table)
+
+//cell of a set of floor cells packed one bit each
+inline bool packed_test(const std::vector<uint64_t> &packed, const int cell)
+{
+	return packed[cell >> 6] >> (cell & 63) & 1;
+}
+
+inline void packed_flip(std::vector<uint64_t> &packed, const int cell)
+{
+	packed[cell >> 6] ^= (uint64_t)1 << (cell & 63);
+}
+
+/* Function used to build a state table by retrograde breadth first
+ *  search.  It starts from every state with a box on each of table.boxes
+ *  goals and the player on any other floor cell, and plays moves
+ *  backward: the player steps back to a free cell next to it, and drags
+ *  along the box on its other side, if there is one, for a push played
+ *  backward.  The first time a state is reached, the moves played are
+ *  the fewest that solve it.  States never reached can not be solved.
+ *
+ * Preconditions: CellMap and goal floor cells of the level, StateTable
+ *  with its level, boxes, floor and ranks set, string to store an error in
+ * Postconditions: returns true with table.built filled in, or false with
+ *  error set if a solution is too long to store
+ */
+bool build_table(const CellMap &cells, const std::vector<int> &goal_cells, StateTable &table,
+ std::string &error)
+{
+	const int k = table.boxes, floor = table.floor, words = cells.words;
+	std::vector<uint64_t> state(words + 1), prev(words + 1);
+	std::vector<uint32_t> layer, next;
+	std::vector<int> pick(k);
+
+	table.built.assign(table.ranks.states(), TABLE_UNSOLVABLE);
+	if ((int)goal_cells.size() < k)
+		return true;
+
+	//every set of k goals, with the player on each other floor cell
+	for (int i = 0; i < k; i++)
+		pick[i] = i;
+	while (true)
+	{
+		std::fill(state.begin(), state.end(), 0);
+		for (int i = 0; i < k; i++)
+			packed_flip(state, goal_cells[pick[i]]);
+		for (int p = 0; p < floor; p++)
+		{
+			if (packed_test(state, p))
+				continue;
+			state[words] = p;
+			uint64_t rank = table.ranks.rank(&state[0]);
+			table.built[rank] = 0;
+			layer.push_back(rank);
+		}
+		int i = k - 1;
+		while (i >= 0 && pick[i] == (int)goal_cells.size() - k + i)
+			i--;
+		if (i < 0)
+			break;
+		pick[i]++;
+		for (int j = i + 1; j < k; j++)
+			pick[j] = pick[j - 1] + 1;
+	}
+
+	for (uint32_t moves = 1; !layer.empty(); moves++)
+	{
+		if (moves == TABLE_UNSOLVABLE)
+		{
+			error = "state table solutions too long to store";
+			return false;
+		}
+		next.clear();
+		for (std::vector<uint32_t>::size_type s = 0; s < layer.size(); s++)
+		{
+			table.ranks.unrank(layer[s], &state[0]);
+			const int player = state[words];
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int back = cells.neighbor[4 * player + dir];
+				if (back < 0 || packed_test(state, back))
+					continue;
+				int box = cells.neighbor[4 * player + ((dir + 2) & 3)];
+				//the player stepped from back, or pushed the box from here
+				for (int pull = 0; pull < 2; pull++)
+				{
+					if (pull && (box < 0 || !packed_test(state, box)))
+						break;
+					prev = state;
+					prev[words] = back;
+					if (pull)
+					{
+						packed_flip(prev, box);
+						packed_flip(prev, player);
+					}
+					uint64_t rank = table.ranks.rank(&prev[0]);
+					if (table.built[rank] != TABLE_UNSOLVABLE)
+						continue;
+					table.built[rank] = moves;
+					next.push_back(rank);
+				}
+			}
+		}
+		layer.swap(next);
+	}
+	return true;
+} //bool build_table(const CellMap &cells, const std::vector<int> &goal_cells, StateTable &table, std::string &error)
+
+/* Function used to get the state table of a level ready, as
+ *  load_patterns does for the pattern database: the table already loaded
+ *  is kept if it is of the same level and box count, then the file in
+ *  options.pattern_dir is mapped if there is one, and otherwise the table
+ *  is built, and stored there if the directory is set.  A table larger
+ *  than TABLE_MAX_STATES states, or than options.memory_limit, is not
+ *  built.
+ *
+ * Preconditions: Kernel of the level, boxes of the states, StateTable to
+ *  set up, options of the solve, string to store an error in
+ * Postconditions: returns true if table holds the table of the level
+ */
+template <class B>
+bool load_table(const Kernel<B> &kernel, const int boxes, StateTable &table,
+ const SolverOptions &options, std::string &error)
+{
+	const int floor = kernel.cells.grid.size();
+	if (table.distance != NULL && table.level_hash == kernel.level_hash && table.boxes == boxes &&
+	 table.floor == floor)
+		return true;
+	close_table(table);
+	uint64_t limit = TABLE_MAX_STATES;
+	if (options.memory_limit > 0)
+		limit = std::min(limit, (uint64_t)options.memory_limit / sizeof(uint16_t));
+	if (!table.ranks.reset(floor, kernel.cells.words, boxes, limit))
+	{
+		error = "state table too large for this level";
+		return false;
+	}
+	table.level_hash = kernel.level_hash;
+	table.boxes = boxes;
+	table.floor = floor;
+	const uint64_t states = table.ranks.states();
+	const TableHeader header = table_header(TABLE_MAGIC, floor, boxes, table.level_hash, states);
+
+	std::string path;
+	if (options.pattern_dir != NULL)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "/%016llx-%d.skt", (unsigned long long)table.level_hash, boxes);
+		path = std::string(options.pattern_dir) + name;
+		if (map_table(path, header, states * sizeof(uint16_t), table.map, table.map_size))
+		{
+			table.distance = (const uint16_t *)((const char *)table.map + sizeof(TableHeader));
+			if (options.log)
+				*options.log << "  State table: " << states << " states of " << boxes
+					<< " boxes, mapped from " << path << std::endl;
+			return true;
+		}
+	}
+
+	timeval start;
+	gettimeofday(&start, NULL);
+	std::vector<int> goal_cells;
+	for (int i = 0; i < floor; i++)
+		if (kernel.goals.test(kernel.cells.grid[i]))
+			goal_cells.push_back(i);
+	if (!build_table(kernel.cells, goal_cells, table, error))
+	{
+		close_table(table);
+		return false;
+	}
+	if (options.log)
+		*options.log << "  State table: " << states << " states of " << boxes
+			<< " boxes, built in " << seconds_since(start) << " seconds" << std::endl;
+	//a stored table is used through its mapping, like a loaded one
+	if (!path.empty() && write_table(path, header, &table.built[0], states * sizeof(uint16_t)) &&
+	 map_table(path, header, states * sizeof(uint16_t), table.map, table.map_size))
+	{
+		std::vector<uint16_t>().swap(table.built);
+		table.distance = (const uint16_t *)((const char *)table.map + sizeof(TableHeader));
+	}
+	else
+		table.distance = &table.built[0];
+	return true;
+} //bool load_table(const Kernel<B> &kernel, const int boxes, StateTable &table, const SolverOptions &options, std::string &error)
+
+/* Function used to solve a state by the state table of its level, built
+ *  by retrograde search the first time a state of the level is solved
+ *  this way.  Each move taken is one to a state a move closer to the
+ *  goal, so the solution has the fewest moves and takes a few table
+ *  lookups a move, with no search.
+ *
+ * Preconditions: Kernel of the level, State object for initial state of
+ *  level, the StateTable kept by the Solver, string to store an error in
+ * Postconditions: Returns a SearchStat object for search results stats,
+ *  error set if the table could not be built
+ */
+template <class B>
+SearchStat retro(const Kernel<B> &kernel, State &initial_state, StateTable &table,
+ std::string &error)
+{
+	const int words = kernel.cells.words;
+	const char dir_char[] = {'u', 'r', 'd', 'l'};
+	std::vector<uint64_t> state(words + 1, 0), next(words + 1);
+	BoardState<B> board;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 0;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	report.arena_nodes = 0;
+	report.arena_bytes = 0;
+	report.table_states = report.table_bytes = 0;
+
+	kernel.load(initial_state.state_str, board);
+	int boxes = 0;
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = board.boxes.word[w]; bits; bits &= bits - 1, boxes++)
+			packed_flip(state, kernel.cells.dense[w * 64 + __builtin_ctzll(bits)]);
+	state[words] = kernel.cells.dense[board.player];
+	if (!load_table(kernel, boxes, table, kernel.options, error))
+		return report;
+	report.table_states = table.ranks.states();
+	report.table_bytes = report.table_states * sizeof(uint16_t) + table.ranks.bytes();
+
+	uint16_t left = table.distance[table.ranks.rank(&state[0])];
+	report.node_count = 1;
+	if (left == TABLE_UNSOLVABLE)
+		return report;
+	State &goal = report.node;
+	goal.move_list = "";
+	goal.moves = goal.pushes = 0;
+	while (left > 0)
+	{
+		const int player = state[words];
+		int dir;
+		for (dir = 0; dir < 4; dir++)
+		{
+			int to = kernel.cells.neighbor[4 * player + dir];
+			if (to < 0)
+				continue;
+			next = state;
+			next[words] = to;
+			bool push = packed_test(state, to);
+			if (push)
+			{
+				int beyond = kernel.cells.neighbor[4 * to + dir];
+				if (beyond < 0 || packed_test(state, beyond))
+					continue;
+				packed_flip(next, to);
+				packed_flip(next, beyond);
+			}
+			report.node_count++;
+			if (table.distance[table.ranks.rank(&next[0])] != left - 1)
+				continue;
+			state.swap(next);
+			goal.move_list.append(1, dir_char[dir]) += ", ";
+			goal.moves += !push;
+			goal.pushes += push;
+			left--;
+			break;
+		}
+		//only a table file of another level could have no move closer
+		if (dir == 4)
+		{
+			error = "state table does not match the level";
+			return report;
+		}
+	}
+
+	board.boxes.clear();
+	for (int cell = 0; cell < (int)kernel.cells.grid.size(); cell++)
+		if (packed_test(state, cell))
+			board.boxes.set(kernel.cells.grid[cell]);
+	board.player = kernel.cells.grid[state[words]];
+	goal.state_str = kernel.unload(board);
+	//moves count the steps without a push, as in gen_valid_states
+	int move_cost, push_cost;
+	cost_model(kernel.options.costs, RETRO, move_cost, push_cost);
+	goal.depth = goal.moves + goal.pushes;
+	goal.total_cost = goal.moves * move_cost + goal.pushes * push_cost;
+	goal.hscore = 0;
+	report.explored_count = goal.depth + 1;
+	return report;
+} //SearchStat retro(const Kernel<B> &kernel, State &initial_state, StateTable &table, std::string &error)
+
+/* NodeHeader is the fixed part of a search node packed in a NodeArena.
+ *  Nodes refer to their parent by index, and keep only the moves made
+ *  from the parent (more than one for a macro move), stored one char per
+ *  move in the arena's move pool.  The root node is its own parent.
+ */
+struct NodeHeader
+{
+	uint32_t parent;
+	uint32_t move_start;
+	uint32_t move_len;
+	int32_t depth;
+	int32_t moves;
+	int32_t pushes;
+	int32_t total_cost;
+	int32_t hscore;
+}; //struct NodeHeader
+
+/* NodeArena stores the nodes of one search as fixed size records in large
+ *  slabs.  Each record is a NodeHeader followed by the state and, on
+ *  symmetric levels, the symmetry key, packed by the CellMap of the board:
+ *  one bit per floor cell for the boxes and a word for the floor cell of
+ *  the player, so walls and cells outside the level take no room.  Nodes
+ *  are referred to by 32 bit indices and are only freed all at once.
+ *  reset empties the arena for the next search and keeps its slabs, so a
+ *  Solver does not allocate them again.
+ */
+class NodeArena
+{
+public:
+	NodeArena();
+	~NodeArena();
+	void reset(const CellMap &cells, const bool keyed);
+	template <class B> uint32_t add(const Successor<B> &cur_state, const uint32_t parent);
+	NodeHeader *header(const uint32_t index) const;
+	template <class B> bool matches(const uint32_t index, const Successor<B> &cur_state) const;
+	template <class B> void pack_key(const Successor<B> &cur_state, uint64_t *packed) const;
+	bool matches(const uint32_t index, const uint64_t *packed) const;
+	template <class B> void load(const uint32_t index, Successor<B> &cur_state) const;
+	template <class B> void pack(const BoardState<B> &state, uint64_t *packed) const;
+	template <class B> void unpack(const uint64_t *packed, BoardState<B> &state) const;
+	std::string move_list(const uint32_t index) const;
+	uint32_t size() const { return node_count; }
+	long bytes() const;
+	long slabs() const { return node_slabs.size() + move_slabs.size(); }
+
+private:
+	static const uint32_t NODES_PER_SLAB = 4096;
+	static const uint32_t MOVE_SLAB_SIZE = 65536;
+	std::string::size_type state_len;
+	std::string::size_type key_len;
+	std::string::size_type node_size;
+	uint32_t node_count;
+	uint32_t move_used;
+	const CellMap *cells;
+	std::vector<char *> node_slabs;
+	std::vector<char *> move_slabs;
+
+	char *record(const uint32_t index) const;
+	NodeArena(const NodeArena &);
+	NodeArena &operator=(const NodeArena &);
+}; //class NodeArena
+
+NodeArena::NodeArena()
+ : state_len(0), key_len(0), node_size(sizeof(NodeHeader)), node_count(0), move_used(0), cells(NULL)
+{
+}
+
+NodeArena::~NodeArena()
+{
+	for (std::vector<char *>::size_type i = 0; i < node_slabs.size(); i++)
+		delete [] node_slabs[i];
+	for (std::vector<char *>::size_type i = 0; i < move_slabs.size(); i++)
+		delete [] move_slabs[i];
+}
+
+/* Function used to empty the arena for a new search.  The slabs are kept
+ *  unless the records of the new search are a different size.
+ *
+ * Preconditions: CellMap of the board, which must outlive the search, true
+ *  if nodes keep a symmetry key
+ * Postconditions: arena holds no nodes
+ */
+void NodeArena::reset(const CellMap &cells, const bool keyed)
+{
+	std::string::size_type state_len = (cells.words + 1) * 8, key_len = keyed ? state_len : 0;
+	//records rounded up to keep headers aligned
+	std::string::size_type new_size = (sizeof(NodeHeader) + state_len + key_len + 7) &
+	 ~(std::string::size_type)7;
+	if (new_size != node_size)
+	{
+		for (std::vector<char *>::size_type i = 0; i < node_slabs.size(); i++)
+			delete [] node_slabs[i];
+		node_slabs.clear();
+	}
+	this->state_len = state_len;
+	this->key_len = key_len;
+	this->cells = &cells;
+	node_size = new_size;
+	node_count = 0;
+	move_used = 0;
+} //void NodeArena::reset(const CellMap &cells, const bool keyed)
+
+char *NodeArena::record(const uint32_t index) const
+{
+	return node_slabs[index / NODES_PER_SLAB] + (index % NODES_PER_SLAB) * node_size;
+}
+
+NodeHeader *NodeArena::header(const uint32_t index) const
+{
+	return (NodeHeader *)record(index);
+}
+
+/* Function used to pack a state by floor cell number, the boxes one bit
+ *  per floor cell and then the player.  Distributed search sends states
+ *  between its processes packed this way.
+ *
+ * Preconditions: BoardState object, cells->words + 1 words to pack into
+ * Postconditions: packed holds the state
+ */
+template <class B>
+void NodeArena::pack(const BoardState<B> &state, uint64_t *packed) const
+{
+	memset(packed, 0, state_len);
+	for (int w = 0; w < B::WORDS; w++)
+		for (uint64_t bits = state.boxes.word[w]; bits; bits &= bits - 1)
+		{
+			int i = cells->dense[w * 64 + __builtin_ctzll(bits)];
+			packed[i >> 6] |= (uint64_t)1 << (i & 63);
+		}
+	packed[cells->words] = cells->dense[state.player];
+}
+
+template <class B>
+void NodeArena::unpack(const uint64_t *packed, BoardState<B> &state) const
+{
+	state.boxes.clear();
+	for (int w = 0; w < cells->words; w++)
+		for (uint64_t bits = packed[w]; bits; bits &= bits - 1)
+			state.boxes.set(cells->grid[w * 64 + __builtin_ctzll(bits)]);
+	state.player = cells->grid[packed[cells->words]];
+	state.pad = 0;
+}
+
+/* Function used to pack a state into the arena.  Its path is only the
+ *  moves made from the parent, as made by gen_valid_states.
+ * 
+ * Preconditions: Successor object, index of the parent node, or the index
+ *  the node will get if it is the root
+ * Postconditions: returns the index of the new node
+ */
+template <class B>
+uint32_t NodeArena::add(const Successor<B> &cur_state, const uint32_t parent)
+{
+	const std::string &moves = cur_state.path;
+	//slabs kept from an earlier search are filled before new ones are made
+	if (node_count / NODES_PER_SLAB == node_slabs.size())
+		node_slabs.push_back(new char[NODES_PER_SLAB * node_size]);
+	//a move string never crosses into the next slab
+	if ((move_used % MOVE_SLAB_SIZE) + moves.size() > MOVE_SLAB_SIZE)
+		move_used = (move_used / MOVE_SLAB_SIZE + 1) * MOVE_SLAB_SIZE;
+	if (move_used / MOVE_SLAB_SIZE == move_slabs.size())
+		move_slabs.push_back(new char[MOVE_SLAB_SIZE]);
+	memcpy(move_slabs[move_used / MOVE_SLAB_SIZE] + (move_used % MOVE_SLAB_SIZE), moves.data(),
+	 moves.size());
+
+	char *rec = record(node_count);
+	NodeHeader *head = (NodeHeader *)rec;
+	head->parent = parent;
+	head->move_start = move_used;
+	head->move_len = moves.size();
+	head->depth = cur_state.depth;
+	head->moves = cur_state.moves;
+	head->pushes = cur_state.pushes;
+	head->total_cost = cur_state.total_cost;
+	head->hscore = cur_state.hscore;
+	uint64_t packed[B::WORDS + 1];
+	pack(cur_state.state, packed);
+	memcpy(rec + sizeof(NodeHeader), packed, state_len);
+	if (key_len > 0)
+	{
+		pack(cur_state.key, packed);
+		memcpy(rec + sizeof(NodeHeader) + state_len, packed, key_len);
+	}
+	move_used += moves.size();
+	return node_count++;
+}
+
+/* Function used to check if a node holds the same state as a Successor
+ *  object, or a symmetric copy of it on symmetric levels.
+ * 
+ * Preconditions: node index, Successor object with its key set
+ * Postconditions: returns true if the states are duplicates
+ */
+template <class B>
+bool NodeArena::matches(const uint32_t index, const Successor<B> &cur_state) const
+{
+	uint64_t packed[B::WORDS + 1];
+	pack_key(cur_state, packed);
+	return matches(index, packed);
+}
+
+/* Function used to pack the state of a Successor object the way nodes are
+ *  compared, by symmetry key on symmetric levels, so a search scanning
+ *  many nodes for it packs it only once.
+ * 
+ * Preconditions: Successor object with its key set, B::WORDS + 1 words to
+ *  pack into
+ * Postconditions: packed holds the state or key
+ */
+template <class B>
+void NodeArena::pack_key(const Successor<B> &cur_state, uint64_t *packed) const
+{
+	pack(key_len > 0 ? cur_state.key : cur_state.state, packed);
+}
+
+bool NodeArena::matches(const uint32_t index, const uint64_t *packed) const
+{
+	const char *rec = record(index) + sizeof(NodeHeader);
+	if (key_len > 0)
+		return memcmp(rec + state_len, packed, key_len) == 0;
+	return memcmp(rec, packed, state_len) == 0;
+}
+
+/* Function used to unpack a node into a Successor object to expand it.
+ *  The path is left empty, the full move list is rebuilt by move_list.
+ * 
+ * Preconditions: node index, Successor object to unpack into
+ * Postconditions: Successor object set from the node
+ */
+template <class B>
+void NodeArena::load(const uint32_t index, Successor<B> &cur_state) const
+{
+	const char *rec = record(index);
+	const NodeHeader *head = (const NodeHeader *)rec;
+	uint64_t packed[B::WORDS + 1];
+	memcpy(packed, rec + sizeof(NodeHeader), state_len);
+	unpack(packed, cur_state.state);
+	if (key_len > 0)
+	{
+		memcpy(packed, rec + sizeof(NodeHeader) + state_len, key_len);
+		unpack(packed, cur_state.key);
+	}
+	cur_state.path.clear();
+	cur_state.depth = head->depth;
+	cur_state.moves = head->moves;
+	cur_state.pushes = head->pushes;
+	cur_state.total_cost = head->total_cost;
+	cur_state.hscore = head->hscore;
+}
+
+/* Function used to rebuild the full move list of a node by following its
+ *  parents back to the root.
+ * 
+ * Preconditions: node index
+ * Postconditions: returns move list such as "u, r, d, "
+ */
+std::string NodeArena::move_list(const uint32_t index) const
+{
+	std::string moves, list;
+	for (uint32_t cur = index; ; cur = header(cur)->parent)
+	{
+		const NodeHeader *head = header(cur);
+		const char *start = move_slabs[head->move_start / MOVE_SLAB_SIZE] +
+		 (head->move_start % MOVE_SLAB_SIZE);
+		moves.insert(0, start, head->move_len);
+		if (head->parent == cur)
+			break;
+	}
+	for (std::string::size_type i = 0; i < moves.size(); i++)
+		list.append(1, moves[i]) += ", ";
+	return list;
+}
+
+/* Function used to get the memory held by the arena.
+ * 
+ * Preconditions: none
+ * Postconditions: returns bytes of the node and move slabs this search uses
+ */
+long NodeArena::bytes() const
+{
+	//only the slabs this search has used
+	return (long)((node_count + NODES_PER_SLAB - 1) / NODES_PER_SLAB) * NODES_PER_SLAB * node_size +
+	 (long)(move_used / MOVE_SLAB_SIZE + 1) * MOVE_SLAB_SIZE;
+}
+
+
+/* Function used to start a search in a new arena, packing the initial
+ *  state as the root node.
+ * 
+ * Preconditions: arena and Kernel of the search, initial State object of
+ *  the search
+ * Postconditions: returns index of the root node
+ */
+template <class B>
+uint32_t add_root(NodeArena &arena, const Kernel<B> &kernel, const State &initial_state)
+{
+	Successor<B> root;
+	kernel.load(initial_state.state_str, root.state);
+	root.key = root.state;
+	root.depth = initial_state.depth;
+	root.moves = initial_state.moves;
+	root.pushes = initial_state.pushes;
+	root.total_cost = initial_state.total_cost;
+	root.hscore = initial_state.hscore;
+	if (kernel.keyed())
+		kernel.set_key(root);
+	return arena.add(root, arena.size());
+} //uint32_t add_root(NodeArena &arena, const Kernel<B> &kernel, const State &initial_state)
+
+/* Function used to fill in the report of a search that found the goal,
+ *  unpacking the goal node into a State with its full move list.
+ * 
+ * Preconditions: arena and Kernel of the search, index of the goal node,
+ *  SearchStat object to fill in
+ * Postconditions: report node set to the goal state
+ */
+template <class B>
+void report_goal(const NodeArena &arena, const Kernel<B> &kernel, const uint32_t index,
+ SearchStat &report)
+{
+	Successor<B> goal;
+	arena.load(index, goal);
+	report.node.state_str = kernel.unload(goal.state);
+	report.node.move_list = arena.move_list(index);
+	report.node.depth = goal.depth;
+	report.node.moves = goal.moves;
+	report.node.pushes = goal.pushes;
+	report.node.total_cost = goal.total_cost;
+	report.node.hscore = goal.hscore;
+} //void report_goal(const NodeArena &arena, const Kernel<B> &kernel, const uint32_t index, SearchStat &report)
+
+/* SearchBudget checks a search against the time, node and memory limits
+ *  of its solve, and its cancel flag.  The node limit is checked for every
+ *  explored node, but the clock, the arena size and the cancel flag only
+ *  every CHECK_INTERVAL nodes, so the checks cost a counter decrement per
+ *  node.  It also keeps the best node explored, the one with the most
+ *  boxes on goals and then the lowest hscore, so a search stopped by a
+ *  limit can report how far it got.  The clock starts when the budget is
+ *  made, at the start of the search.  A search that empties its arena to
+ *  start over calls restart, which forgets the best node but keeps the
+ *  clock running.  Every search keeps more than its arena, its open list,
+ *  index, visited set and node status, and tells the budget their bytes
+ *  with hold when due says the next node explored checks the memory
+ *  limit.  A search that only adds the nodes it needs to the arena adds a
+ *  node when better says it is the best yet.
+ */
+template <class B>
+class SearchBudget
+{
+public:
+	SearchBudget(const Kernel<B> &kernel, const NodeArena &arena);
+	bool spent(const uint32_t index, const Successor<B> &node, const long explored,
+	 SearchStat &report);
+	void stop(const int limit, const long explored, SearchStat &report) const;
+	void restart() { best_goals = -1; }
+	void hold(const long bytes) { held_bytes = bytes; }
+	bool due() const { return countdown == 1; }
+	bool better(const Successor<B> &node) const;
+	uint32_t best_node() const { return best; }
+
+private:
+	static const int CHECK_INTERVAL = 256;
+	const Kernel<B> &kernel;
+	const NodeArena &arena;
+	timeval start;
+	int countdown;
+	long held_bytes;
+	uint32_t best;
+	int best_goals;
+	int best_hscore;
+
+	int reached_limit();
+}; //class SearchBudget
+
+template <class B>
+SearchBudget<B>::SearchBudget(const Kernel<B> &kernel, const NodeArena &arena)
+ : kernel(kernel), arena(arena), countdown(CHECK_INTERVAL), held_bytes(0), best_goals(-1), best_hscore(0)
+{
+	gettimeofday(&start, NULL);
+}
+
+/* Function used to check the limits that are too slow to check for every
+ *  node.  Memory is the bytes of the node arena, which grows with every
+ *  node generated, and the bytes the search last said it holds outside
+ *  it.
+ * 
+ * Preconditions: none
+ * Postconditions: returns the limit_kind reached, or LIMIT_NONE
+ */
+template <class B>
+int SearchBudget<B>::reached_limit()
+{
+	const SolverOptions &options = kernel.options;
+	countdown = CHECK_INTERVAL;
+	if (options.cancel != NULL && *options.cancel)
+		return LIMIT_CANCEL;
+	if (options.memory_limit > 0 && arena.bytes() + held_bytes >= options.memory_limit)
+		return LIMIT_MEMORY;
+	if (options.time_limit > 0 && seconds_since(start) >= options.time_limit)
+		return LIMIT_TIME;
+	return LIMIT_NONE;
+} //int SearchBudget<B>::reached_limit()
+
+/* Function used to check if a search has reached a limit, called for each
+ *  node the search explores.  When it has, the search is exhausted: the
+ *  report gets the limit, the explored count, and the best node explored.
+ * 
+ * Preconditions: arena index of the node explored, the node, count of
+ *  explored nodes, SearchStat object of the search
+ * Postconditions: returns true and fills in report if a limit was reached
+ */
+template <class B>
+bool SearchBudget<B>::spent(const uint32_t index, const Successor<B> &node,
+ const long explored, SearchStat &report)
+{
+	if (better(node))
+	{
+		best = index;
+		best_goals = node.state.boxes.count_and(kernel.goals);
+		best_hscore = node.hscore;
+	}
+
+	if (kernel.options.node_limit > 0 && explored >= kernel.options.node_limit)
+		report.limit = LIMIT_NODES;
+	else if (--countdown == 0)
+		report.limit = reached_limit();
+	if (report.limit == LIMIT_NONE)
+		return false;
+	stop(report.limit, explored, report);
+	return true;
+} //bool SearchBudget<B>::spent(const uint32_t index, const Successor<B> &node, const long explored, SearchStat &report)
+
+/* Function used to check if a node would be the best node explored yet,
+ *  with more boxes on goals, or as many and a lower hscore.
+ * 
+ * Preconditions: node about to be explored
+ * Postconditions: returns true if spent would keep it as the best node
+ */
+template <class B>
+bool SearchBudget<B>::better(const Successor<B> &node) const
+{
+	int goals = node.state.boxes.count_and(kernel.goals);
+	return goals > best_goals || (goals == best_goals && node.hscore < best_hscore);
+} //bool SearchBudget<B>::better(const Successor<B> &node) const
+
+/* Function used to end a search as exhausted by a limit, filling in the
+ *  report with the limit, the explored count, and the best node explored.
+ *  A node has to have been explored.
+ * 
+ * Preconditions: limit_kind reached, count of explored nodes, SearchStat
+ *  object of the search
+ * Postconditions: report filled in
+ */
+template <class B>
+void SearchBudget<B>::stop(const int limit, const long explored, SearchStat &report) const
+{
+	Successor<B> best_node;
+	arena.load(best, best_node);
+	report.limit = limit;
+	report.explored_count = explored;
+	report.best_goals = best_goals;
+	report.best.state_str = kernel.unload(best_node.state);
+	report.best.move_list = arena.move_list(best);
+	report.best.depth = best_node.depth;
+	report.best.moves = best_node.moves;
+	report.best.pushes = best_node.pushes;
+	report.best.total_cost = best_node.total_cost;
+	report.best.hscore = best_node.hscore;
+} //void SearchBudget<B>::stop(const int limit, const long explored, SearchStat &report) const
+
+/* BucketQueue is the open list of uniform cost search and A* search.  It
+ *  is a bucket priority queue (Dial's algorithm) for integer keys: one
+ *  FIFO bucket of node indices per key, and a pointer to the lowest
+ *  bucket that may hold nodes.  Since the costs of a search only grow,
+ *  the pointer mostly moves forward and push and pop take O(1) time.
+ *  Each key bucket is split again by a tie key, the tie breaking cost of
+ *  the cost model.  Nodes with the same keys are popped in the order
+ *  they were pushed, the same order the sorted open list used.
+ */
+class BucketQueue
+{
+public:
+	BucketQueue() : key_base(0), key_cur(0), count(0) {}
+	void push(const uint32_t index, const int key, const int tie);
+	uint32_t pop();
+	int min_key();
+	bool empty() const { return count == 0; }
+	uint32_t size() const { return count; }
+	long bytes() const;
+
+private:
+	struct Bucket
+	{
+		std::vector<uint32_t> items;
+		std::vector<uint32_t>::size_type head;
+	};
+	struct Level
+	{
+		std::vector<Bucket> ties;
+		int tie_cur;
+		uint32_t count;
+	};
+	int key_base;
+	int key_cur;
+	uint32_t count;
+	std::vector<Level> levels;
+}; //class BucketQueue
+
+/* Function used to add a node to the bucket of its keys.  Buckets are
+ *  added as needed, in front if a key is below all keys seen so far.
+ * 
+ * Preconditions: node index, key and tie key of the node
+ * Postconditions: node queued
+ */
+void BucketQueue::push(const uint32_t index, const int key, const int tie)
+{
+	if (levels.empty())
+		key_base = key_cur = key;
+	if (key < key_base)
+	{
+		levels.insert(levels.begin(), key_base - key, Level());
+		for (int i = 0; i < key_base - key; i++)
+			levels[i].tie_cur = levels[i].count = 0;
+		key_base = key;
+	}
+	if (key - key_base >= (int)levels.size())
+	{
+		Level empty_level;
+		empty_level.tie_cur = empty_level.count = 0;
+		levels.resize(key - key_base + 1, empty_level);
+	}
+	Level &level = levels[key - key_base];
+	if (tie >= (int)level.ties.size())
+	{
+		Bucket empty_bucket;
+		empty_bucket.head = 0;
+		level.ties.resize(tie + 1, empty_bucket);
+	}
+	level.ties[tie].items.push_back(index);
+	if (level.count == 0 || tie < level.tie_cur)
+		level.tie_cur = tie;
+	level.count++;
+	if (key < key_cur)
+		key_cur = key;
+	count++;
+} //void BucketQueue::push(const uint32_t index, const int key, const int tie)
+
+/* Function used to take the first node of the lowest non empty bucket.
+ * 
+ * Preconditions: queue is not empty
+ * Postconditions: returns the node index removed from the queue
+ */
+uint32_t BucketQueue::pop()
+{
+	while (levels[key_cur - key_base].count == 0)
+		key_cur++;
+	Level &level = levels[key_cur - key_base];
+	while (level.ties[level.tie_cur].head == level.ties[level.tie_cur].items.size())
+		level.tie_cur++;
+	Bucket &bucket = level.ties[level.tie_cur];
+	uint32_t index = bucket.items[bucket.head++];
+	//emptied buckets give back their space to be reused
+	if (bucket.head == bucket.items.size())
+	{
+		bucket.items.clear();
+		bucket.head = 0;
+	}
+	level.count--;
+	count--;
+	return index;
+} //uint32_t BucketQueue::pop()
+
+/* Function used to find the lowest key of the nodes queued.
+ * 
+ * Preconditions: queue is not empty
+ * Postconditions: returns the key of the node pop would return
+ */
+int BucketQueue::min_key()
+{
+	while (levels[key_cur - key_base].count == 0)
+		key_cur++;
+	return key_cur;
+} //int BucketQueue::min_key()
+
+/* Function used to count the bytes the queue takes, buckets emptied
+ *  included, since they keep their space to be reused.
+ *
+ * Preconditions: none
+ * Postconditions: returns bytes of the buckets
+ */
+long BucketQueue::bytes() const
+{
+	long total = (long)levels.capacity() * sizeof(Level);
+	for (std::vector<Level>::size_type i = 0; i < levels.size(); i++)
+	{
+		total += (long)levels[i].ties.capacity() * sizeof(Bucket);
+		for (std::vector<Bucket>::size_type j = 0; j < levels[i].ties.size(); j++)
+			total += (long)levels[i].ties[j].items.capacity() * sizeof(uint32_t);
+	}
+	return total;
+} //long BucketQueue::bytes() const
+
+/* NodeIndex finds the arena node of a state in O(1) time, instead of
+ *  scanning a list.  It is an open addressing hash table of node indices
+ *  with linear probing, kept at most half full.  Each slot also keeps the
+ *  hash of its state, so the table grows without loading nodes again.
+ *  On symmetric levels states are hashed and compared by symmetry key,
+ *  the same as NodeArena::matches.
+ */
+class NodeIndex
+{
+public:
+	static const uint32_t NOT_FOUND = 0xffffffff;
+
+	NodeIndex(const bool keyed) : keyed(keyed), count(0), slots(1024) {}
+	template <class B> uint32_t find(const NodeArena &arena, const Successor<B> &node) const;
+	template <class B> void set(const NodeArena &arena, const Successor<B> &node,
+	 const uint32_t index);
+	uint32_t size() const { return count; }
+	long bytes() const { return (long)slots.size() * sizeof(Slot); }
+
+private:
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t index;
+
+		Slot() : hash(0), index(NOT_FOUND) {}
+	};
+	bool keyed;
+	uint32_t count;
+	std::vector<Slot> slots;
+
+	template <class B> uint32_t hash(const Successor<B> &node) const;
+	void grow();
+}; //class NodeIndex
+
+/* Function used to hash the state of a node, or its symmetry key, one
+ *  64 bit word at a time.
+ * 
+ * Preconditions: Successor object
+ * Postconditions: returns the hash of the state
+ */
+template <class B>
+uint32_t NodeIndex::hash(const Successor<B> &node) const
+{
+	const uint64_t *word = (const uint64_t *)(keyed ? &node.key : &node.state);
+	uint64_t h = 0;
+	for (std::string::size_type i = 0; i < sizeof(BoardState<B>) / 8; i++)
+		h = (h ^ word[i]) * 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+/* Function used to find the node holding a state.
+ * 
+ * Preconditions: arena the nodes are in, Successor object
+ * Postconditions: returns the node index, or NOT_FOUND
+ */
+template <class B>
+uint32_t NodeIndex::find(const NodeArena &arena, const Successor<B> &node) const
+{
+	uint32_t h = hash(node), mask = slots.size() - 1;
+	for (uint32_t i = h & mask; slots[i].index != NOT_FOUND; i = (i + 1) & mask)
+		if (slots[i].hash == h && arena.matches(slots[i].index, node))
+			return slots[i].index;
+	return NOT_FOUND;
+} //uint32_t NodeIndex::find(const NodeArena &arena, const Successor<B> &node) const
+
+/* Function used to point a state at a node, replacing the node it had if
+ *  it was already indexed.
+ * 
+ * Preconditions: arena the nodes are in, Successor object, its node index
+ * Postconditions: state indexed
+ */
+template <class B>
+void NodeIndex::set(const NodeArena &arena, const Successor<B> &node, const uint32_t index)
+{
+	if ((count + 1) * 2 > slots.size())
+		grow();
+	uint32_t h = hash(node), mask = slots.size() - 1, i = h & mask;
+	for (; slots[i].index != NOT_FOUND; i = (i + 1) & mask)
+		if (slots[i].hash == h && arena.matches(slots[i].index, node))
+		{
+			slots[i].index = index;
+			return;
+		}
+	slots[i].hash = h;
+	slots[i].index = index;
+	count++;
+} //void NodeIndex::set(const NodeArena &arena, const Successor<B> &node, const uint32_t index)
+
+void NodeIndex::grow()
+{
+	std::vector<Slot> old(slots.size() * 2);
+	old.swap(slots);
+	uint32_t mask = slots.size() - 1;
+	for (std::vector<Slot>::size_type j = 0; j < old.size(); j++)
+	{
+		if (old[j].index == NOT_FOUND)
+			continue;
+		uint32_t i = old[j].hash & mask;
+		while (slots[i].index != NOT_FOUND)
+			i = (i + 1) & mask;
+		slots[i] = old[j];
+	}
+}
+
+/* VisitedSet remembers the states breadth first, depth first and greedy
+ *  best first search have seen, in place of scanning their open and
+ *  closed lists, in one of two tables.
+ *
+ *  VISITED_EXACT keeps every state in an open addressing table with
+ *  linear probing, grown by doubling at 3/4 full.  A slot is only as many
+ *  bytes as a state needs: the floor cell of the player plus 1, so an
+ *  empty slot is all 0, then one bit per floor cell for the boxes.  If
+ *  every state of the level fits in dense_limit bytes at one bit each,
+ *  the table is a bitmap instead, indexed by the rank of the state, see
+ *  StateRanks.  The box count is only known from the first state added,
+ *  so the table is chosen then.
+ *
+ *  VISITED_FILTER keeps only a fingerprint of each state in a cuckoo
+ *  filter: buckets of BUCKET_SLOTS fingerprints, each fingerprint in one
+ *  of two buckets, the second found from the first and the fingerprint,
+ *  so a fingerprint can be moved to its other bucket to make room.  A
+ *  state whose fingerprint is already in one of its buckets is taken as
+ *  seen, which is wrong for about rate of the new states, so a search can
+ *  lose states and miss a solution.  A full filter cannot be grown without
+ *  the states, so a new one of twice the buckets is added, with one more
+ *  fingerprint bit to halve its false positive rate, and all of them
+ *  together stay below twice rate.  Fingerprints that find no room after
+ *  MAX_KICKS moves are kept in the stash of their filter.
+ */
+class VisitedSet
+{
+public:
+	VisitedSet() : kind(VISITED_SCAN), count(0), dense(false), random(0x9E3779B97F4A7C15ULL) {}
+	void reset(const CellMap &cells, const int kind, const double rate, const long dense_limit);
+	bool insert(const uint64_t *packed);
+	int mode() const { return kind; }
+	long size() const { return count; }
+	long bytes() const;
+
+private:
+	struct Filter
+	{
+		std::vector<uint64_t> bits;
+		uint32_t buckets;
+		int fp_bits;
+		uint32_t used;
+		std::vector< std::pair<uint32_t, uint32_t> > stash;
+	};
+	static const int BUCKET_SLOTS = 4;
+	static const int MAX_KICKS = 500;
+	int kind;
+	long count;
+	int words;
+	int player_bits;
+	std::string::size_type slot_bytes;
+	std::string::size_type head_bytes;
+	uint64_t slot_mask;
+	std::vector<uint8_t> slots;
+	std::vector<uint64_t> scratch;
+	int floor;
+	int boxes;
+	long dense_limit;
+	bool dense;
+	StateRanks ranks;
+	std::vector<uint64_t> bitmap;
+	std::vector<Filter> filters;
+	int first_bits;
+	uint64_t random;
+
+	uint64_t hash(const uint64_t *key, const int key_words) const;
+	bool empty_slot(const uint8_t *slot) const;
+	bool insert_exact(const uint64_t *packed);
+	void grow_exact();
+	void pick_table(const uint64_t *packed);
+	bool insert_filter(const uint64_t *packed);
+	void add_filter();
+	static uint32_t fingerprint(const Filter &filter, const uint64_t slot);
+	static void set_fingerprint(Filter &filter, const uint64_t slot, const uint32_t value);
+}; //class VisitedSet
+
+/* Function used to empty the set for a new search, choosing its table.
+ *
+ * Preconditions: CellMap of the board, visited_mode, false positive rate
+ *  of VISITED_FILTER, most bytes of the bitmap of VISITED_EXACT
+ * Postconditions: set holds no states
+ */
+void VisitedSet::reset(const CellMap &cells, const int kind, const double rate, const long dense_limit)
+{
+	floor = cells.grid.size();
+	this->kind = kind;
+	this->dense_limit = dense_limit;
+	count = 0;
+	words = cells.words;
+	boxes = -1;
+	dense = false;
+	std::vector<uint8_t>().swap(slots);
+	std::vector<Filter>().swap(filters);
+	std::vector<uint64_t>().swap(bitmap);
+	if (kind == VISITED_EXACT)
+	{
+		for (player_bits = 1; (1 << player_bits) <= floor; player_bits++)
+			;
+		slot_bytes = (player_bits + floor + 7) / 8;
+		head_bytes = (player_bits + 7) / 8;
+		scratch.assign(words + 2, 0);
+		slots.assign(1024 * slot_bytes, 0);
+		slot_mask = 1023;
+	}
+	if (kind == VISITED_FILTER)
+	{
+		//the first filter takes half of the rate, a new state is compared
+		//with the 2 * BUCKET_SLOTS fingerprints of its buckets
+		first_bits = 1;
+		while (first_bits < 32 && 4.0 * BUCKET_SLOTS / ((uint64_t)1 << first_bits) > rate)
+			first_bits++;
+		add_filter();
+	}
+} //void VisitedSet::reset(const CellMap &cells, const int kind, const double rate)
+
+/* Function used to hash a key one 64 bit word at a time.
+ *
+ * Preconditions: key words
+ * Postconditions: returns the hash of the key
+ */
+uint64_t VisitedSet::hash(const uint64_t *key, const int key_words) const
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (int i = 0; i < key_words; i++)
+		h = (h ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+	return h ^ (h >> 29);
+}
+
+//a used slot has the player plus 1 in its first bits
+bool VisitedSet::empty_slot(const uint8_t *slot) const
+{
+	for (std::string::size_type j = 0; j < head_bytes; j++)
+		if (slot[j] != 0)
+			return false;
+	return true;
+}
+
+/* Function used to add a state to the set, if it is not in it already.
+ *
+ * Preconditions: state packed by NodeArena::pack_key
+ * Postconditions: returns true if the state is new and was added, false
+ *  if it was seen before, or, with the filter, may have been
+ */
+bool VisitedSet::insert(const uint64_t *packed)
+{
+	if (kind == VISITED_EXACT && boxes < 0)
+		pick_table(packed);
+	if (kind == VISITED_EXACT && dense)
+	{
+		uint64_t rank = ranks.rank(packed), bit = (uint64_t)1 << (rank & 63);
+		if (bitmap[rank >> 6] & bit)
+			return false;
+		bitmap[rank >> 6] |= bit;
+		count++;
+		return true;
+	}
+	if (kind == VISITED_EXACT)
+		return insert_exact(packed);
+	return insert_filter(packed);
+} //bool VisitedSet::insert(const uint64_t *packed)
+
+/* Function used to choose between the bitmap and the hash table, by the
+ *  number of states of a level with the box count of the first state.
+ *
+ * Preconditions: first state added, packed by NodeArena::pack_key
+ * Postconditions: boxes set, and the bitmap and ranks set up if they fit
+ */
+void VisitedSet::pick_table(const uint64_t *packed)
+{
+	boxes = 0;
+	for (int w = 0; w < words; w++)
+		boxes += __builtin_popcountll(packed[w]);
+	dense = ranks.reset(floor, words, boxes, (uint64_t)std::max(dense_limit, 0L) * 8);
+	if (!dense)
+		return;
+	bitmap.assign((ranks.states() + 63) / 64, 0);
+	std::vector<uint8_t>().swap(slots);
+} //void VisitedSet::pick_table(const uint64_t *packed)
+
+bool VisitedSet::insert_exact(const uint64_t *packed)
+{
+	//the player in the low bits, the boxes shifted above it
+	uint64_t *key = &scratch[0];
+	memset(key, 0, scratch.size() * sizeof(uint64_t));
+	key[0] = packed[words] + 1;
+	for (int w = 0; w < words; w++)
+	{
+		key[w] |= packed[w] << player_bits;
+		key[w + 1] |= packed[w] >> (64 - player_bits);
+	}
+	const int key_words = (slot_bytes + 7) / 8;
+	for (uint64_t i = hash(key, key_words) & slot_mask; ; i = (i + 1) & slot_mask)
+	{
+		uint8_t *slot = &slots[i * slot_bytes];
+		if (memcmp(slot, key, slot_bytes) == 0)
+			return false;
+		if (!empty_slot(slot))
+			continue;
+		memcpy(slot, key, slot_bytes);
+		if (++count * 4 > (long)(slot_mask + 1) * 3)
+			grow_exact();
+		return true;
+	}
+} //bool VisitedSet::insert_exact(const uint64_t *packed)
+
+void VisitedSet::grow_exact()
+{
+	std::vector<uint8_t> old(slots.size() * 2, 0);
+	old.swap(slots);
+	slot_mask = slot_mask * 2 + 1;
+	const int key_words = (slot_bytes + 7) / 8;
+	uint64_t *key = &scratch[0];
+	for (std::string::size_type at = 0; at < old.size(); at += slot_bytes)
+	{
+		if (empty_slot(&old[at]))
+			continue;
+		memset(key, 0, scratch.size() * sizeof(uint64_t));
+		memcpy(key, &old[at], slot_bytes);
+		uint64_t i = hash(key, key_words) & slot_mask;
+		while (!empty_slot(&slots[i * slot_bytes]))
+			i = (i + 1) & slot_mask;
+		memcpy(&slots[i * slot_bytes], key, slot_bytes);
+	}
+}
+
+/* Functions used to read and write the fingerprint in a slot of a filter,
+ *  packed fp_bits to a slot.
+ */
+uint32_t VisitedSet::fingerprint(const Filter &filter, const uint64_t slot)
+{
+	uint64_t pos = slot * filter.fp_bits, value = filter.bits[pos >> 6] >> (pos & 63);
+	if ((pos & 63) + filter.fp_bits > 64)
+		value |= filter.bits[(pos >> 6) + 1] << (64 - (pos & 63));
+	return (uint32_t)(value & (((uint64_t)1 << filter.fp_bits) - 1));
+}
+
+void VisitedSet::set_fingerprint(Filter &filter, const uint64_t slot, const uint32_t value)
+{
+	uint64_t pos = slot * filter.fp_bits, mask = ((uint64_t)1 << filter.fp_bits) - 1;
+	filter.bits[pos >> 6] = (filter.bits[pos >> 6] & ~(mask << (pos & 63))) |
+	 ((uint64_t)value << (pos & 63));
+	if ((pos & 63) + filter.fp_bits > 64)
+	{
+		int low = 64 - (pos & 63);
+		filter.bits[(pos >> 6) + 1] = (filter.bits[(pos >> 6) + 1] & ~(mask >> low)) |
+		 ((uint64_t)value >> low);
+	}
+}
+
+/* Function used to add a filter twice the size of the last one, with one
+ *  more fingerprint bit.
+ *
+ * Preconditions: first_bits set
+ * Postconditions: new filter added, empty
+ */
+void VisitedSet::add_filter()
+{
+	Filter filter;
+	filter.buckets = filters.empty() ? 1024 : filters.back().buckets * 2;
+	filter.fp_bits = std::min(32, first_bits + (int)filters.size());
+	filter.used = 0;
+	filter.bits.assign(((uint64_t)filter.buckets * BUCKET_SLOTS * filter.fp_bits + 63) / 64 + 1, 0);
+	filters.push_back(filter);
+} //void VisitedSet::add_filter()
+
+bool VisitedSet::insert_filter(const uint64_t *packed)
+{
+	uint64_t h = hash(packed, words + 1);
+
+	//a state is seen if any filter holds its fingerprint
+	for (std::vector<Filter>::size_type f = 0; f < filters.size(); f++)
+	{
+		const Filter &filter = filters[f];
+		uint32_t fp = (uint32_t)((h >> 32) % (((uint64_t)1 << filter.fp_bits) - 1)) + 1;
+		uint32_t first = h & (filter.buckets - 1);
+		uint32_t second = (first ^ (fp * 0x5bd1e995U)) & (filter.buckets - 1);
+		for (int j = 0; j < BUCKET_SLOTS; j++)
+			if (fingerprint(filter, (uint64_t)first * BUCKET_SLOTS + j) == fp ||
+			 fingerprint(filter, (uint64_t)second * BUCKET_SLOTS + j) == fp)
+				return false;
+		for (std::vector< std::pair<uint32_t, uint32_t> >::size_type j = 0; j < filter.stash.size(); j++)
+			if (filter.stash[j].second == fp &&
+			 (filter.stash[j].first == first || filter.stash[j].first == second))
+				return false;
+	}
+
+	//new states go in the last filter, with room to move fingerprints
+	if ((filters.back().used + 1) * 20 > filters.back().buckets * BUCKET_SLOTS * 19)
+		add_filter();
+	Filter &filter = filters.back();
+	uint32_t fp = (uint32_t)((h >> 32) % (((uint64_t)1 << filter.fp_bits) - 1)) + 1;
+	uint32_t bucket = h & (filter.buckets - 1);
+	filter.used++;
+	count++;
+	for (int kick = 0; kick <= MAX_KICKS; kick++)
+	{
+		uint32_t other = (bucket ^ (fp * 0x5bd1e995U)) & (filter.buckets - 1);
+		for (int side = 0; side < 2; side++)
+		{
+			uint32_t b = side ? other : bucket;
+			for (int j = 0; j < BUCKET_SLOTS; j++)
+				if (fingerprint(filter, (uint64_t)b * BUCKET_SLOTS + j) == 0)
+				{
+					set_fingerprint(filter, (uint64_t)b * BUCKET_SLOTS + j, fp);
+					return true;
+				}
+		}
+		//both buckets full, a random fingerprint moves to its other bucket
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+		bucket = (random & 1) ? other : bucket;
+		uint64_t slot = (uint64_t)bucket * BUCKET_SLOTS + (random >> 1) % BUCKET_SLOTS;
+		uint32_t moved = fingerprint(filter, slot);
+		set_fingerprint(filter, slot, fp);
+		fp = moved;
+	}
+	filter.stash.push_back(std::make_pair(bucket, fp));
+	return true;
+} //bool VisitedSet::insert_filter(const uint64_t *packed)
+
+/* Function used to get the memory held by the set.
+ *
+ * Preconditions: none
+ * Postconditions: returns bytes of the tables of the set
+ */
+long VisitedSet::bytes() const
+{
+	long total = slots.size() + bitmap.size() * sizeof(uint64_t) + ranks.bytes();
+	for (std::vector<Filter>::size_type f = 0; f < filters.size(); f++)
+		total += filters[f].bits.size() * sizeof(uint64_t) +
+		 filters[f].stash.size() * sizeof(std::pair<uint32_t, uint32_t>);
+	return total;
+} //long VisitedSet::bytes() const
+
+/* Function used to choose the visited set of a search.  The fingerprint
+ *  filter can lose states, so only searches that are not optimal use it,
+ *  and the others use the exact table instead.
+ *
+ * Preconditions: options of the solve
+ * Postconditions: returns the visited_mode the search uses
+ */
+int visited_mode(const SolverOptions &options)
+{
+	if (options.visited == VISITED_FILTER && options.search != DFS &&
+	 options.search != GBFSH1 && options.search != GBFSH2)
+		return VISITED_EXACT;
+	return options.visited;
+} //int visited_mode(const SolverOptions &options)
+
+/* Function used to add the root of a search to its visited set.
+ *
+ * Preconditions: visited set and arena of the search, index of the root
+ * Postconditions: root state in the set, unless the search scans
+ */
+template <class B>
+void visit_root(VisitedSet &visited, const NodeArena &arena, const uint32_t root)
+{
+	Successor<B> node;
+	uint64_t packed[B::WORDS + 1];
+
+	if (visited.mode() == VISITED_SCAN)
+		return;
+	arena.load(root, node);
+	arena.pack_key(node, packed);
+	visited.insert(packed);
+} //void visit_root(VisitedSet &visited, const NodeArena &arena, const uint32_t root)
+
+/* Status of each node of uniform cost search and A* search, by arena
+ *  index.  A node reached again by a cheaper path is replaced by a new
+ *  node, and the old one is stale: skipped when popped from the open list
+ *  if it was still queued, never expanded again if it was closed.
+ */
+enum node_status {NODE_OPEN, NODE_CLOSED, NODE_STALE};
+
+/* Function used to compute the tie key of a state from its moves and
+ *  pushes, see tie_cost.
+ * 
+ * Preconditions: CostModel in use, State or Successor object
+ * Postconditions: returns the tie breaking cost of the state
+ */
+template <class T>
+int tie_key(const CostModel &costs, const T &cur_state)
+{
+	int move_cost, push_cost;
+	tie_cost(costs, move_cost, push_cost);
+	return cur_state.moves * move_cost + cur_state.pushes * push_cost;
+} //int tie_key(const CostModel &costs, const T &cur_state)
+
+/* Function used to check if a new path to a state is cheaper than the
+ *  node already holding it, by total cost and then by tie breaking cost,
+ *  the order the open list pops nodes in.
+ * 
+ * Preconditions: CostModel in use, Successor object, header of the node
+ *  holding the same state, a NodeHeader or FrontierHeader
+ * Postconditions: returns true if the Successor is cheaper
+ */
+template <class B, class H>
+bool cheaper(const CostModel &costs, const Successor<B> &cur_state, const H &node)
+{
+	return cur_state.total_cost < node.total_cost || (cur_state.total_cost == node.total_cost &&
+	 tie_key(costs, cur_state) < tie_key(costs, node));
+} //bool cheaper(const CostModel &costs, const Successor<B> &cur_state, const H &node)
+
+/* Function executes depth first search algorithm on an inital state.
+ *  Due to sokoban puzzles having infinite depth, an explored list is
+ *  used to prevent infinite loops. 
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, the NodeArena to store the nodes in, and the
+ *  VisitedSet to find duplicates with, unless the search scans its lists
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat bfs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena,
+ VisitedSet &visited)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	std::deque<uint32_t> open;
+	std::vector<uint32_t> closed;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 1;//will be replaced, just to stop cout spam
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	uint32_t current;
+	
+	//push first state into queue
+	visited.reset(kernel.cells, visited_mode(kernel.options), kernel.options.filter_rate,
+	 kernel.options.dense_limit);
+	current = add_root(arena, kernel, initial_state);
+	visit_root<B>(visited, arena, current);
+	open.push_back(current);
+	while (!open.empty())
+	{
+		//take N from OPEN
+		current = open.front();
+		open.pop_front();
+		//push N onto CLOSED
+		closed.push_back(current);
+		arena.load(current, current_state);
+		
+		//print out in case a long time is taken and wondering if it froze
+		if ((closed.size() % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< closed.size() <<" nodes..."<<std::endl;
+			
+		//if found, set report node to current node, set explored count to closed list size
+		if (kernel.is_goal(current_state.state))
+		{
+			report_goal(arena, kernel, current, report);
+			report.explored_count = closed.size();
+			if (!open.empty())
+				open.pop_front();
+			break;
+		}
+		
+		//stop if the search reached a limit of the solve, its lists and
+		//visited set counted with the arena
+		if (budget.due())
+			budget.hold((long)(open.size() + closed.capacity()) * sizeof(uint32_t) + visited.bytes());
+		if (budget.spent(current, current_state, closed.size(), report))
+			break;
+		
+		//generate valid states
+		gen_valid_states(kernel, current_state, NONE, valid_states);
+		std::deque<uint32_t>::iterator it;
+		std::vector<uint32_t>::iterator itr;
+		
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			bool already_seen = false;
+			const Successor<B> &temp_state = valid_states[i];
+			uint64_t packed[B::WORDS + 1];
+			arena.pack_key(temp_state, packed);
+			//the visited set holds every state of the open and closed lists
+			if (visited.mode() != VISITED_SCAN)
+				already_seen = !visited.insert(packed);
+			else
+			{
+				//check if state has already been seen on open list
+				for (it = open.begin(); it != open.end(); it++)
+				{
+					if (arena.matches(*it, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+				//check if state has already been seen on closed list
+				for (itr = closed.begin(); itr != closed.end(); itr++)
+				{
+					if (arena.matches(*itr, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+			}
+			//if not duplicate, then add state to open queue
+			if (!already_seen)
+			{
+				report.node_count++;
+				//add to back of open
+				open.push_back(arena.add(temp_state, current));
+			}
+			else
+				report.rep_node_count++;
+		}
+	}
+	report.fringe_node = open.size();
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat bfs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena, VisitedSet &visited)
+
+/* Function executes depth first search algorithm on an inital state.
+ *  Due to sokoban puzzles having infinite depth, an explored list is
+ *  used to prevent infinite loops.
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, the NodeArena to store the nodes in, and the
+ *  VisitedSet to find duplicates with, unless the search scans its lists
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat dfs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena,
+ VisitedSet &visited)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	std::deque<uint32_t> open;
+	std::vector<uint32_t> closed;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 1;//will be replaced, just to stop cout spam
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	uint32_t current;
+	
+	//push first state into queue
+	visited.reset(kernel.cells, visited_mode(kernel.options), kernel.options.filter_rate,
+	 kernel.options.dense_limit);
+	current = add_root(arena, kernel, initial_state);
+	visit_root<B>(visited, arena, current);
+	open.push_back(current);
+	while (!open.empty())
+	{
+		//take N from OPEN
+		current = open.front();
+		open.pop_front();
+		//push N onto CLOSED
+		closed.push_back(current);
+		arena.load(current, current_state);
+		
+		//print out in case a long time is taken and wondering if it froze
+		if ((closed.size() % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< closed.size() <<" nodes..."<<std::endl;
+			
+		//if found, set report node to current node, set explored count to closed list size
+		if (kernel.is_goal(current_state.state))
+		{
+			report_goal(arena, kernel, current, report);
+			report.explored_count = closed.size();
+			if (!open.empty())
+				open.pop_front();
+			break;
+		}
+		
+		//stop if the search reached a limit of the solve, its lists and
+		//visited set counted with the arena
+		if (budget.due())
+			budget.hold((long)(open.size() + closed.capacity()) * sizeof(uint32_t) + visited.bytes());
+		if (budget.spent(current, current_state, closed.size(), report))
+			break;
+		
+		//generate valid states
+		gen_valid_states(kernel, current_state, NONE, valid_states);
+		std::deque<uint32_t>::iterator it;
+		std::vector<uint32_t>::iterator itr;
+		std::deque<uint32_t> temp_open;
+		
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			bool already_seen = false;
+			const Successor<B> &temp_state = valid_states[i];
+			uint64_t packed[B::WORDS + 1];
+			arena.pack_key(temp_state, packed);
+			//the visited set holds every state of the open and closed lists
+			if (visited.mode() != VISITED_SCAN)
+				already_seen = !visited.insert(packed);
+			else
+			{
+				//check if state has already been seen on open list
+				for (it = open.begin(); it != open.end(); it++)
+				{
+					if (arena.matches(*it, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+				//check if state has already been seen on closed list
+				for (itr = closed.begin(); itr != closed.end(); itr++)
+				{
+					if (arena.matches(*itr, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+			}
+			//if not duplicate, then add state to open queue
+			if (!already_seen)
+			{
+				report.node_count++;
+				//uses a temporary queue to reverse the node order
+				temp_open.push_front(arena.add(temp_state, current));
+			}
+			else
+				report.rep_node_count++;
+		}
+		//reverses the reversed queue to keep left to right searches in the dfs
+		while (!temp_open.empty())
+		{
+			open.push_front(temp_open.front());
+			temp_open.pop_front();
+		}
+	}
+	report.fringe_node = open.size();
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat dfs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena, VisitedSet &visited)
+
+/* Function executes uniform cost search algorithm on an inital state.
+ *  Due to sokoban puzzles having infinite depth, an explored list is
+ *  used to prevent infinite loops.  Duplicates are found through a
+ *  NodeIndex of every node seen, and a state reached again by a cheaper
+ *  path is queued again, so the search stays optimal when moves and
+ *  pushes cost differently.
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, and the NodeArena to store the nodes in
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat ucs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	BucketQueue open;
+	NodeIndex index(kernel.keyed());
+	std::vector<char> status;
+	long explored = 0, stale_queued = 0;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 1;//will be replaced, just to stop cout spam
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	uint32_t current;
+	
+	//push first state into queue
+	current = add_root(arena, kernel, initial_state);
+	arena.load(current, current_state);
+	index.set(arena, current_state, current);
+	status.push_back(NODE_OPEN);
+	open.push(current, initial_state.total_cost, tie_key(kernel.options.costs, initial_state));
+	while (!open.empty())
+	{
+		//take N from OPEN, skipping nodes replaced by a cheaper copy
+		current = open.pop();
+		if (status[current] == NODE_STALE)
+		{
+			stale_queued--;
+			continue;
+		}
+		//push N onto CLOSED
+		status[current] = NODE_CLOSED;
+		explored++;
+		arena.load(current, current_state);
+		
+		//print out in case a long time is taken and wondering if it froze
+		if ((explored % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< explored <<" nodes..."<<std::endl;
+			
+		//if found, set report node to current node, set explored count to closed list size
+		if (kernel.is_goal(current_state.state))
+		{
+			report_goal(arena, kernel, current, report);
+			report.explored_count = explored;
+			if (!open.empty())
+				open.pop();
+			break;
+		}
+		
+		//stop if the search reached a limit of the solve, its queue, index
+		//and node status counted with the arena
+		if (budget.due())
+			budget.hold(open.bytes() + index.bytes() + (long)status.capacity());
+		if (budget.spent(current, current_state, explored, report))
+			break;
+		
+		//generate valid states
+		gen_valid_states(kernel, current_state, UCS, valid_states);
+		
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			const Successor<B> &temp_state = valid_states[i];
+			//a state already seen on the open or closed list is only
+			//kept again if this path to it is cheaper
+			uint32_t seen = index.find(arena, temp_state);
+			if (seen != NodeIndex::NOT_FOUND)
+			{
+				if (!cheaper(kernel.options.costs, temp_state, *arena.header(seen)))
+				{
+					report.rep_node_count++;
+					continue;
+				}
+				//a queued copy is skipped when popped, a closed one is
+				//reopened through the new node
+				if (status[seen] == NODE_OPEN)
+					stale_queued++;
+				status[seen] = NODE_STALE;
+			}
+			report.node_count++;
+			//add to the bucket of its total cost, after nodes with
+			//the same priority, used to maintain generated node order
+			uint32_t added = arena.add(temp_state, current);
+			index.set(arena, temp_state, added);
+			status.push_back(NODE_OPEN);
+			open.push(added, temp_state.total_cost, tie_key(kernel.options.costs, temp_state));
+		}
+	}
+	report.fringe_node = open.size() - stale_queued;
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat ucs(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+
+/* Function executes greedy best first search algorithm on an inital
+ *  state with a given heuristics function.
+ *  Due to sokoban puzzles having infinite depth, an explored list is
+ *  used to prevent infinite loops.  
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, an integer representing which heuristics function to use,
+ *  the NodeArena to store the nodes in, and the VisitedSet to find
+ *  duplicates with, unless the search scans its lists
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat gbfs(const Kernel<B> &kernel, State &initial_state, int hfchoice, NodeArena &arena,
+ VisitedSet &visited)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	std::deque<uint32_t> open;
+	std::vector<uint32_t> closed;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 1;//will be replaced, just to stop cout spam
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	uint32_t current;
+	
+	//push first state into queue
+	visited.reset(kernel.cells, visited_mode(kernel.options), kernel.options.filter_rate,
+	 kernel.options.dense_limit);
+	current = add_root(arena, kernel, initial_state);
+	visit_root<B>(visited, arena, current);
+	open.push_back(current);
+	while (!open.empty())
+	{
+		//take N from OPEN
+		current = open.front();
+		open.pop_front();
+		//push N onto CLOSED
+		closed.push_back(current);
+		arena.load(current, current_state);
+		
+		//print out in case a long time is taken and wondering if it froze
+		if ((closed.size() % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< closed.size() <<" nodes..."<<std::endl;
+			
+		//if found, set report node to current node, set explored count to closed list size
+		if (kernel.is_goal(current_state.state))
+		{
+			report_goal(arena, kernel, current, report);
+			report.explored_count = closed.size();
+			if (!open.empty())
+				open.pop_front();
+			break;
+		}
+		
+		//stop if the search reached a limit of the solve, its lists and
+		//visited set counted with the arena
+		if (budget.due())
+			budget.hold((long)(open.size() + closed.capacity()) * sizeof(uint32_t) + visited.bytes());
+		if (budget.spent(current, current_state, closed.size(), report))
+			break;
+		
+		//generate valid states
+		gen_valid_states(kernel, current_state, hfchoice, valid_states);
+		std::deque<uint32_t>::iterator it;
+		std::vector<uint32_t>::iterator itr;
+		
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			bool already_seen = false;
+			bool inserted = false;
+			const Successor<B> &temp_state = valid_states[i];
+			uint64_t packed[B::WORDS + 1];
+			arena.pack_key(temp_state, packed);
+			//the visited set holds every state of the open and closed lists
+			if (visited.mode() != VISITED_SCAN)
+				already_seen = !visited.insert(packed);
+			else
+			{
+				//check if state has already been seen on open list
+				for (it = open.begin(); it != open.end(); it++)
+				{
+					if (arena.matches(*it, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+				//check if state has already been seen on closed list
+				for (itr = closed.begin(); itr != closed.end(); itr++)
+				{
+					if (arena.matches(*itr, packed))
+					{
+						already_seen = true;
+						break;
+					}
+				}
+			}
+			//if not duplicate, then add state to open queue
+			if (!already_seen)
+			{
+				report.node_count++;
+				//add to beginning of node with greater total cost
+				//used to maintain generated node order
+				for (it = open.begin(); it != open.end(); it++)
+				{
+					//priority of lowest hscore first
+					if (arena.header(*it)->hscore > temp_state.hscore)
+					{
+						open.insert(it, arena.add(temp_state, current));
+						inserted = true;
+						break;
+					}
+				}
+				//if no node has greater priority, push back
+				if (!inserted)
+					open.push_back(arena.add(temp_state, current));
+			}
+			else
+				report.rep_node_count++;
+		}
+	}
+	report.fringe_node = open.size();
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat gbfs(const Kernel<B> &kernel, State &initial_state, int hfchoice, NodeArena &arena, VisitedSet &visited)
+
+/* Function executes A* search search algorithm on an inital state with
+ *  a given heuristics function.
+ *  Due to sokoban puzzles having infinite depth, an explored list is
+ *  used to prevent infinite loops.  As in uniform cost search, a state
+ *  reached again by a cheaper path is queued again, even if it was
+ *  already explored, since a heuristics function that is not consistent
+ *  can close a state before its cheapest path is found.
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, an integer representing which heuristics function to use,
+ *  and the NodeArena to store the nodes in
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat as(const Kernel<B> &kernel, State &initial_state, int hfchoice, NodeArena &arena)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	BucketQueue open;
+	NodeIndex index(kernel.keyed());
+	std::vector<char> status;
+	long explored = 0, stale_queued = 0;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 1;//will be replaced, just to stop cout spam
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	uint32_t current;
+	
+	//push first state into queue
+	current = add_root(arena, kernel, initial_state);
+	arena.load(current, current_state);
+	index.set(arena, current_state, current);
+	status.push_back(NODE_OPEN);
+	open.push(current, initial_state.hscore, tie_key(kernel.options.costs, initial_state));
+	while (!open.empty())
+	{
+		//take N from OPEN, skipping nodes replaced by a cheaper copy
+		current = open.pop();
+		if (status[current] == NODE_STALE)
+		{
+			stale_queued--;
+			continue;
+		}
+		//push N onto CLOSED
+		status[current] = NODE_CLOSED;
+		explored++;
+		arena.load(current, current_state);
+		
+		//print out in case a long time is taken and wondering if it froze
+		if ((explored % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< explored <<" nodes..."<<std::endl;
+			
+		//if found, set report node to current node, set explored count to closed list size
+		if (kernel.is_goal(current_state.state))
+		{
+			report_goal(arena, kernel, current, report);
+			report.explored_count = explored;
+			if (!open.empty())
+				open.pop();
+			break;
+		}
+				
+		//stop if the search reached a limit of the solve, its queue, index
+		//and node status counted with the arena
+		if (budget.due())
+			budget.hold(open.bytes() + index.bytes() + (long)status.capacity());
+		if (budget.spent(current, current_state, explored, report))
+			break;
+		
+		//generate valid states
+		gen_valid_states(kernel, current_state, hfchoice, valid_states);
+		
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			const Successor<B> &temp_state = valid_states[i];
+			//a state already seen on the open or closed list is only
+			//kept again if this path to it is cheaper
+			uint32_t seen = index.find(arena, temp_state);
+			if (seen != NodeIndex::NOT_FOUND)
+			{
+				if (!cheaper(kernel.options.costs, temp_state, *arena.header(seen)))
+				{
+					report.rep_node_count++;
+					continue;
+				}
+				//a queued copy is skipped when popped, a closed one is
+				//reopened through the new node
+				if (status[seen] == NODE_OPEN)
+					stale_queued++;
+				status[seen] = NODE_STALE;
+			}
+			report.node_count++;
+			//add to the bucket of its hscore, after nodes with the
+			//same priority, used to maintain generated node order
+			uint32_t added = arena.add(temp_state, current);
+			index.set(arena, temp_state, added);
+			status.push_back(NODE_OPEN);
+			open.push(added, temp_state.hscore, tie_key(kernel.options.costs, temp_state));
+		}
+	}
+	report.fringe_node = open.size() - stale_queued;
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat as(const Kernel<B> &kernel, State &initial_state, int hfchoice, NodeArena &arena)
+
+/* AraEntry is a node on the open list of anytime repairing A* search,
+ *  keyed by 10 times its inflated f score so weights can be set in tenths.
+ *  order is when it was pushed, so nodes with the same key are expanded
+ *  in generated order.
+ */
+struct AraEntry
+{
+	int key;
+	uint32_t order;
+	uint32_t index;
+}; //struct AraEntry
+
+//std heaps keep the largest entry on top, so the order is reversed
+struct AraLater
+{
+	bool operator()(const AraEntry &a, const AraEntry &b) const
+	{
+		return a.key > b.key || (a.key == b.key && a.order > b.order);
+	}
+}; //struct AraLater
+
+/* Function used to find the lowest f score, cost plus heuristics function
+ *  3, of the nodes still to be expanded.  No solution costs less, so the
+ *  cost of the best solution found divided by it bounds how far from
+ *  optimal that solution can be.
+ * 
+ * Preconditions: arena of the search, open list, inconsistent list, flags
+ *  of the nodes replaced by cheaper copies
+ * Postconditions: returns the lowest f score, or -1 if none are left
+ */
+int ara_lowest_f(const NodeArena &arena, const std::vector<AraEntry> &open,
+ const std::vector<uint32_t> &incons, const std::vector<char> &stale)
+{
+	int lowest = -1;
+	for (std::vector<AraEntry>::size_type i = 0; i < open.size(); i++)
+	{
+		const NodeHeader *head = arena.header(open[i].index);
+		if (!stale[open[i].index] && (lowest < 0 || head->total_cost + head->hscore < lowest))
+			lowest = head->total_cost + head->hscore;
+	}
+	for (std::vector<uint32_t>::size_type i = 0; i < incons.size(); i++)
+	{
+		const NodeHeader *head = arena.header(incons[i]);
+		if (!stale[incons[i]] && (lowest < 0 || head->total_cost + head->hscore < lowest))
+			lowest = head->total_cost + head->hscore;
+	}
+	return lowest;
+} //int ara_lowest_f(const NodeArena &arena, const std::vector<AraEntry> &open, const std::vector<uint32_t> &incons, const std::vector<char> &stale)
+
+/* Function executes anytime repairing A* search (ARA*) on an initial
+ *  state.  It runs A* with f = cost + weight * h, heuristics function 3
+ *  inflated by a weight above 1, which finds a solution quickly but only
+ *  within weight times the lowest cost.  Each pass then lowers the weight
+ *  by the step of the options and repairs the search: nodes reached by a
+ *  cheaper path are expanded again, but nodes expanded in earlier passes
+ *  are not, so each pass only does the work the lower weight needs.  Once
+ *  the weight is 1 the last solution is optimal.  A node reached by a
+ *  cheaper path gets a new arena node, and the old one is marked stale
+ *  and skipped when popped.  Boxes on unsafe cells can never be pushed
+ *  to a goal, so those states are dropped.
+ *  Each better solution is given to options.improved and logged with its
+ *  bound, the most its cost can be over the lowest cost, as a factor.  If
+ *  a limit stops the search after a solution was found, that solution is
+ *  reported with the limit and its bound.
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, and the NodeArena to store the nodes in
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat ara(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	const SolverOptions &options = kernel.options;
+	std::vector<AraEntry> open;
+	std::vector<uint32_t> incons;
+	NodeIndex index(kernel.keyed());
+	//pass each node was expanded in, 0 if not yet, and replaced nodes
+	std::vector<int> closed_pass;
+	std::vector<char> stale;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	int move_cost, push_cost;
+	int weight = std::max(10, (int)(options.ara_weight * 10 + 0.5));
+	int step = std::max(1, (int)(options.ara_step * 10 + 0.5));
+	int pass = 1;
+	uint32_t order = 0, goal = NodeIndex::NOT_FOUND;
+	int goal_cost = 0;
+	long explored = 0;
+	
+	//push first state into queue, with its heuristics score
+	cost_model(options.costs, ARA, move_cost, push_cost);
+	uint32_t root = add_root(arena, kernel, initial_state);
+	arena.load(root, current_state);
+	arena.header(root)->hscore = current_state.hscore = h3(kernel, current_state.state, push_cost);
+	index.set(arena, current_state, root);
+	closed_pass.push_back(0);
+	stale.push_back(0);
+	if (kernel.is_goal(current_state.state))
+	{
+		report_goal(arena, kernel, root, report);
+		report.bound = 1;
+		return report;
+	}
+	AraEntry first = {weight * current_state.hscore, order++, root};
+	open.push_back(first);
+	
+	for (;;)
+	{
+		bool stopped = false;
+		int lowest;
+		uint32_t current = NodeIndex::NOT_FOUND;
+		
+		//expand nodes until no node can lead to a cheaper solution
+		//under this weight
+		while (!open.empty())
+		{
+			AraEntry top = open.front();
+			if (stale[top.index])
+			{
+				std::pop_heap(open.begin(), open.end(), AraLater());
+				open.pop_back();
+				continue;
+			}
+			if (goal != NodeIndex::NOT_FOUND && top.key >= 10 * goal_cost)
+				break;
+			std::pop_heap(open.begin(), open.end(), AraLater());
+			open.pop_back();
+			current = top.index;
+			closed_pass[current] = pass;
+			explored++;
+			arena.load(current, current_state);
+			
+			//print out in case a long time is taken and wondering if it froze
+			if ((explored % 5000) == 0 && options.log)
+				*options.log << "...explored "<< explored <<" nodes..."<<std::endl;
+			
+			//stop if the search reached a limit of the solve, its lists and
+			//index counted with the arena
+			if (budget.due())
+				budget.hold((long)open.capacity() * sizeof(AraEntry) +
+				 (long)incons.capacity() * sizeof(uint32_t) + (long)closed_pass.capacity() * sizeof(int) +
+				 (long)stale.capacity() + index.bytes());
+			if (budget.spent(current, current_state, explored, report))
+			{
+				stopped = true;
+				break;
+			}
+			current = NodeIndex::NOT_FOUND;
+			
+			gen_valid_states(kernel, current_state, ARA, valid_states);
+			for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+			{
+				const Successor<B> &temp_state = valid_states[i];
+				//boxes on unsafe cells never reach a goal
+				if (temp_state.state.boxes.count_and(kernel.unsafe) > 0)
+					continue;
+				//a state already reached is only kept if this path is cheaper
+				uint32_t seen = index.find(arena, temp_state);
+				if (seen != NodeIndex::NOT_FOUND)
+				{
+					if (arena.header(seen)->total_cost <= temp_state.total_cost)
+					{
+						report.rep_node_count++;
+						continue;
+					}
+					stale[seen] = 1;
+				}
+				uint32_t added = arena.add(temp_state, top.index);
+				index.set(arena, temp_state, added);
+				closed_pass.push_back(0);
+				stale.push_back(0);
+				report.node_count++;
+				//goals are not expanded, only kept if cheapest so far
+				if (kernel.is_goal(temp_state.state))
+				{
+					if (goal == NodeIndex::NOT_FOUND || temp_state.total_cost < goal_cost)
+					{
+						goal = added;
+						goal_cost = temp_state.total_cost;
+					}
+					continue;
+				}
+				//a node expanded in this pass waits for the next one
+				if (seen != NodeIndex::NOT_FOUND && closed_pass[seen] == pass)
+					incons.push_back(added);
+				else
+				{
+					AraEntry entry = {10 * temp_state.total_cost + weight * temp_state.hscore,
+					 order++, added};
+					open.push_back(entry);
+					std::push_heap(open.begin(), open.end(), AraLater());
+				}
+			}
+		}
+		
+		//the node stopped at was not expanded, so it still bounds the cost
+		lowest = ara_lowest_f(arena, open, incons, stale);
+		if (current != NodeIndex::NOT_FOUND)
+		{
+			const NodeHeader *head = arena.header(current);
+			if (lowest < 0 || head->total_cost + head->hscore < lowest)
+				lowest = head->total_cost + head->hscore;
+		}
+		if (goal == NodeIndex::NOT_FOUND)
+			break;
+		double ratio = (lowest < 0 || lowest >= goal_cost) ? 1 : (double)goal_cost / lowest;
+		//a finished pass also keeps its solution within the weight, and
+		//solutions only get cheaper, so bounds of earlier passes still hold
+		if (!stopped)
+			ratio = std::min(ratio, weight / 10.0);
+		report.bound = report.bound > 0 ? std::min(report.bound, ratio) : ratio;
+		//tell the caller about a solution better than the last one
+		if (report.node.state_str == "NULL" || goal_cost < report.node.total_cost)
+		{
+			report_goal(arena, kernel, goal, report);
+			if (options.log)
+				*options.log << "  Weight " << weight / 10.0 << ": solution cost " << goal_cost
+					<< ", within " << report.bound << " of optimal" << std::endl;
+			if (options.improved)
+				options.improved(report.node, report.bound, options.improved_context);
+		}
+		if (stopped || weight == 10 || report.bound == 1)
+			break;
+		
+		//lower the weight, and queue the inconsistent nodes again with
+		//every open node under the new weight
+		weight = std::max(10, weight - step);
+		pass++;
+		for (std::vector<uint32_t>::size_type i = 0; i < incons.size(); i++)
+		{
+			AraEntry entry = {0, order++, incons[i]};
+			open.push_back(entry);
+		}
+		incons.clear();
+		std::vector<AraEntry> requeued;
+		for (std::vector<AraEntry>::size_type i = 0; i < open.size(); i++)
+		{
+			if (stale[open[i].index])
+				continue;
+			const NodeHeader *head = arena.header(open[i].index);
+			open[i].key = 10 * head->total_cost + weight * head->hscore;
+			requeued.push_back(open[i]);
+		}
+		open.swap(requeued);
+		std::make_heap(open.begin(), open.end(), AraLater());
+	}
+	report.explored_count = explored;
+	report.fringe_node = open.size() + incons.size();
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat ara(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+
+/* BeamRank orders the successors of a beam search layer by heuristics
+ *  score, and then by the order they were generated in.
+ */
+struct BeamRank
+{
+	int hscore;
+	uint32_t order;
+
+	bool operator<(const BeamRank &other) const
+	{
+		return hscore < other.hscore || (hscore == other.hscore && order < other.order);
+	}
+}; //struct BeamRank
+
+/* Function used to score a state for beam search with the heuristics
+ *  function chosen in the options.
+ * 
+ * Preconditions: Kernel of the level, BoardState object
+ * Postconditions: int return representing heuristics score
+ */
+template <class B>
+int beam_score(const Kernel<B> &kernel, const BoardState<B> &state)
+{
+	switch (kernel.options.beam_heuristic)
+	{
+		case 2:
+			return h2(kernel, state);
+		case 3:
+			return h3(kernel, state, 1);
+	}
+	return h1(kernel, state);
+} //int beam_score(const Kernel<B> &kernel, const BoardState<B> &state)
+
+/* Function executes beam search on an initial state.  The search goes one
+ *  depth at a time, like breadth first search, but of the successors of a
+ *  depth only the options.beam_width best, by the heuristics function of
+ *  options.beam_heuristic, are kept and expanded next.  States seen at an
+ *  earlier depth and states with a box on an unsafe cell are dropped.  A
+ *  depth holds at most beam_width nodes, so the memory of the search
+ *  grows with the width times the depth of the solution instead of with
+ *  the states of the level.  Beam search is not complete: if a depth is
+ *  left empty after successors were cut, the width is doubled and the
+ *  search restarted if options.beam_retry is set, and otherwise the search
+ *  is exhausted with LIMIT_WIDTH.  If nothing was ever cut, every state
+ *  was searched and the level is unsolvable.  Each restart empties the
+ *  arena, so only the nodes of the last pass are held.
+ * 
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, and the NodeArena to store the nodes in
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat beam(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	const SolverOptions &options = kernel.options;
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 0;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = std::max(1, options.beam_width);
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	long explored = 0;
+	
+	for (int pass = 0; ; pass++)
+	{
+		std::vector<uint32_t> layer, next;
+		std::vector< Successor<B> > candidates;
+		std::vector<uint32_t> parents;
+		std::vector<BeamRank> ranks;
+		NodeIndex seen(kernel.keyed());
+		bool cut = false, stopped = false;
+		uint32_t goal = NodeIndex::NOT_FOUND;
+		
+		if (pass > 0)
+		{
+			arena.reset(kernel.cells, kernel.keyed());
+			budget.restart();
+		}
+		if (options.log)
+			*options.log << "  Beam width " << report.beam_width << ", heuristics function "
+				<< (options.beam_heuristic == 2 || options.beam_heuristic == 3 ?
+				options.beam_heuristic : 1) << std::endl;
+		uint32_t root = add_root(arena, kernel, initial_state);
+		arena.load(root, current_state);
+		seen.set(arena, current_state, root);
+		report.node_count++;
+		if (kernel.is_goal(current_state.state))
+			goal = root;
+		else
+			layer.push_back(root);
+		
+		while (!layer.empty() && goal == NodeIndex::NOT_FOUND)
+		{
+			//generate every successor of the depth
+			candidates.clear();
+			parents.clear();
+			ranks.clear();
+			for (std::vector<uint32_t>::size_type i = 0; i < layer.size(); i++)
+			{
+				arena.load(layer[i], current_state);
+				explored++;
+				
+				//print out in case a long time is taken and wondering if it froze
+				if ((explored % 5000) == 0 && options.log)
+					*options.log << "...explored "<< explored <<" nodes..."<<std::endl;
+				
+				//stop if the search reached a limit of the solve, the depths
+				//and the successors made so far counted with the arena
+				if (budget.due())
+					budget.hold((long)(layer.capacity() + next.capacity() + parents.capacity()) *
+					 sizeof(uint32_t) + (long)candidates.capacity() * sizeof(Successor<B>) +
+					 (long)ranks.capacity() * sizeof(BeamRank) + seen.bytes());
+				if (budget.spent(layer[i], current_state, explored, report))
+				{
+					stopped = true;
+					break;
+				}
+				
+				gen_valid_states(kernel, current_state, BEAM, valid_states);
+				for (typename std::vector< Successor<B> >::size_type j = 0; j < valid_states.size(); j++)
+				{
+					Successor<B> &temp_state = valid_states[j];
+					//boxes on unsafe cells never reach a goal
+					if (temp_state.state.boxes.count_and(kernel.unsafe) > 0)
+						continue;
+					if (seen.find(arena, temp_state) != NodeIndex::NOT_FOUND)
+					{
+						report.rep_node_count++;
+						continue;
+					}
+					temp_state.hscore = beam_score(kernel, temp_state.state);
+					BeamRank rank = {temp_state.hscore, (uint32_t)candidates.size()};
+					ranks.push_back(rank);
+					candidates.push_back(temp_state);
+					parents.push_back(layer[i]);
+				}
+			}
+			if (stopped)
+				break;
+			
+			//keep the best of the depth, the ones past the width are cut
+			std::vector<BeamRank>::size_type keep = ranks.size();
+			if (keep > (std::vector<BeamRank>::size_type)report.beam_width)
+			{
+				keep = report.beam_width;
+				std::partial_sort(ranks.begin(), ranks.begin() + keep, ranks.end());
+				cut = true;
+			}
+			else
+				std::sort(ranks.begin(), ranks.end());
+			next.clear();
+			for (std::vector<BeamRank>::size_type i = 0; i < keep; i++)
+			{
+				const Successor<B> &temp_state = candidates[ranks[i].order];
+				//two parents of a depth can make the same state
+				if (seen.find(arena, temp_state) != NodeIndex::NOT_FOUND)
+				{
+					report.rep_node_count++;
+					continue;
+				}
+				uint32_t added = arena.add(temp_state, parents[ranks[i].order]);
+				seen.set(arena, temp_state, added);
+				report.node_count++;
+				if (kernel.is_goal(temp_state.state))
+				{
+					goal = added;
+					break;
+				}
+				next.push_back(added);
+			}
+			layer.swap(next);
+		}
+		
+		if (goal != NodeIndex::NOT_FOUND)
+			report_goal(arena, kernel, goal, report);
+		report.fringe_node = layer.size();
+		if (goal != NodeIndex::NOT_FOUND || stopped || !cut)
+			break;
+		//the depths were cut too far to find the goal
+		if (!options.beam_retry || report.beam_width > (1 << 29))
+		{
+			budget.stop(LIMIT_WIDTH, explored, report);
+			break;
+		}
+		if (options.log)
+			*options.log << "  No solution within width " << report.beam_width
+				<< ", retrying with width " << report.beam_width * 2 << std::endl;
+		report.beam_width *= 2;
+	}
+	report.explored_count = explored;
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat beam(const Kernel<B> &kernel, State &initial_state, NodeArena &arena)
+
+/* Frontier search runs breadth first search or A* search without keeping
+ *  every node.  Nodes are expanded in the order of those searches, by
+ *  depth, or by f score and then tie key, from a BucketQueue, and each
+ *  run of nodes expanded with the same key is a layer.  Only the open
+ *  nodes and the closed nodes of the current layer and the last
+ *  options.frontier_layers layers before it are kept, in a FrontierSet,
+ *  so duplicates are found among them and older layers are freed.  A
+ *  step without a push can be taken back, so a state it reaches was a
+ *  child of it one layer before, and a breadth first layer only reaches
+ *  the layer before it that way.  A push can not be taken back, so the
+ *  states a push can reach are kept in a PushSet instead, a few bytes
+ *  each, until every push into them was made, and breadth first search
+ *  with one layer kept finds every duplicate.  A* search needs as many
+ *  layers as a step can change the f score by, see frontier_min_layers,
+ *  and is given that many if asked for fewer.  Nodes keep no parent,
+ *  only their relay: the last node on their path at a depth from the
+ *  start that is a power of 2, kept in the NodeArena of the search with
+ *  its own relay as parent.  The path to the goal is rebuilt by searching
+ *  again from each relay to the next, each of those searches splitting
+ *  its stretch at its own relays in turn, until relays are one step apart
+ *  (divide and conquer).
+ */
+
+/* FrontierHeader is the fixed part of a node of frontier search.  relay
+ *  is the arena index of its relay, status its node_status, set to
+ *  NODE_STALE once the node no longer holds its state in the index, and
+ *  flags has PUSH_HELD once a push reached its state, so the PushSet of
+ *  the search has taken the state already.
+ */
+const int32_t PUSH_HELD = 1;
+
+struct FrontierHeader
+{
+	uint32_t relay;
+	int32_t status;
+	int32_t depth;
+	int32_t moves;
+	int32_t pushes;
+	int32_t total_cost;
+	int32_t hscore;
+	int32_t flags;
+}; //struct FrontierHeader
+
+/* FrontierSet holds the nodes of frontier search as fixed size records
+ *  in slabs, the way a NodeArena does: a FrontierHeader followed by the
+ *  state and, if keyed, the symmetry key, packed by the arena of the
+ *  search.  Unlike the arena, nodes are freed one at a time and their
+ *  records reused, so the slabs only grow with the most nodes held at
+ *  once.  An open addressing hash table with linear probing, kept at most
+ *  half full, finds the node holding a state.  Unlinking a node shifts
+ *  the slots after it back, so the table needs no tombstones.
+ */
+class FrontierSet
+{
+public:
+	static const uint32_t NOT_FOUND = 0xffffffff;
+
+	FrontierSet(const NodeArena &arena, const CellMap &cells, const bool keyed);
+	~FrontierSet();
+	template <class B> uint32_t add(const Successor<B> &node, const uint32_t relay);
+	template <class B> uint32_t find(const Successor<B> &node) const;
+	template <class B> void load(const uint32_t index, Successor<B> &node) const;
+	FrontierHeader *header(const uint32_t index) const { return (FrontierHeader *)record(index); }
+	void unlink(const uint32_t index);
+	void remove(const uint32_t index);
+	uint32_t size() const { return live; }
+	long bytes() const;
+
+private:
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t index;
+
+		Slot() : hash(0), index(NOT_FOUND) {}
+	};
+	static const uint32_t NODES_PER_SLAB = 4096;
+	const NodeArena &arena;
+	std::string::size_type state_len;
+	std::string::size_type key_len;
+	std::string::size_type node_size;
+	uint32_t used;
+	uint32_t live;
+	uint32_t linked;
+	std::vector<char *> slabs;
+	std::vector<uint32_t> free_nodes;
+	std::vector<Slot> slots;
+
+	char *record(const uint32_t index) const
+	{
+		return slabs[index / NODES_PER_SLAB] + (index % NODES_PER_SLAB) * node_size;
+	}
+	//the words nodes are compared by, the key if there is one
+	const uint64_t *key(const uint32_t index) const
+	{
+		return (const uint64_t *)(record(index) + sizeof(FrontierHeader) + (key_len > 0 ? state_len : 0));
+	}
+	uint32_t hash(const uint64_t *key) const;
+	void link(const uint32_t index);
+	void grow();
+	FrontierSet(const FrontierSet &);
+	FrontierSet &operator=(const FrontierSet &);
+}; //class FrontierSet
+
+FrontierSet::FrontierSet(const NodeArena &arena, const CellMap &cells, const bool keyed)
+ : arena(arena), state_len((cells.words + 1) * 8), key_len(keyed ? state_len : 0),
+ node_size(sizeof(FrontierHeader) + state_len + key_len), used(0), live(0), linked(0), slots(1024)
+{
+}
+
+FrontierSet::~FrontierSet()
+{
+	for (std::vector<char *>::size_type i = 0; i < slabs.size(); i++)
+		delete [] slabs[i];
+}
+
+/* Function used to hash a packed state or key one 64 bit word at a time.
+ *
+ * Preconditions: packed state or key
+ * Postconditions: returns the hash of the state
+ */
+uint32_t FrontierSet::hash(const uint64_t *key) const
+{
+	uint64_t h = 0;
+	for (std::string::size_type i = 0; i < state_len / 8; i++)
+		h = (h ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+/* Function used to add a node, reusing the record of a freed node if
+ *  there is one.  No node may hold its state yet, a node holding it has
+ *  to be unlinked first.
+ *
+ * Preconditions: Successor object, arena index of its relay
+ * Postconditions: returns the index of the new open node, which holds
+ *  its state in the index
+ */
+template <class B>
+uint32_t FrontierSet::add(const Successor<B> &node, const uint32_t relay)
+{
+	uint32_t index;
+	if (!free_nodes.empty())
+	{
+		index = free_nodes.back();
+		free_nodes.pop_back();
+	}
+	else
+	{
+		if (used / NODES_PER_SLAB == slabs.size())
+			slabs.push_back(new char[NODES_PER_SLAB * node_size]);
+		index = used++;
+	}
+
+	char *rec = record(index);
+	FrontierHeader *head = (FrontierHeader *)rec;
+	head->relay = relay;
+	head->status = NODE_OPEN;
+	head->depth = node.depth;
+	head->moves = node.moves;
+	head->pushes = node.pushes;
+	head->total_cost = node.total_cost;
+	head->hscore = node.hscore;
+	head->flags = 0;
+	uint64_t packed[B::WORDS + 1];
+	arena.pack(node.state, packed);
+	memcpy(rec + sizeof(FrontierHeader), packed, state_len);
+	if (key_len > 0)
+	{
+		arena.pack(node.key, packed);
+		memcpy(rec + sizeof(FrontierHeader) + state_len, packed, key_len);
+	}
+	live++;
+	link(index);
+	return index;
+} //uint32_t FrontierSet::add(const Successor<B> &node, const uint32_t relay)
+
+void FrontierSet::link(const uint32_t index)
+{
+	if ((linked + 1) * 2 > slots.size())
+		grow();
+	uint32_t h = hash(key(index)), mask = slots.size() - 1, i = h & mask;
+	while (slots[i].index != NOT_FOUND)
+		i = (i + 1) & mask;
+	slots[i].hash = h;
+	slots[i].index = index;
+	linked++;
+}
+
+void FrontierSet::grow()
+{
+	std::vector<Slot> old(slots.size() * 2);
+	old.swap(slots);
+	uint32_t mask = slots.size() - 1;
+	for (std::vector<Slot>::size_type j = 0; j < old.size(); j++)
+	{
+		if (old[j].index == NOT_FOUND)
+			continue;
+		uint32_t i = old[j].hash & mask;
+		while (slots[i].index != NOT_FOUND)
+			i = (i + 1) & mask;
+		slots[i] = old[j];
+	}
+}
+
+/* Function used to find the node holding a state.
+ *
+ * Preconditions: Successor object, with its key set if keyed
+ * Postconditions: returns the node index, or NOT_FOUND
+ */
+template <class B>
+uint32_t FrontierSet::find(const Successor<B> &node) const
+{
+	uint64_t packed[B::WORDS + 1];
+	if (key_len > 0)
+		arena.pack(node.key, packed);
+	else
+		arena.pack(node.state, packed);
+	uint32_t h = hash(packed), mask = slots.size() - 1;
+	for (uint32_t i = h & mask; slots[i].index != NOT_FOUND; i = (i + 1) & mask)
+		if (slots[i].hash == h && memcmp(key(slots[i].index), packed, state_len) == 0)
+			return slots[i].index;
+	return NOT_FOUND;
+} //uint32_t FrontierSet::find(const Successor<B> &node) const
+
+/* Function used to unpack a node into a Successor object to expand it.
+ *  The path is left empty.
+ *
+ * Preconditions: node index, Successor object to unpack into
+ * Postconditions: Successor object set from the node
+ */
+template <class B>
+void FrontierSet::load(const uint32_t index, Successor<B> &node) const
+{
+	const char *rec = record(index);
+	const FrontierHeader *head = (const FrontierHeader *)rec;
+	uint64_t packed[B::WORDS + 1];
+	memcpy(packed, rec + sizeof(FrontierHeader), state_len);
+	arena.unpack(packed, node.state);
+	node.key = node.state;
+	if (key_len > 0)
+	{
+		memcpy(packed, rec + sizeof(FrontierHeader) + state_len, key_len);
+		arena.unpack(packed, node.key);
+	}
+	node.path.clear();
+	node.depth = head->depth;
+	node.moves = head->moves;
+	node.pushes = head->pushes;
+	node.total_cost = head->total_cost;
+	node.hscore = head->hscore;
+} //void FrontierSet::load(const uint32_t index, Successor<B> &node) const
+
+/* Function used to take a node out of the index, when a cheaper copy of
+ *  its state replaces it.  Each slot after it in its run moves back into
+ *  the hole if the hole is between its home slot and it.
+ *
+ * Preconditions: index of a node holding its state
+ * Postconditions: node is stale and no longer found
+ */
+void FrontierSet::unlink(const uint32_t index)
+{
+	uint32_t mask = slots.size() - 1, i = hash(key(index)) & mask;
+	while (slots[i].index != index)
+		i = (i + 1) & mask;
+	for (uint32_t j = (i + 1) & mask; slots[j].index != NOT_FOUND; j = (j + 1) & mask)
+	{
+		if (((j - (slots[j].hash & mask)) & mask) >= ((j - i) & mask))
+		{
+			slots[i] = slots[j];
+			i = j;
+		}
+	}
+	slots[i] = Slot();
+	linked--;
+	header(index)->status = NODE_STALE;
+} //void FrontierSet::unlink(const uint32_t index)
+
+/* Function used to free a node, unlinking it first if it still holds its
+ *  state.  Its record is reused by the next node added.
+ *
+ * Preconditions: node index
+ * Postconditions: node freed
+ */
+void FrontierSet::remove(const uint32_t index)
+{
+	if (header(index)->status != NODE_STALE)
+		unlink(index);
+	free_nodes.push_back(index);
+	live--;
+} //void FrontierSet::remove(const uint32_t index)
+
+/* Function used to get the memory held by the set.
+ *
+ * Preconditions: none
+ * Postconditions: returns bytes of the slabs, the index and the free list
+ */
+long FrontierSet::bytes() const
+{
+	return (long)slabs.size() * NODES_PER_SLAB * node_size + (long)slots.size() * sizeof(Slot) +
+	 (long)free_nodes.capacity() * sizeof(uint32_t);
+} //long FrontierSet::bytes() const
+
+/* PushSet holds the states of frontier search a push can still reach,
+ *  with the directions of the pushes that can end in each, as bits 0 to
+ *  3.  A push in direction d leaves the player behind a box it moved from
+ *  the cell behind it, so each direction has one state to come from, and
+ *  the push from it reaches the state once.  The bit is cleared by that
+ *  push, and once no bit is left no push reaches the state again, so it is
+ *  freed.  That needs each state to push into it only once, so where a
+ *  state can be expanded again, for A* search by heuristics function 1,
+ *  and where the directions can not be told, on symmetric levels and with
+ *  macro moves, states also hold PUSH_KEEP, which is never cleared.
+ *  States are kept the way VisitedSet keeps them, the player then one bit
+ *  per floor cell for the boxes, after a byte of directions, 0 for an
+ *  empty slot, in an open addressing table with linear probing grown by
+ *  doubling at 3/4 full.  Freeing a state shifts the slots after it back,
+ *  the way FrontierSet::unlink does.
+ */
+const int PUSH_KEEP = 16;
+
+class PushSet
+{
+public:
+	PushSet(const CellMap &cells);
+	bool held(const uint64_t *packed);
+	void add(const uint64_t *packed, const int directions);
+	bool take(const uint64_t *packed, const int dir);
+	long size() const { return count; }
+	long bytes() const { return (long)slots.capacity() + (long)scratch.capacity() * sizeof(uint64_t); }
+
+private:
+	int words;
+	int player_bits;
+	std::string::size_type key_bytes;
+	std::string::size_type slot_bytes;
+	uint64_t slot_mask;
+	long count;
+	std::vector<uint8_t> slots;
+	std::vector<uint64_t> scratch;
+
+	const uint8_t *compact(const uint64_t *packed);
+	uint64_t home(const uint8_t *key) const;
+	uint64_t find(const uint8_t *key) const;
+	void erase(uint64_t i);
+	void grow();
+}; //class PushSet
+
+PushSet::PushSet(const CellMap &cells) : words(cells.words), slot_mask(1023), count(0)
+{
+	int floor = cells.grid.size();
+	for (player_bits = 1; (1 << player_bits) < floor; player_bits++)
+		;
+	key_bytes = (player_bits + floor + 7) / 8;
+	slot_bytes = key_bytes + 1;
+	slots.assign(1024 * slot_bytes, 0);
+	scratch.assign(words + 2, 0);
+}
+
+//the player in the low bits, the boxes shifted above it
+const uint8_t *PushSet::compact(const uint64_t *packed)
+{
+	uint64_t *key = &scratch[0];
+	memset(key, 0, scratch.size() * sizeof(uint64_t));
+	key[0] = packed[words];
+	for (int w = 0; w < words; w++)
+	{
+		key[w] |= packed[w] << player_bits;
+		key[w + 1] |= packed[w] >> (64 - player_bits);
+	}
+	return (const uint8_t *)key;
+}
+
+uint64_t PushSet::home(const uint8_t *key) const
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (std::string::size_type i = 0; i < key_bytes; i += 8)
+	{
+		uint64_t word = 0;
+		memcpy(&word, key + i, std::min((std::string::size_type)8, key_bytes - i));
+		h = (h ^ word) * 0x9E3779B97F4A7C15ULL;
+	}
+	return (h ^ (h >> 29)) & slot_mask;
+}
+
+//the slot holding the key, or the empty slot ending its run
+uint64_t PushSet::find(const uint8_t *key) const
+{
+	uint64_t i = home(key);
+	while (slots[i * slot_bytes] != 0 && memcmp(&slots[i * slot_bytes + 1], key, key_bytes) != 0)
+		i = (i + 1) & slot_mask;
+	return i;
+}
+
+/* Function used to check if a push can still reach a state.
+ *
+ * Preconditions: state packed by NodeArena::pack_key
+ * Postconditions: returns true if the state is held
+ */
+bool PushSet::held(const uint64_t *packed)
+{
+	return slots[find(compact(packed)) * slot_bytes] != 0;
+} //bool PushSet::held(const uint64_t *packed)
+
+/* Function used to hold a state with the directions of the pushes that
+ *  can still reach it.
+ *
+ * Preconditions: state packed by NodeArena::pack_key, not held, direction
+ *  bits, not 0
+ * Postconditions: state held
+ */
+void PushSet::add(const uint64_t *packed, const int directions)
+{
+	const uint8_t *key = compact(packed);
+	uint8_t *slot = &slots[find(key) * slot_bytes];
+	slot[0] = directions;
+	memcpy(slot + 1, key, key_bytes);
+	if (++count * 4 > (long)(slot_mask + 1) * 3)
+		grow();
+} //void PushSet::add(const uint64_t *packed, const int directions)
+
+/* Function used to take the push in a direction off a state, freeing the
+ *  state if no push can reach it any more.
+ *
+ * Preconditions: state packed by NodeArena::pack_key, direction 0 to 3 of
+ *  the push reaching it
+ * Postconditions: returns true if the state was held
+ */
+bool PushSet::take(const uint64_t *packed, const int dir)
+{
+	uint64_t i = find(compact(packed));
+	uint8_t *slot = &slots[i * slot_bytes];
+	if (slot[0] == 0)
+		return false;
+	slot[0] &= ~(1 << dir);
+	if (slot[0] == 0)
+		erase(i);
+	return true;
+} //bool PushSet::take(const uint64_t *packed, const int dir)
+
+void PushSet::erase(uint64_t i)
+{
+	for (uint64_t j = (i + 1) & slot_mask; slots[j * slot_bytes] != 0; j = (j + 1) & slot_mask)
+	{
+		if (((j - home(&slots[j * slot_bytes + 1])) & slot_mask) >= ((j - i) & slot_mask))
+		{
+			memcpy(&slots[i * slot_bytes], &slots[j * slot_bytes], slot_bytes);
+			i = j;
+		}
+	}
+	memset(&slots[i * slot_bytes], 0, slot_bytes);
+	count--;
+}
+
+void PushSet::grow()
+{
+	std::vector<uint8_t> old(slots.size() * 2, 0);
+	old.swap(slots);
+	slot_mask = slot_mask * 2 + 1;
+	for (std::string::size_type at = 0; at < old.size(); at += slot_bytes)
+		if (old[at] != 0)
+			memcpy(&slots[find(&old[at + 1]) * slot_bytes], &old[at], slot_bytes);
+}
+
+/* Function used to find the directions of the pushes that can end in a
+ *  state, that is where the player has a box just ahead and room behind
+ *  it to have come from.
+ *
+ * Preconditions: Kernel of the level, BoardState object
+ * Postconditions: returns bit d set for each direction d a push can end
+ *  in the state by
+ */
+template <class B>
+int push_directions(const Kernel<B> &kernel, const BoardState<B> &state)
+{
+	int directions = 0;
+	for (int dir = 0; dir < 4; dir++)
+	{
+		int behind = Kernel<B>::step(state.player, (dir + 2) & 3);
+		if (state.boxes.test(Kernel<B>::step(state.player, dir)) && !kernel.walls.test(behind) &&
+		 !state.boxes.test(behind))
+			directions |= 1 << dir;
+	}
+	return directions;
+} //int push_directions(const Kernel<B> &kernel, const BoardState<B> &state)
+
+/* Function used to find the fewest layers frontier search keeps.  A step
+ *  without a push is taken back by a step to its parent, which must still
+ *  be held then, so as many layers are kept as the key can change by in a
+ *  step: 1 for the depth of breadth first search, and for A* search the
+ *  cost of a move and as much as the heuristic can change, 1 for the
+ *  player distance of heuristics function 1, none for heuristics function
+ *  2, and the cheaper of a move and a push for target_h.
+ *
+ * Preconditions: CostModel in use, search mode (BFS, ASH1 or ASH2), true
+ *  if the search scores nodes by target_h
+ * Postconditions: returns the fewest layers to keep, at least 1
+ */
+int frontier_min_layers(const CostModel &costs, const int smode, const bool targeted)
+{
+	int move_cost, push_cost;
+
+	if (smode == BFS)
+		return 1;
+	cost_model(costs, smode, move_cost, push_cost);
+	if (targeted)
+		return std::max(1, move_cost + std::min(move_cost, push_cost));
+	return std::max(1, move_cost + (smode == ASH1 ? 1 : 0));
+} //int frontier_min_layers(const CostModel &costs, const int smode, const bool targeted)
+
+/* Function used to find a lower bound on the cost from a state to a
+ *  target state, for the searches rebuilding a path of frontier search.
+ *  A push moves one box one cell, so the boxes off the target boxes need
+ *  at least as many pushes as their Manhattan distances to the nearest
+ *  target box not yet covered, and the player at least its Manhattan
+ *  distance to its target cell in steps.
+ *
+ * Preconditions: BoardState objects of the state and the target, cost of
+ *  a move and a push
+ * Postconditions: returns the lower bound
+ */
+template <class B>
+int target_h(const BoardState<B> &state, const BoardState<B> &target, const int move_cost,
+ const int push_cost)
+{
+	int box_x[B::CELLS / 2 + 1], box_y[B::CELLS / 2 + 1];
+	int free_x[B::CELLS / 2 + 1], free_y[B::CELLS / 2 + 1];
+	int box_count = 0, free_count = 0, pushes = 0;
+
+	for (int w = 0; w < B::WORDS; w++)
+	{
+		uint64_t boxes = state.boxes.word[w];
+		uint64_t targets = target.boxes.word[w];
+		for (uint64_t bits = boxes & ~targets; bits; bits &= bits - 1)
+		{
+			int cell = w * 64 + __builtin_ctzll(bits);
+			box_x[box_count] = cell % B::WIDTH;
+			box_y[box_count++] = cell / B::WIDTH;
+		}
+		for (uint64_t bits = targets & ~boxes; bits; bits &= bits - 1)
+		{
+			int cell = w * 64 + __builtin_ctzll(bits);
+			free_x[free_count] = cell % B::WIDTH;
+			free_y[free_count++] = cell / B::WIDTH;
+		}
+	}
+	for (int i = 0; i < box_count; i++)
+	{
+		int nearest = B::WIDTH + B::HEIGHT;
+		for (int j = 0; j < free_count; j++)
+			nearest = std::min(nearest, abs(box_x[i] - free_x[j]) + abs(box_y[i] - free_y[j]));
+		pushes += nearest;
+	}
+	int steps = abs(state.player % B::WIDTH - target.player % B::WIDTH) +
+	 abs(state.player / B::WIDTH - target.player / B::WIDTH);
+	return std::max(pushes * push_cost, steps * std::min(move_cost, push_cost));
+} //int target_h(const BoardState<B> &state, const BoardState<B> &target, const int move_cost, const int push_cost)
+
+/* Function used to run one frontier search from a start node.  Without a
+ *  target it ends at a goal state.  With a target it ends at exactly that
+ *  state, so states are not compared by symmetry key, and drops nodes
+ *  whose key is above bound: A* search then scores nodes by target_h in
+ *  place of its heuristics function, and breadth first search drops the
+ *  nodes target_h shows can not reach the target within bound, unless
+ *  macro moves make one step more than one cell.
+ *
+ * Preconditions: Kernel of the level, start node, search mode (BFS, ASH1
+ *  or ASH2), target state or NULL, bound on the key of the nodes if there
+ *  is a target, arena holding only the start as its root, SearchBudget
+ *  of the search or NULL for no limits, SearchStat to count nodes in
+ * Postconditions: returns the arena index of the goal or target node,
+ *  with its relay as parent, or NOT_FOUND if none was found or a limit
+ *  stopped the search
+ */
+template <class B>
+uint32_t frontier_run(const Kernel<B> &kernel, const Successor<B> &start, const int smode,
+ const BoardState<B> *target, const int bound, NodeArena &arena, SearchBudget<B> *budget,
+ SearchStat &report)
+{
+	const int gen_mode = smode == BFS ? NONE : smode;
+	const int keep = std::max(kernel.options.frontier_layers,
+	 frontier_min_layers(kernel.options.costs, smode, target != NULL));
+	//a state is only freed from the push set once every push into it was
+	//made, which holds if each state is expanded once, so not for A*
+	//search by heuristics function 1, which may find a cheaper path to a
+	//state it expanded, and the pushes into a state can only be told
+	//apart one cell at a time, on the board itself
+	const int keep_pushed = (smode == ASH1 && target == NULL) || kernel.keyed() ||
+	 kernel.options.macro_moves ? PUSH_KEEP : 0;
+	FrontierSet nodes(arena, kernel.cells, target == NULL && kernel.keyed());
+	PushSet pushed(kernel.cells);
+	BucketQueue open;
+	std::deque< std::vector<uint32_t> > layers;
+	int layer_key = 0, move_cost = 1, push_cost = 1;
+	long explored = 0, stale_queued = 0;
+	uint32_t found = FrontierSet::NOT_FOUND;
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+
+	if (smode != BFS)
+		cost_model(kernel.options.costs, smode, move_cost, push_cost);
+	//push first state into queue
+	uint32_t current = nodes.add(start, 0);
+	open.push(current, smode == BFS ? start.depth : start.hscore,
+	 smode == BFS ? 0 : tie_key(kernel.options.costs, start));
+	while (!open.empty())
+	{
+		//take N from OPEN, freeing nodes replaced by a cheaper copy
+		current = open.pop();
+		FrontierHeader *head = nodes.header(current);
+		if (head->status == NODE_STALE)
+		{
+			nodes.remove(current);
+			stale_queued--;
+			continue;
+		}
+		nodes.load(current, current_state);
+
+		//a new key starts a layer, freeing the layers past the ones kept
+		int key = smode == BFS ? current_state.depth : current_state.hscore;
+		if (layers.empty() || key != layer_key)
+		{
+			layers.push_back(std::vector<uint32_t>());
+			layer_key = key;
+			while ((int)layers.size() > keep + 1)
+			{
+				for (std::vector<uint32_t>::size_type i = 0; i < layers.front().size(); i++)
+					nodes.remove(layers.front()[i]);
+				layers.pop_front();
+			}
+		}
+		//push N onto CLOSED
+		head->status = NODE_CLOSED;
+		layers.back().push_back(current);
+		explored++;
+		//a state no push reached yet is held for the pushes that can
+		uint64_t packed[B::WORDS + 1];
+		int directions = push_directions(kernel, current_state.state);
+		if (directions != 0 && !(head->flags & PUSH_HELD))
+		{
+			arena.pack_key(current_state, packed);
+			if (!pushed.held(packed))
+				pushed.add(packed, directions | keep_pushed);
+			head->flags |= PUSH_HELD;
+		}
+
+		//print out in case a long time is taken and wondering if it froze
+		if (budget != NULL && (explored % 5000) == 0 && kernel.options.log)
+			*kernel.options.log << "...explored "<< explored <<" nodes..."<<std::endl;
+
+		//if found, keep the node in the arena to rebuild its path from
+		if (target != NULL ? memcmp(&current_state.state, target, sizeof(BoardState<B>)) == 0 :
+		 kernel.is_goal(current_state.state))
+		{
+			found = arena.add(current_state, head->relay);
+			break;
+		}
+
+		//stop if the search reached a limit of the solve, the best node
+		//is kept in the arena to report its path
+		if (budget != NULL)
+		{
+			if (budget->due())
+				budget->hold(nodes.bytes() + pushed.bytes() + open.bytes());
+			uint32_t best = budget->better(current_state) ? arena.add(current_state, head->relay) : 0;
+			if (budget->spent(best, current_state, explored, report))
+				break;
+		}
+
+		//nodes at a power of 2 steps from the start are relays
+		uint32_t relay = head->relay;
+		int steps = current_state.depth - start.depth;
+		if (steps > 0 && (steps & (steps - 1)) == 0)
+			relay = arena.add(current_state, relay);
+
+		//generate valid states
+		gen_valid_states(kernel, current_state, gen_mode, valid_states);
+
+		//for each generated state
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+		{
+			Successor<B> &temp_state = valid_states[i];
+			//nodes that can not reach the target within the bound are dropped
+			if (target != NULL)
+			{
+				int left = target_h(temp_state.state, *target, move_cost, push_cost);
+				if (smode != BFS)
+					temp_state.hscore = temp_state.total_cost + left;
+				else if (kernel.options.macro_moves)
+					left = 0;
+				if ((smode == BFS ? temp_state.depth + left : temp_state.hscore) > bound)
+					continue;
+			}
+			//a state held is only kept again if this path to it is cheaper,
+			//which breadth first search never finds, and a state reached by
+			//a push that the PushSet still holds was freed with its layer
+			bool push = temp_state.pushes > current_state.pushes, new_push = false;
+			if (push)
+			{
+				int dir = 0;
+				while (!keep_pushed && Kernel<B>::step(current_state.state.player, dir) !=
+				 temp_state.state.player)
+					dir++;
+				arena.pack_key(temp_state, packed);
+				new_push = !pushed.take(packed, dir);
+				int left = (push_directions(kernel, temp_state.state) & ~(1 << dir)) | keep_pushed;
+				if (new_push && left != 0)
+					pushed.add(packed, left);
+			}
+			uint32_t seen = nodes.find(temp_state);
+			if (seen == FrontierSet::NOT_FOUND && push && !new_push)
+			{
+				report.rep_node_count++;
+				continue;
+			}
+			if (seen != FrontierSet::NOT_FOUND && push)
+				nodes.header(seen)->flags |= PUSH_HELD;
+			if (seen != FrontierSet::NOT_FOUND)
+			{
+				if (smode == BFS || !cheaper(kernel.options.costs, temp_state, *nodes.header(seen)))
+				{
+					report.rep_node_count++;
+					continue;
+				}
+				//a queued copy is freed when popped, a closed one with its layer
+				if (nodes.header(seen)->status == NODE_OPEN)
+					stale_queued++;
+				nodes.unlink(seen);
+			}
+			report.node_count++;
+			uint32_t added = nodes.add(temp_state, relay);
+			if (push || (seen != FrontierSet::NOT_FOUND && (nodes.header(seen)->flags & PUSH_HELD)))
+				nodes.header(added)->flags |= PUSH_HELD;
+			open.push(added, smode == BFS ? temp_state.depth : temp_state.hscore,
+			 smode == BFS ? 0 : tie_key(kernel.options.costs, temp_state));
+		}
+		if ((long)nodes.size() > report.frontier_nodes)
+			report.frontier_nodes = nodes.size();
+	}
+	report.explored_count = explored;
+	report.fringe_node = open.size() - stale_queued;
+	report.frontier_bytes = std::max(report.frontier_bytes, nodes.bytes() + pushed.bytes());
+	return found;
+} //uint32_t frontier_run(const Kernel<B> &kernel, const Successor<B> &start, const int smode, const BoardState<B> *target, const int bound, NodeArena &arena, SearchBudget<B> *budget, SearchStat &report)
+
+template <class B>
+bool frontier_path(const Kernel<B> &kernel, const int smode, const NodeArena &arena,
+ const uint32_t index, Successor<B> &end);
+
+/* Function used to find the moves between two relays of frontier search.
+ *  Relays one step apart are a parent and its child, so the child is
+ *  found among the children of the first, otherwise the stretch is
+ *  searched again with the second relay as target, bounded by the depth
+ *  or cost it took, and its path rebuilt the same way.
+ *
+ * Preconditions: Kernel of the level, search mode, Successor object at
+ *  the state of the first relay, the two relays as they were found
+ * Postconditions: returns true and moves node to the second relay, with
+ *  the moves of the stretch in its path, if they were found
+ */
+template <class B>
+bool frontier_segment(const Kernel<B> &kernel, const int smode, Successor<B> &node,
+ const Successor<B> &from, const Successor<B> &to)
+{
+	node.path.clear();
+	if (to.depth == from.depth)
+		return true;
+	if (to.depth == from.depth + 1)
+	{
+		std::vector< Successor<B> > valid_states;
+		gen_valid_states(kernel, node, smode == BFS ? NONE : smode, valid_states);
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+			if (memcmp(&valid_states[i].state, &to.state, sizeof(BoardState<B>)) == 0)
+			{
+				node = valid_states[i];
+				return true;
+			}
+		return false;
+	}
+
+	NodeArena arena;
+	SearchStat stretch;
+	stretch.node_count = stretch.rep_node_count = stretch.explored_count = stretch.fringe_node = 0;
+	stretch.frontier_nodes = stretch.frontier_bytes = 0;
+	stretch.limit = LIMIT_NONE;
+	int bound = smode == BFS ? node.depth + to.depth - from.depth :
+	 node.total_cost + to.total_cost - from.total_cost;
+	arena.reset(kernel.cells, false);
+	arena.add(node, 0);
+	uint32_t found = frontier_run(kernel, node, smode, &to.state, bound, arena,
+	 (SearchBudget<B> *)NULL, stretch);
+	return found != FrontierSet::NOT_FOUND && frontier_path(kernel, smode, arena, found, node);
+} //bool frontier_segment(const Kernel<B> &kernel, const int smode, Successor<B> &node, const Successor<B> &from, const Successor<B> &to)
+
+/* Function used to rebuild the path of frontier search to a node of its
+ *  arena.  The relays from the root to the node are the waypoints of the
+ *  path, and the stretch between each two is found by frontier_segment.
+ *  The counts of the end node are those of the path rebuilt.
+ *
+ * Preconditions: Kernel of the level, search mode, arena of the search,
+ *  arena index of the node, Successor object to store the end in
+ * Postconditions: returns true and sets end, with the moves of the whole
+ *  path in its path, if the path was rebuilt
+ */
+template <class B>
+bool frontier_path(const Kernel<B> &kernel, const int smode, const NodeArena &arena,
+ const uint32_t index, Successor<B> &end)
+{
+	std::vector<uint32_t> waypoints(1, index);
+	while (arena.header(waypoints.back())->parent != waypoints.back())
+		waypoints.push_back(arena.header(waypoints.back())->parent);
+
+	std::string moves;
+	Successor<B> from, to;
+	arena.load(waypoints.back(), end);
+	for (std::vector<uint32_t>::size_type i = waypoints.size() - 1; i > 0; i--)
+	{
+		arena.load(waypoints[i], from);
+		arena.load(waypoints[i - 1], to);
+		if (!frontier_segment(kernel, smode, end, from, to))
+			return false;
+		moves += end.path;
+	}
+	end.path = moves;
+	return true;
+} //bool frontier_path(const Kernel<B> &kernel, const int smode, const NodeArena &arena, const uint32_t index, Successor<B> &end)
+
+/* Function used to fill in a State from the end of a path rebuilt by
+ *  frontier_path.
+ *
+ * Preconditions: Kernel of the level, end of the path, State to fill in
+ * Postconditions: State set, with the move list of the path
+ */
+template <class B>
+void frontier_state(const Kernel<B> &kernel, const Successor<B> &end, State &found)
+{
+	found.state_str = kernel.unload(end.state);
+	found.move_list.clear();
+	for (std::string::size_type i = 0; i < end.path.size(); i++)
+		found.move_list.append(1, end.path[i]) += ", ";
+	found.depth = end.depth;
+	found.moves = end.moves;
+	found.pushes = end.pushes;
+	found.total_cost = end.total_cost;
+	found.hscore = end.hscore;
+} //void frontier_state(const Kernel<B> &kernel, const Successor<B> &end, State &found)
+
+/* Function executes frontier search, breadth first search or A* search
+ *  keeping only the open nodes and the last layers of closed nodes, on an
+ *  initial state.  The arena only holds the relays of the search and the
+ *  best nodes explored, so the memory of the search grows with the width
+ *  of its frontier rather than with the nodes explored.
+ *
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, the search mode (BFS, ASH1 or ASH2), and the
+ *  NodeArena to store the relays in
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat frontier(const Kernel<B> &kernel, State &initial_state, const int smode, NodeArena &arena)
+{
+	arena.reset(kernel.cells, kernel.keyed());
+	SearchBudget<B> budget(kernel, arena);
+	SearchStat report;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	report.frontier_nodes = report.frontier_bytes = 0;
+	Successor<B> start, end;
+
+	//fewer layers than a step can change the key by would search a state
+	//again after its layer is freed, maybe for ever, so they are raised
+	int keep = frontier_min_layers(kernel.options.costs, smode, false);
+	if (kernel.options.frontier_layers < keep && kernel.options.log)
+		*kernel.options.log << "  Frontier search: keeping " << keep << " layers, the fewest a step needs"
+		 << std::endl;
+	arena.load(add_root(arena, kernel, initial_state), start);
+	uint32_t goal = frontier_run(kernel, start, smode, (const BoardState<B> *)NULL, 0, arena, &budget,
+	 report);
+	//the path of the goal, or of the best node if a limit stopped the search
+	if (goal != FrontierSet::NOT_FOUND && frontier_path(kernel, smode, arena, goal, end))
+		frontier_state(kernel, end, report.node);
+	else if (report.limit != LIMIT_NONE && frontier_path(kernel, smode, arena, budget.best_node(), end))
+		frontier_state(kernel, end, report.best);
+	report.arena_nodes = arena.size();
+	report.arena_bytes = arena.bytes();
+	return report;
+} //SearchStat frontier(const Kernel<B> &kernel, State &initial_state, const int smode, NodeArena &arena)
+
+/* Distributed search runs breadth first search, uniform cost search or A*
+ *  search on options.processes worker processes forked from the solving
+ *  process, which is their coordinator.  Each state is owned by one
+ *  worker, chosen by a hash of its packed state, or of its symmetry key,
+ *  so the duplicates of a state always meet at its owner, and each worker
+ *  holds only its share of the nodes.  The search runs in rounds: the
+ *  coordinator sends every worker the lowest key queued anywhere (the
+ *  depth, the cost, or the f score), and each worker expands its queued
+ *  nodes of that key.  Children owned by other workers are sent to them
+ *  in batches over Unix domain sockets, and a round ends with every worker
+ *  sending a done frame to every other, so when the coordinator has the
+ *  reports of all workers, no child is still on its way, and the search
+ *  is over when no worker has a node queued.  Nodes keep the worker and
+ *  node index of their parent, so the coordinator follows a solution back
+ *  to the root one worker at a time.
+ *
+ * Frames on every socket are a DistFrame and its payload.
+ */
+enum dist_frame {DIST_CHILDREN, DIST_DONE, DIST_ROUND, DIST_TRACE, DIST_GOAL, DIST_QUIT};
+
+const std::string::size_type DIST_BATCH = 65536;
+const std::string::size_type DIST_PENDING = 8 << 20;
+
+struct DistFrame
+{
+	uint32_t type;
+	uint32_t size;
+}; //struct DistFrame
+
+/* DistChild is the fixed part of a child sent to its owner, followed by
+ *  the packed state and the moves made from its parent.
+ */
+struct DistChild
+{
+	int32_t depth;
+	int32_t moves;
+	int32_t pushes;
+	int32_t total_cost;
+	int32_t hscore;
+	int32_t parent_worker;
+	uint32_t parent_index;
+	uint32_t path_len;
+}; //struct DistChild
+
+/* DistRound is what a worker reports after a round: the counts of its
+ *  search so far, the lowest key it has queued, if any, the goal it
+ *  expanded in the round, if any, its best node, and the limit it
+ *  reached, if any.
+ */
+struct DistRound
+{
+	int64_t explored;
+	int64_t generated;
+	int64_t duplicates;
+	int64_t fringe;
+	int64_t nodes;
+	int64_t bytes;
+	int32_t queued;
+	int32_t min_key;
+	uint32_t goal;
+	int32_t goal_tie;
+	uint32_t best;
+	int32_t best_goals;
+	int32_t best_hscore;
+	int32_t limit;
+	int32_t deadlocks_learned;
+	int32_t deadlocks_pruned;
+}; //struct DistRound
+
+/* DistNode is a worker's answer about one of its nodes: the worker and
+ *  index of its parent (-1 for the root), its counts, and then its moves
+ *  from the parent and, for DIST_GOAL, its level string.
+ */
+struct DistNode
+{
+	int32_t parent_worker;
+	uint32_t parent_index;
+	int32_t depth;
+	int32_t moves;
+	int32_t pushes;
+	int32_t total_cost;
+	int32_t hscore;
+	uint32_t path_len;
+}; //struct DistNode
+
+/* Function used to write all of a buffer to a socket, blocking until it
+ *  is written.  A closed peer is an error, not a signal.
+ *
+ * Preconditions: socket, bytes to write
+ * Postconditions: returns true if every byte was written
+ */
+bool send_all(const int fd, const char *data, std::string::size_type size)
+{
+	while (size > 0)
+	{
+		ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return false;
+		data += sent;
+		size -= sent;
+	}
+	return true;
+} //bool send_all(const int fd, const char *data, std::string::size_type size)
+
+bool recv_all(const int fd, char *data, std::string::size_type size)
+{
+	while (size > 0)
+	{
+		ssize_t got = recv(fd, data, size, 0);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+			return false;
+		data += got;
+		size -= got;
+	}
+	return true;
+} //bool recv_all(const int fd, char *data, std::string::size_type size)
+
+/* Function used to append a frame to a buffer to be sent.
+ *
+ * Preconditions: buffer, dist_frame type, payload of the frame
+ * Postconditions: frame appended to out
+ */
+void put_frame(std::string &out, const int type, const std::string &payload)
+{
+	DistFrame frame;
+	frame.type = type;
+	frame.size = payload.size();
+	out.append((const char *)&frame, sizeof(frame));
+	out += payload;
+} //void put_frame(std::string &out, const int type, const std::string &payload)
+
+bool send_frame(const int fd, const int type, const std::string &payload)
+{
+	std::string out;
+	put_frame(out, type, payload);
+	return send_all(fd, out.data(), out.size());
+} //bool send_frame(const int fd, const int type, const std::string &payload)
+
+bool recv_frame(const int fd, int &type, std::string &payload)
+{
+	DistFrame frame;
+	if (!recv_all(fd, (char *)&frame, sizeof(frame)))
+		return false;
+	type = frame.type;
+	payload.resize(frame.size);
+	return frame.size == 0 || recv_all(fd, &payload[0], frame.size);
+} //bool recv_frame(const int fd, int &type, std::string &payload)
+
+/* DistWorker is one worker process of distributed search.  It keeps the
+ *  nodes it owns in the arena, indexed and queued like uniform cost and
+ *  A* search do, with the worker and index of each node's parent beside
+ *  them, since the parent may be owned by another worker.  peers holds
+ *  the socket to every other worker, with the frames waiting to be sent
+ *  to it, the batch of children being filled for it, and what has been
+ *  read from it but not handled yet.
+ */
+template <class B>
+class DistWorker
+{
+public:
+	DistWorker(const Kernel<B> &kernel, NodeArena &arena, const int id, const int count,
+	 const std::vector<int> &peer_fds);
+	void add_root(const State &initial_state);
+	void run(const int coordinator);
+
+private:
+	struct Peer
+	{
+		int fd;
+		std::string out;
+		std::string::size_type sent;
+		std::string batch;
+		std::string in;
+		bool done;
+	};
+	const Kernel<B> &kernel;
+	NodeArena &arena;
+	int id;
+	int count;
+	int smode;
+	NodeIndex index;
+	BucketQueue open;
+	std::vector<char> status;
+	std::vector<int32_t> parent_worker;
+	std::vector<uint32_t> parent_index;
+	std::vector<Peer> peers;
+	std::string::size_type pending;
+	timeval start;
+	long node_share;
+	DistRound stat;
+	long stale_queued;
+	bool lost;
+
+	int key(const Successor<B> &node) const;
+	int owner(const Successor<B> &node) const;
+	void insert(const Successor<B> &node, const int from_worker, const uint32_t from_index);
+	void send_child(const Successor<B> &node, const int to, const uint32_t from_index);
+	void handle(const int type, const char *payload, const std::string::size_type size);
+	void pump(const bool wait);
+	void round(const int round_key);
+	std::string node_reply(const uint32_t node, const bool goal);
+}; //class DistWorker
+
+template <class B>
+DistWorker<B>::DistWorker(const Kernel<B> &kernel, NodeArena &arena, const int id,
+ const int count, const std::vector<int> &peer_fds)
+ : kernel(kernel), arena(arena), id(id), count(count), index(kernel.keyed()), pending(0),
+ stale_queued(0), lost(false)
+{
+	smode = kernel.options.search == BFS ? (int)NONE : kernel.options.search;
+	arena.reset(kernel.cells, kernel.keyed());
+	peers.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		peers[i].fd = peer_fds[i];
+		peers[i].sent = 0;
+		peers[i].done = false;
+	}
+	//the node limit is shared evenly between the workers
+	node_share = (kernel.options.node_limit + count - 1) / count;
+	memset(&stat, 0, sizeof(stat));
+	stat.goal = stat.best = NodeIndex::NOT_FOUND;
+	stat.best_goals = -1;
+	stat.limit = LIMIT_NONE;
+	gettimeofday(&start, NULL);
+}
+
+/* Function used to get the key a node is queued by: its depth for breadth
+ *  first search, its cost for uniform cost search, and its f score for A*
+ *  search.
+ *
+ * Preconditions: Successor object
+ * Postconditions: returns the key of the node
+ */
+template <class B>
+int DistWorker<B>::key(const Successor<B> &node) const
+{
+	if (smode == NONE)
+		return node.depth;
+	if (smode == UCS)
+		return node.total_cost;
+	return node.hscore;
+} //int DistWorker<B>::key(const Successor<B> &node) const
+
+/* Function used to find the worker owning a state, by a hash of the state
+ *  packed, or of its symmetry key on symmetric levels.
+ *
+ * Preconditions: Successor object with its key set
+ * Postconditions: returns the id of the owning worker
+ */
+template <class B>
+int DistWorker<B>::owner(const Successor<B> &node) const
+{
+	uint64_t packed[B::WORDS + 1], h = 0xcbf29ce484222325ULL;
+	arena.pack_key(node, packed);
+	for (int i = 0; i <= kernel.cells.words; i++)
+		h = (h ^ packed[i]) * 0x9E3779B97F4A7C15ULL;
+	return (int)((h >> 32) % count);
+} //int DistWorker<B>::owner(const Successor<B> &node) const
+
+/* Function used to add the initial state, by the worker owning it.
+ *
+ * Preconditions: initial State object of the search
+ * Postconditions: root queued if this worker owns it
+ */
+template <class B>
+void DistWorker<B>::add_root(const State &initial_state)
+{
+	Successor<B> root;
+	kernel.load(initial_state.state_str, root.state);
+	root.key = root.state;
+	root.depth = initial_state.depth;
+	root.moves = initial_state.moves;
+	root.pushes = initial_state.pushes;
+	root.total_cost = initial_state.total_cost;
+	root.hscore = initial_state.hscore;
+	if (kernel.keyed())
+		kernel.set_key(root);
+	//the root is counted by the coordinator, not as generated
+	if (owner(root) == id)
+	{
+		insert(root, -1, 0);
+		stat.generated--;
+	}
+} //void DistWorker<B>::add_root(const State &initial_state)
+
+/* Function used to add a node this worker owns, unless it holds the state
+ *  already.  Breadth first search keeps the first copy, the others keep a
+ *  cheaper copy the way uniform cost and A* search do.
+ *
+ * Preconditions: Successor object owned by this worker, worker and index
+ *  of its parent
+ * Postconditions: node indexed and queued if it is new or cheaper
+ */
+template <class B>
+void DistWorker<B>::insert(const Successor<B> &node, const int from_worker,
+ const uint32_t from_index)
+{
+	uint32_t seen = index.find(arena, node);
+	if (seen != NodeIndex::NOT_FOUND)
+	{
+		if (smode == NONE || !cheaper(kernel.options.costs, node, *arena.header(seen)))
+		{
+			stat.duplicates++;
+			return;
+		}
+		if (status[seen] == NODE_OPEN)
+			stale_queued++;
+		status[seen] = NODE_STALE;
+	}
+	stat.generated++;
+	//each node is its own root in the arena, its parent may be elsewhere
+	uint32_t added = arena.add(node, arena.size());
+	index.set(arena, node, added);
+	status.push_back(NODE_OPEN);
+	parent_worker.push_back(from_worker);
+	parent_index.push_back(from_index);
+	open.push(added, key(node), smode == NONE ? 0 : tie_key(kernel.options.costs, node));
+} //void DistWorker<B>::insert(const Successor<B> &node, const int from_worker, const uint32_t from_index)
+
+/* Function used to add a child to the batch of the worker owning it,
+ *  sending the batch once it is full.  Sending waits while too much is
+ *  waiting to be sent, reading from the other workers meanwhile, so two
+ *  workers sending to each other never both wait.
+ *
+ * Preconditions: Successor object, id of its owner, index of its parent
+ *  on this worker
+ * Postconditions: child batched or sent
+ */
+template <class B>
+void DistWorker<B>::send_child(const Successor<B> &node, const int to, const uint32_t from_index)
+{
+	Peer &peer = peers[to];
+	DistChild child;
+	uint64_t packed[B::WORDS + 1];
+
+	child.depth = node.depth;
+	child.moves = node.moves;
+	child.pushes = node.pushes;
+	child.total_cost = node.total_cost;
+	child.hscore = node.hscore;
+	child.parent_worker = id;
+	child.parent_index = from_index;
+	child.path_len = node.path.size();
+	arena.pack(node.state, packed);
+	peer.batch.append((const char *)&child, sizeof(child));
+	peer.batch.append((const char *)packed, (kernel.cells.words + 1) * sizeof(uint64_t));
+	peer.batch += node.path;
+	if (peer.batch.size() < DIST_BATCH)
+		return;
+	put_frame(peer.out, DIST_CHILDREN, peer.batch);
+	pending += peer.batch.size();
+	peer.batch.clear();
+	pump(false);
+	while (pending > DIST_PENDING && !lost)
+		pump(true);
+} //void DistWorker<B>::send_child(const Successor<B> &node, const int to, const uint32_t from_index)
+
+/* Function used to handle a frame from another worker: a batch of children
+ *  to add, or the end of its round.
+ *
+ * Preconditions: dist_frame type, payload of the frame
+ * Postconditions: children added
+ */
+template <class B>
+void DistWorker<B>::handle(const int type, const char *payload, const std::string::size_type size)
+{
+	std::string::size_type state_len = (kernel.cells.words + 1) * sizeof(uint64_t);
+	Successor<B> node;
+	uint64_t packed[B::WORDS + 1];
+
+	for (std::string::size_type pos = 0; type == DIST_CHILDREN && pos < size; )
+	{
+		DistChild child;
+		memcpy(&child, payload + pos, sizeof(child));
+		memcpy(packed, payload + pos + sizeof(child), state_len);
+		arena.unpack(packed, node.state);
+		node.key = node.state;
+		if (kernel.keyed())
+			kernel.set_key(node);
+		node.path.assign(payload + pos + sizeof(child) + state_len, child.path_len);
+		node.depth = child.depth;
+		node.moves = child.moves;
+		node.pushes = child.pushes;
+		node.total_cost = child.total_cost;
+		node.hscore = child.hscore;
+		insert(node, child.parent_worker, child.parent_index);
+		pos += sizeof(child) + state_len + child.path_len;
+	}
+} //void DistWorker<B>::handle(const int type, const char *payload, const std::string::size_type size)
+
+/* Function used to send and receive what the sockets to the other workers
+ *  allow without blocking, or, if wait is set, to wait until one of them
+ *  is ready first.  A worker that closed its socket has stopped, and so
+ *  does the search.
+ *
+ * Preconditions: true to wait for a socket to be ready
+ * Postconditions: frames sent, frames received handled, lost set if a
+ *  worker stopped
+ */
+template <class B>
+void DistWorker<B>::pump(const bool wait)
+{
+	std::vector<pollfd> fds;
+	std::vector<int> which;
+	for (int i = 0; i < count; i++)
+	{
+		if (i == id)
+			continue;
+		pollfd fd;
+		fd.fd = peers[i].fd;
+		fd.events = POLLIN | (peers[i].sent < peers[i].out.size() ? POLLOUT : 0);
+		fd.revents = 0;
+		fds.push_back(fd);
+		which.push_back(i);
+	}
+	if (poll(&fds[0], fds.size(), wait ? -1 : 0) < 0)
+	{
+		lost = errno != EINTR;
+		return;
+	}
+
+	for (std::vector<pollfd>::size_type i = 0; i < fds.size(); i++)
+	{
+		Peer &peer = peers[which[i]];
+		if (fds[i].revents & POLLOUT)
+		{
+			ssize_t sent = send(peer.fd, peer.out.data() + peer.sent, peer.out.size() - peer.sent,
+			 MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (sent < 0 && errno != EAGAIN && errno != EINTR)
+				lost = true;
+			if (sent > 0)
+			{
+				peer.sent += sent;
+				pending -= std::min(pending, (std::string::size_type)sent);
+			}
+			if (peer.sent == peer.out.size())
+			{
+				peer.out.clear();
+				peer.sent = 0;
+			}
+		}
+		if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+		{
+			char buffer[65536];
+			ssize_t got = recv(peer.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+			if (got == 0 || (got < 0 && errno != EAGAIN && errno != EINTR))
+				lost = true;
+			if (got > 0)
+				peer.in.append(buffer, got);
+			//handle every whole frame read so far
+			std::string::size_type pos = 0;
+			DistFrame frame;
+			while (peer.in.size() - pos >= sizeof(frame))
+			{
+				memcpy(&frame, peer.in.data() + pos, sizeof(frame));
+				if (peer.in.size() - pos - sizeof(frame) < frame.size)
+					break;
+				if (frame.type == DIST_DONE)
+					peer.done = true;
+				handle(frame.type, peer.in.data() + pos + sizeof(frame), frame.size);
+				pos += sizeof(frame) + frame.size;
+			}
+			peer.in.erase(0, pos);
+		}
+	}
+} //void DistWorker<B>::pump(const bool wait)
+
+/* Function used to run one round: every node queued with the key of the
+ *  round is expanded, its children added or sent to their owners, and the
+ *  round ends once every other worker has sent all of its children of the
+ *  round.  A goal ends the search at the end of the round, and so does a
+ *  limit of the solve reached by this worker.
+ *
+ * Preconditions: key of the round
+ * Postconditions: stat holds the report of the round
+ */
+template <class B>
+void DistWorker<B>::round(const int round_key)
+{
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	std::vector<uint32_t> layer;
+	const SolverOptions &options = kernel.options;
+
+	//children of this round with the same key wait for the next round
+	while (!open.empty() && open.min_key() == round_key)
+	{
+		uint32_t current = open.pop();
+		if (status[current] == NODE_STALE)
+			stale_queued--;
+		else
+			layer.push_back(current);
+	}
+	stat.goal = NodeIndex::NOT_FOUND;
+	for (std::vector<uint32_t>::size_type i = 0; i < layer.size() && !lost; i++)
+	{
+		uint32_t current = layer[i];
+		status[current] = NODE_CLOSED;
+		stat.explored++;
+		arena.load(current, current_state);
+		int goals = current_state.state.boxes.count_and(kernel.goals);
+		if (goals > stat.best_goals || (goals == stat.best_goals && current_state.hscore < stat.best_hscore))
+		{
+			stat.best = current;
+			stat.best_goals = goals;
+			stat.best_hscore = current_state.hscore;
+		}
+		if (kernel.is_goal(current_state.state))
+		{
+			int tie = tie_key(options.costs, current_state);
+			if (stat.goal == NodeIndex::NOT_FOUND || tie < stat.goal_tie)
+			{
+				stat.goal = current;
+				stat.goal_tie = tie;
+			}
+			continue;
+		}
+
+		//stop if this worker reached a limit of the solve
+		if (node_share > 0 && stat.explored >= node_share)
+			stat.limit = LIMIT_NODES;
+		else if (options.memory_limit > 0 && arena.bytes() >= options.memory_limit)
+			stat.limit = LIMIT_MEMORY;
+		else if (options.time_limit > 0 && (stat.explored & 255) == 0 &&
+		 seconds_since(start) >= options.time_limit)
+			stat.limit = LIMIT_TIME;
+		if (stat.limit != LIMIT_NONE)
+			break;
+
+		gen_valid_states(kernel, current_state, smode, valid_states);
+		for (typename std::vector< Successor<B> >::size_type j = 0; j < valid_states.size(); j++)
+		{
+			int to = owner(valid_states[j]);
+			if (to == id)
+				insert(valid_states[j], id, current);
+			else
+				send_child(valid_states[j], to, current);
+		}
+	}
+
+	//the last batches are followed by the end of the round
+	for (int i = 0; i < count; i++)
+	{
+		if (i == id)
+			continue;
+		if (!peers[i].batch.empty())
+			put_frame(peers[i].out, DIST_CHILDREN, peers[i].batch);
+		pending += peers[i].batch.size();
+		peers[i].batch.clear();
+		put_frame(peers[i].out, DIST_DONE, std::string());
+	}
+	while (!lost)
+	{
+		bool finished = true;
+		for (int i = 0; i < count; i++)
+			if (i != id && (!peers[i].done || !peers[i].out.empty()))
+				finished = false;
+		if (finished)
+			break;
+		pump(true);
+	}
+	for (int i = 0; i < count; i++)
+		peers[i].done = false;
+
+	stat.fringe = open.size() - stale_queued;
+	stat.queued = stat.fringe > 0;
+	//a round of only stale nodes drops them and expands nothing
+	stat.min_key = stat.queued ? open.min_key() : 0;
+	stat.nodes = arena.size();
+	stat.bytes = arena.bytes();
+	stat.deadlocks_learned = kernel.deadlocks_learned;
+	stat.deadlocks_pruned = kernel.deadlocks_pruned;
+} //void DistWorker<B>::round(const int round_key)
+
+/* Function used to answer the coordinator about a node: its parent and
+ *  moves, and for the goal or best node, its counts and level string.
+ *
+ * Preconditions: node index, true for the goal or best node
+ * Postconditions: returns the payload of the answer
+ */
+template <class B>
+std::string DistWorker<B>::node_reply(const uint32_t node, const bool goal)
+{
+	DistNode reply;
+	Successor<B> found;
+	std::string path;
+
+	if (node >= arena.size())
+		return std::string();
+	arena.load(node, found);
+	path = compact_moves(arena.move_list(node));
+	reply.parent_worker = parent_worker[node];
+	reply.parent_index = parent_index[node];
+	reply.depth = found.depth;
+	reply.moves = found.moves;
+	reply.pushes = found.pushes;
+	reply.total_cost = found.total_cost;
+	reply.hscore = found.hscore;
+	reply.path_len = path.size();
+	std::string payload((const char *)&reply, sizeof(reply));
+	payload += path;
+	if (goal)
+		payload += kernel.unload(found.state);
+	return payload;
+} //std::string DistWorker<B>::node_reply(const uint32_t node, const bool goal)
+
+/* Function used to serve the coordinator until it ends the search or a
+ *  socket is closed.
+ *
+ * Preconditions: socket to the coordinator
+ * Postconditions: search over
+ */
+template <class B>
+void DistWorker<B>::run(const int coordinator)
+{
+	int type;
+	std::string payload;
+
+	while (!lost && recv_frame(coordinator, type, payload))
+	{
+		std::string reply;
+		uint32_t value = 0;
+		if (payload.size() >= sizeof(value))
+			memcpy(&value, payload.data(), sizeof(value));
+		if (type == DIST_ROUND)
+		{
+			round((int)value);
+			reply.assign((const char *)&stat, sizeof(stat));
+		}
+		else if (type == DIST_TRACE || type == DIST_GOAL)
+			reply = node_reply(value, type == DIST_GOAL);
+		else
+			return;
+		if (lost || !send_frame(coordinator, type, reply))
+			return;
+	}
+} //void DistWorker<B>::run(const int coordinator)
+
+/* Function used to ask a worker about one of its nodes.
+ *
+ * Preconditions: socket to the worker, DIST_TRACE or DIST_GOAL, node
+ *  index, DistNode object, strings to store the moves and level in
+ * Postconditions: returns true if the worker answered
+ */
+bool ask_node(const int fd, const int type, const uint32_t node, DistNode &reply,
+ std::string &path, std::string &level)
+{
+	std::string payload;
+	int answer;
+
+	if (!send_frame(fd, type, std::string((const char *)&node, sizeof(node))) ||
+	 !recv_frame(fd, answer, payload) || answer != type || payload.size() < sizeof(reply))
+		return false;
+	memcpy(&reply, payload.data(), sizeof(reply));
+	if (payload.size() < sizeof(reply) + reply.path_len)
+		return false;
+	path.assign(payload, sizeof(reply), reply.path_len);
+	level.assign(payload, sizeof(reply) + reply.path_len, std::string::npos);
+	return true;
+} //bool ask_node(const int fd, const int type, const uint32_t node, DistNode &reply, std::string &path, std::string &level)
+
+/* Function used to collect a node found by distributed search into a
+ *  State, following its parents back to the root across the workers.
+ *
+ * Preconditions: sockets to the workers, worker and index of the node,
+ *  State object to fill in
+ * Postconditions: returns true if every worker on the path answered
+ */
+bool collect_node(const std::vector<int> &workers, int worker, uint32_t node, State &found)
+{
+	DistNode reply;
+	std::string path, level, moves;
+
+	if (!ask_node(workers[worker], DIST_GOAL, node, reply, path, found.state_str))
+		return false;
+	found.depth = reply.depth;
+	found.moves = reply.moves;
+	found.pushes = reply.pushes;
+	found.total_cost = reply.total_cost;
+	found.hscore = reply.hscore;
+	moves = path;
+	while (reply.parent_worker >= 0 && reply.parent_worker < (int)workers.size())
+	{
+		worker = reply.parent_worker;
+		node = reply.parent_index;
+		if (!ask_node(workers[worker], DIST_TRACE, node, reply, path, level))
+			return false;
+		moves.insert(0, path);
+	}
+	found.move_list.clear();
+	for (std::string::size_type i = 0; i < moves.size(); i++)
+		found.move_list.append(1, moves[i]) += ", ";
+	return true;
+} //bool collect_node(const std::vector<int> &workers, int worker, uint32_t node, State &found)
+
+/* Function used to end distributed search, stopping its workers and
+ *  waiting for them to exit.
+ *
+ * Preconditions: sockets to the workers and their process ids
+ * Postconditions: workers exited, sockets closed
+ */
+void stop_workers(const std::vector<int> &workers, const std::vector<pid_t> &pids, const bool kill_them)
+{
+	for (std::vector<int>::size_type i = 0; i < workers.size(); i++)
+	{
+		if (!kill_them)
+			send_frame(workers[i], DIST_QUIT, std::string());
+		close(workers[i]);
+	}
+	for (std::vector<pid_t>::size_type i = 0; i < pids.size(); i++)
+	{
+		if (kill_them)
+			kill(pids[i], SIGKILL);
+		while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR)
+			;
+	}
+} //void stop_workers(const std::vector<int> &workers, const std::vector<pid_t> &pids, const bool kill_them)
+
+/* Function used to start the workers of distributed search, each forked
+ *  with a socket to the coordinator and one to every other worker.  A
+ *  worker serves the coordinator and exits without returning.
+ *
+ * Preconditions: Kernel of the level, initial State object, NodeArena
+ *  each worker keeps its nodes in, vectors to store the sockets to the
+ *  workers and their process ids in
+ * Postconditions: returns true if every worker was started
+ */
+template <class B>
+bool start_workers(const Kernel<B> &kernel, const State &initial_state, NodeArena &arena,
+ std::vector<int> &workers, std::vector<pid_t> &pids)
+{
+	const int count = kernel.options.processes;
+	std::vector< std::vector<int> > mesh(count, std::vector<int>(count, -1));
+	std::vector<int> ends(count, -1);
+	bool made = true;
+
+	workers.assign(count, -1);
+	for (int i = 0; i < count && made; i++)
+	{
+		int sv[2];
+		made = socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0;
+		if (made)
+		{
+			workers[i] = sv[0];
+			ends[i] = sv[1];
+		}
+		for (int j = i + 1; j < count && made; j++)
+		{
+			made = socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0;
+			if (made)
+			{
+				mesh[i][j] = sv[0];
+				mesh[j][i] = sv[1];
+			}
+		}
+	}
+	//output buffered before the fork would be written by every worker
+	if (kernel.options.log)
+		kernel.options.log->flush();
+	std::cout.flush();
+	for (int i = 0; i < count && made; i++)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			//a worker keeps only its own sockets
+			for (int j = 0; j < count; j++)
+			{
+				if (workers[j] >= 0)
+					close(workers[j]);
+				if (j != i && ends[j] >= 0)
+					close(ends[j]);
+				for (int k = 0; k < count; k++)
+					if (j != i && mesh[j][k] >= 0)
+						close(mesh[j][k]);
+			}
+			DistWorker<B> worker(kernel, arena, i, count, mesh[i]);
+			worker.add_root(initial_state);
+			worker.run(ends[i]);
+			_exit(0);
+		}
+		if (pid < 0)
+			made = false;
+		else
+			pids.push_back(pid);
+	}
+	for (int i = 0; i < count; i++)
+	{
+		if (ends[i] >= 0)
+			close(ends[i]);
+		for (int j = 0; j < count; j++)
+			if (mesh[i][j] >= 0)
+				close(mesh[i][j]);
+	}
+	if (!made)
+	{
+		for (int i = 0; i < count; i++)
+			if (workers[i] < 0)
+				workers.resize(i);
+		stop_workers(workers, pids, true);
+	}
+	return made;
+} //bool start_workers(const Kernel<B> &kernel, const State &initial_state, NodeArena &arena, std::vector<int> &workers, std::vector<pid_t> &pids)
+
+/* Function executes breadth first search, uniform cost search or A* search
+ *  distributed over worker processes, see DistWorker.  The searches find
+ *  solutions as good as their single process versions, though not always
+ *  the same one of those, and their counts are the sums of the workers'.
+ *  The node limit is shared evenly between the workers, and the memory
+ *  limit holds for each of them.
+ *
+ * Preconditions: Takes in the Kernel of the level, a State object for
+ *  initial state of level, the NodeArena each worker stores its nodes in,
+ *  a copy of it after the fork, and a SearchStat object to fill in
+ * Postconditions: Returns false if the workers could not be started,
+ *  otherwise true with report filled in, with limit LIMIT_CANCEL and no
+ *  solution if a worker was lost
+ */
+template <class B>
+bool distributed(const Kernel<B> &kernel, State &initial_state, NodeArena &arena, SearchStat &report)
+{
+	const SolverOptions &options = kernel.options;
+	std::vector<int> workers;
+	std::vector<pid_t> pids;
+	std::vector<DistRound> stats(options.processes);
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 1;
+	report.node.state_str = "NULL";
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	report.arena_nodes = 0;
+	report.arena_bytes = 0;
+	timeval start;
+	gettimeofday(&start, NULL);
+
+	if (!start_workers(kernel, initial_state, arena, workers, pids))
+	{
+		if (options.log)
+			*options.log << "  Could not start " << options.processes
+				<< " worker processes, searching in one" << std::endl;
+		return false;
+	}
+	if (options.log)
+		*options.log << "  Distributed search: " << options.processes << " worker processes" << std::endl;
+
+	int round_key = options.search == BFS ? initial_state.depth :
+	 options.search == UCS ? initial_state.total_cost : initial_state.hscore;
+	bool lost = false, queued = true;
+	long logged = 0;
+	int goal_worker = -1, best_worker = -1;
+	while (queued && !lost)
+	{
+		std::string payload;
+		int type;
+		uint32_t value = round_key;
+		for (int i = 0; i < options.processes && !lost; i++)
+			lost = !send_frame(workers[i], DIST_ROUND, std::string((const char *)&value, sizeof(value)));
+		for (int i = 0; i < options.processes && !lost; i++)
+		{
+			lost = !recv_frame(workers[i], type, payload) || type != DIST_ROUND ||
+			 payload.size() != sizeof(DistRound);
+			if (!lost)
+				memcpy(&stats[i], payload.data(), sizeof(DistRound));
+		}
+		if (lost)
+			break;
+
+		//the round is over everywhere, so nothing is left in flight
+		long explored = 0;
+		queued = false;
+		for (int i = 0; i < options.processes; i++)
+		{
+			const DistRound &stat = stats[i];
+			explored += stat.explored;
+			if (stat.goal != NodeIndex::NOT_FOUND &&
+			 (goal_worker < 0 || stat.goal_tie < stats[goal_worker].goal_tie))
+				goal_worker = i;
+			if (stat.limit != LIMIT_NONE && report.limit == LIMIT_NONE)
+				report.limit = stat.limit;
+			if (stat.queued && (!queued || stat.min_key < round_key))
+				round_key = stat.min_key;
+			queued = queued || stat.queued;
+		}
+		//print out in case a long time is taken and wondering if it froze
+		if (explored / 5000 > logged / 5000 && options.log)
+			*options.log << "...explored " << explored / 5000 * 5000 << " nodes..." << std::endl;
+		logged = explored;
+		if (goal_worker >= 0)
+			break;
+		if (report.limit == LIMIT_NONE && options.cancel != NULL && *options.cancel)
+			report.limit = LIMIT_CANCEL;
+		if (report.limit == LIMIT_NONE && options.time_limit > 0 &&
+		 seconds_since(start) >= options.time_limit)
+			report.limit = LIMIT_TIME;
+		if (report.limit != LIMIT_NONE)
+			break;
+	}
+
+	for (int i = 0; i < options.processes && !lost; i++)
+	{
+		const DistRound &stat = stats[i];
+		report.explored_count += stat.explored;
+		report.node_count += stat.generated;
+		report.rep_node_count += stat.duplicates;
+		report.fringe_node += stat.fringe;
+		report.arena_nodes += stat.nodes;
+		report.arena_bytes += stat.bytes;
+		kernel.deadlocks_learned += stat.deadlocks_learned;
+		kernel.deadlocks_pruned += stat.deadlocks_pruned;
+		if (stat.best != NodeIndex::NOT_FOUND && (best_worker < 0 ||
+		 stat.best_goals > stats[best_worker].best_goals ||
+		 (stat.best_goals == stats[best_worker].best_goals &&
+		 stat.best_hscore < stats[best_worker].best_hscore)))
+			best_worker = i;
+	}
+	if (!lost && goal_worker >= 0)
+		lost = !collect_node(workers, goal_worker, stats[goal_worker].goal, report.node);
+	else if (!lost && report.limit != LIMIT_NONE && best_worker >= 0)
+	{
+		lost = !collect_node(workers, best_worker, stats[best_worker].best, report.best);
+		report.best_goals = stats[best_worker].best_goals;
+	}
+	stop_workers(workers, pids, lost);
+	if (lost)
+	{
+		if (options.log)
+			*options.log << "  A worker process was lost, search stopped" << std::endl;
+		report.node.state_str = report.best.state_str = "NULL";
+		report.limit = LIMIT_CANCEL;
+	}
+	return true;
+} //bool distributed(const Kernel<B> &kernel, State &initial_state, NodeArena &arena, SearchStat &report)
+
+/* Parallel best first search runs greedy best first search or A* search
+ *  on options.threads threads of the solving process, sharing one open
+ *  list and one set of nodes.  The open list is a MultiQueue, so threads
+ *  rarely wait on each other for it, at the price of not always expanding
+ *  the best node queued first.  Nodes live in NodeShards picked by a hash
+ *  of their state, so the duplicates of a state always meet in the same
+ *  shard.  Each thread builds its own Kernel of the level, whose counts
+ *  gen_valid_states updates.  Greedy best first search ends at the first
+ *  goal expanded.  A* search keeps the best goal expanded so far and only
+ *  ends once no node is queued or being expanded, dropping the nodes no
+ *  better than it by f score and tie breaking cost.  With h2, whose score
+ *  never overestimates the cost left of a solvable state, its solution is
+ *  then as good as the one of A* search on one thread.  h1 can score a
+ *  node on a cheaper path above the goal found first, so with h1 the
+ *  solution may cost more than on one thread.
+ */
+struct MultiEntry
+{
+	int key;
+	int tie;
+	uint64_t ref;
+}; //struct MultiEntry
+
+//std heaps keep the largest entry on top, so the order is reversed
+struct MultiLater
+{
+	bool operator()(const MultiEntry &a, const MultiEntry &b) const
+	{
+		return a.key > b.key || (a.key == b.key && a.tie > b.tie);
+	}
+}; //struct MultiLater
+
+/* MultiQueue is a relaxed priority queue of many binary heaps, each
+ *  behind its own lock.  push adds to a random heap whose lock is free,
+ *  and pop takes the top of the better of two random heaps, found by the
+ *  top of each heap kept where it can be read without its lock.  A pop
+ *  thus takes an entry near the best one, not always the best one: the
+ *  more heaps, the less threads wait on a lock, and the further from
+ *  strict order the pops are.  rank counts the entries queued that are
+ *  better than an entry popped, its rank error, with each heap searched
+ *  only below the entries better than it.
+ */
+class MultiQueue
+{
+public:
+	explicit MultiQueue(const int count);
+	~MultiQueue();
+	void push(const MultiEntry &entry, uint64_t &random);
+	bool pop(MultiEntry &entry, uint64_t &random);
+	long rank(const MultiEntry &entry);
+	long size();
+	int queues() const { return heaps.size(); }
+
+	//key then tie as one value, ties are never negative
+	static int64_t order(const MultiEntry &entry)
+	{
+		return (int64_t)entry.key * ((int64_t)1 << 32) + (uint32_t)entry.tie;
+	}
+
+private:
+	struct Heap
+	{
+		pthread_mutex_t lock;
+		std::vector<MultiEntry> entries;
+		volatile int64_t top;
+	};
+	static const int64_t EMPTY = 0x7fffffffffffffffLL;
+	std::vector<Heap> heaps;
+
+	Heap &pick(uint64_t &random);
+	void take(Heap &heap, MultiEntry &entry);
+
+	MultiQueue(const MultiQueue &);
+	MultiQueue &operator=(const MultiQueue &);
+}; //class MultiQueue
+
+MultiQueue::MultiQueue(const int count) : heaps(std::max(count, 1))
+{
+	for (std::vector<Heap>::size_type i = 0; i < heaps.size(); i++)
+	{
+		pthread_mutex_init(&heaps[i].lock, NULL);
+		heaps[i].top = EMPTY;
+	}
+}
+
+MultiQueue::~MultiQueue()
+{
+	for (std::vector<Heap>::size_type i = 0; i < heaps.size(); i++)
+		pthread_mutex_destroy(&heaps[i].lock);
+}
+
+//xorshift of the random state of a thread, picking one of the heaps
+MultiQueue::Heap &MultiQueue::pick(uint64_t &random)
+{
+	random ^= random << 13;
+	random ^= random >> 7;
+	random ^= random << 17;
+	return heaps[random % heaps.size()];
+}
+
+/* Function used to queue an entry on a random heap not locked by another
+ *  thread.
+ *
+ * Preconditions: entry to queue, random state of the thread
+ * Postconditions: entry queued
+ */
+void MultiQueue::push(const MultiEntry &entry, uint64_t &random)
+{
+	while (true)
+	{
+		Heap &heap = pick(random);
+		if (pthread_mutex_trylock(&heap.lock) != 0)
+			continue;
+		heap.entries.push_back(entry);
+		std::push_heap(heap.entries.begin(), heap.entries.end(), MultiLater());
+		heap.top = order(heap.entries.front());
+		pthread_mutex_unlock(&heap.lock);
+		return;
+	}
+} //void MultiQueue::push(const MultiEntry &entry, uint64_t &random)
+
+//pops the top of a locked heap that has one
+void MultiQueue::take(Heap &heap, MultiEntry &entry)
+{
+	entry = heap.entries.front();
+	std::pop_heap(heap.entries.begin(), heap.entries.end(), MultiLater());
+	heap.entries.pop_back();
+	heap.top = heap.entries.empty() ? EMPTY : order(heap.entries.front());
+}
+
+/* Function used to pop the top of the better of two random heaps.  If
+ *  both are empty, every heap is looked at before the queue is taken as
+ *  empty.
+ *
+ * Preconditions: entry to pop into, random state of the thread
+ * Postconditions: returns true with an entry popped, or false if every
+ *  heap was empty
+ */
+bool MultiQueue::pop(MultiEntry &entry, uint64_t &random)
+{
+	while (true)
+	{
+		Heap &first = pick(random), &second = pick(random);
+		Heap *heap = second.top < first.top ? &second : &first;
+		if (heap->top == EMPTY)
+		{
+			heap = NULL;
+			for (std::vector<Heap>::size_type i = 0; i < heaps.size() && heap == NULL; i++)
+				if (heaps[i].top != EMPTY)
+					heap = &heaps[i];
+			if (heap == NULL)
+				return false;
+			pthread_mutex_lock(&heap->lock);
+		}
+		else if (pthread_mutex_trylock(&heap->lock) != 0)
+			continue;
+		//another thread may have emptied it since its top was read
+		if (heap->entries.empty())
+		{
+			pthread_mutex_unlock(&heap->lock);
+			continue;
+		}
+		take(*heap, entry);
+		pthread_mutex_unlock(&heap->lock);
+		return true;
+	}
+} //bool MultiQueue::pop(MultiEntry &entry, uint64_t &random)
+
+/* Function used to count the entries queued that are better than an
+ *  entry, one heap at a time, so the count is only as exact as the heaps
+ *  stay still meanwhile.
+ *
+ * Preconditions: entry popped
+ * Postconditions: returns the entries better than it
+ */
+long MultiQueue::rank(const MultiEntry &entry)
+{
+	long better = 0;
+	std::vector<std::vector<MultiEntry>::size_type> stack;
+	for (std::vector<Heap>::size_type i = 0; i < heaps.size(); i++)
+	{
+		Heap &heap = heaps[i];
+		pthread_mutex_lock(&heap.lock);
+		stack.assign(1, 0);
+		while (!stack.empty())
+		{
+			std::vector<MultiEntry>::size_type at = stack.back();
+			stack.pop_back();
+			//entries below one no better than it are no better either
+			if (at >= heap.entries.size() || !MultiLater()(entry, heap.entries[at]))
+				continue;
+			better++;
+			stack.push_back(2 * at + 1);
+			stack.push_back(2 * at + 2);
+		}
+		pthread_mutex_unlock(&heap.lock);
+	}
+	return better;
+} //long MultiQueue::rank(const MultiEntry &entry)
+
+long MultiQueue::size()
+{
+	long total = 0;
+	for (std::vector<Heap>::size_type i = 0; i < heaps.size(); i++)
+	{
+		pthread_mutex_lock(&heaps[i].lock);
+		total += heaps[i].entries.size();
+		pthread_mutex_unlock(&heaps[i].lock);
+	}
+	return total;
+}
+
+/* NodeShard holds the nodes of parallel best first search whose state
+ *  hashes to it, in its own NodeArena and NodeIndex behind a lock, with
+ *  the node_status of each node and the reference of its parent, which may
+ *  be in another shard: the shard in the high 32 bits and the node index
+ *  in the low ones.  Each node is its own root in the arena.
+ */
+struct NodeShard
+{
+	pthread_mutex_t lock;
+	NodeArena arena;
+	NodeIndex index;
+	std::vector<char> status;
+	std::vector<uint64_t> parent;
+
+	explicit NodeShard(const bool keyed) : index(keyed) { pthread_mutex_init(&lock, NULL); }
+	~NodeShard() { pthread_mutex_destroy(&lock); }
+}; //struct NodeShard
+
+const uint64_t NO_PARENT = ~(uint64_t)0;
+
+/* ParallelSearch is one parallel best first search: what its threads
+ *  share, and run, the work of each thread.  The counts every thread
+ *  keeps are added in under lock when it ends, and so is its best node.
+ *  queued counts the nodes pushed and not yet done with, so the search is
+ *  over once no thread can pop a node and it is 0.  Every RANK_SAMPLE
+ *  nodes explored, the rank error of the node is counted.
+ */
+template <class B>
+class ParallelSearch
+{
+public:
+	ParallelSearch(const Kernel<B> &kernel, const LevelSymmetry &symmetry);
+	~ParallelSearch();
+	bool search(const State &initial_state, SearchStat &report);
+
+private:
+	static const long RANK_SAMPLE = 64;
+	const Kernel<B> &kernel;
+	const LevelSymmetry &symmetry;
+	const SolverOptions &options;
+	std::string level;
+	int smode;
+	MultiQueue open;
+	std::vector<NodeShard *> shards;
+	pthread_mutex_t lock;
+	timeval start;
+	volatile long queued;
+	volatile long explored;
+	volatile bool stop;
+	volatile int limit;
+	volatile int threads_started;
+	volatile int64_t goal_order;
+	uint64_t goal;
+	long generated;
+	long duplicates;
+	long stale_queued;
+	int deadlocks_learned;
+	int deadlocks_pruned;
+	uint64_t best;
+	int best_goals;
+	int best_hscore;
+	long rank_samples;
+	long rank_total;
+	long rank_max;
+
+	static void *start_thread(void *search);
+	void run();
+	bool insert(const Kernel<B> &own, const Successor<B> &node, const uint64_t from,
+	 uint64_t &random, long &repeats, long &stale);
+	int reached_limit(const long explored_now, const long mine);
+	void fill(const uint64_t ref, State &node) const;
+}; //class ParallelSearch
+
+template <class B>
+ParallelSearch<B>::ParallelSearch(const Kernel<B> &kernel, const LevelSymmetry &symmetry)
+ : kernel(kernel), symmetry(symmetry), options(kernel.options),
+ open(options.threads * std::max(options.queue_factor, 1)), queued(0), explored(0), stop(false),
+ limit(LIMIT_NONE), threads_started(0), goal_order(0x7fffffffffffffffLL), goal(NO_PARENT),
+ generated(0), duplicates(0), stale_queued(0), deadlocks_learned(0), deadlocks_pruned(0),
+ best(NO_PARENT), best_goals(-1), best_hscore(0), rank_samples(0), rank_total(0), rank_max(0)
+{
+	smode = options.search;
+	//enough shards that threads seldom want the same one
+	shards.resize(options.threads * 4);
+	for (std::vector<NodeShard *>::size_type i = 0; i < shards.size(); i++)
+	{
+		shards[i] = new NodeShard(kernel.keyed());
+		shards[i]->arena.reset(kernel.cells, kernel.keyed());
+	}
+	pthread_mutex_init(&lock, NULL);
+}
+
+template <class B>
+ParallelSearch<B>::~ParallelSearch()
+{
+	for (std::vector<NodeShard *>::size_type i = 0; i < shards.size(); i++)
+		delete shards[i];
+	pthread_mutex_destroy(&lock);
+}
+
+/* Function used to add a node to its shard and queue it, unless the shard
+ *  holds the state already.  Greedy best first search keeps the first
+ *  copy, A* search a cheaper copy, as it does on one thread.
+ *
+ * Preconditions: Kernel of the thread, Successor object, reference of its
+ *  parent, or NO_PARENT for the root, random state, duplicate and stale
+ *  counts of the thread
+ * Postconditions: returns true if the node was added and queued, false
+ *  if it was a duplicate
+ */
+template <class B>
+bool ParallelSearch<B>::insert(const Kernel<B> &own, const Successor<B> &node,
+ const uint64_t from, uint64_t &random, long &repeats, long &stale)
+{
+	uint64_t packed[B::WORDS + 1], h = 0xcbf29ce484222325ULL;
+	shards[0]->arena.pack_key(node, packed);
+	for (int i = 0; i <= own.cells.words; i++)
+		h = (h ^ packed[i]) * 0x9E3779B97F4A7C15ULL;
+	const uint64_t id = (h >> 32) % shards.size();
+	NodeShard &shard = *shards[id];
+
+	pthread_mutex_lock(&shard.lock);
+	uint32_t seen = shard.index.find(shard.arena, node);
+	if (seen != NodeIndex::NOT_FOUND)
+	{
+		if (smode == GBFSH1 || smode == GBFSH2 ||
+		 !cheaper(options.costs, node, *shard.arena.header(seen)))
+		{
+			pthread_mutex_unlock(&shard.lock);
+			repeats++;
+			return false;
+		}
+		if (shard.status[seen] == NODE_OPEN)
+			stale++;
+		shard.status[seen] = NODE_STALE;
+	}
+	uint32_t added = shard.arena.add(node, shard.arena.size());
+	shard.index.set(shard.arena, node, added);
+	shard.status.push_back(NODE_OPEN);
+	shard.parent.push_back(from);
+	pthread_mutex_unlock(&shard.lock);
+
+	MultiEntry entry;
+	entry.key = node.hscore;
+	entry.tie = (smode == GBFSH1 || smode == GBFSH2) ? 0 : tie_key(options.costs, node);
+	entry.ref = id << 32 | added;
+	__sync_fetch_and_add(&queued, 1);
+	open.push(entry, random);
+	return true;
+} //bool ParallelSearch<B>::insert(const Kernel<B> &own, const Successor<B> &node, const uint64_t from, uint64_t &random, long &repeats, long &stale)
+
+/* Function used to check the limits of the solve, the node limit against
+ *  the nodes explored by every thread, the others every 256 nodes of a
+ *  thread, memory being the bytes of every shard, its arena, index, node
+ *  status and parents, and of the entries queued.
+ *
+ * Preconditions: nodes explored by all threads and by this one
+ * Postconditions: returns the limit_kind reached, or LIMIT_NONE
+ */
+template <class B>
+int ParallelSearch<B>::reached_limit(const long explored_now, const long mine)
+{
+	if (options.node_limit > 0 && explored_now >= options.node_limit)
+		return LIMIT_NODES;
+	if ((mine & 255) != 0)
+		return LIMIT_NONE;
+	if (options.cancel != NULL && *options.cancel)
+		return LIMIT_CANCEL;
+	if (options.memory_limit > 0)
+	{
+		long bytes = open.size() * sizeof(MultiEntry);
+		for (std::vector<NodeShard *>::size_type i = 0; i < shards.size(); i++)
+		{
+			NodeShard &shard = *shards[i];
+			pthread_mutex_lock(&shard.lock);
+			bytes += shard.arena.bytes() + shard.index.bytes() + (long)shard.status.capacity() +
+			 (long)shard.parent.capacity() * sizeof(uint64_t);
+			pthread_mutex_unlock(&shard.lock);
+		}
+		if (bytes >= options.memory_limit)
+			return LIMIT_MEMORY;
+	}
+	if (options.time_limit > 0 && seconds_since(start) >= options.time_limit)
+		return LIMIT_TIME;
+	return LIMIT_NONE;
+} //int ParallelSearch<B>::reached_limit(const long explored_now, const long mine)
+
+template <class B>
+void *ParallelSearch<B>::start_thread(void *search)
+{
+	((ParallelSearch<B> *)search)->run();
+	return NULL;
+}
+
+/* Function used to run one thread of the search: pop a node, skip it if
+ *  a cheaper copy replaced it, and otherwise expand it, until the search
+ *  is over or stopped.
+ *
+ * Preconditions: root queued
+ * Postconditions: counts and best node of the thread added in
+ */
+template <class B>
+void ParallelSearch<B>::run()
+{
+	Kernel<B> own(level, symmetry, options, kernel.analysis);
+	Successor<B> current_state;
+	std::vector< Successor<B> > valid_states;
+	const bool greedy = smode == GBFSH1 || smode == GBFSH2;
+	long mine = 0, my_duplicates = 0, my_stale = 0, my_generated = 0;
+	uint64_t my_best = NO_PARENT;
+	int my_best_goals = -1, my_best_hscore = 0;
+	uint64_t random = 0x9E3779B97F4A7C15ULL * (__sync_add_and_fetch(&threads_started, 1) + 1);
+	MultiEntry entry;
+
+	while (!stop)
+	{
+		if (!open.pop(entry, random))
+		{
+			//a thread still expanding a node may queue more
+			if (queued == 0)
+				break;
+			sched_yield();
+			continue;
+		}
+		NodeShard &shard = *shards[entry.ref >> 32];
+		uint32_t current = (uint32_t)entry.ref;
+		pthread_mutex_lock(&shard.lock);
+		bool open_node = shard.status[current] == NODE_OPEN;
+		if (open_node)
+		{
+			shard.status[current] = NODE_CLOSED;
+			shard.arena.load(current, current_state);
+		}
+		pthread_mutex_unlock(&shard.lock);
+		if (!open_node)
+			my_stale--;
+		//nodes no better than the best goal can not lead to a better one
+		if (!open_node || (!greedy && MultiQueue::order(entry) >= goal_order))
+		{
+			__sync_fetch_and_sub(&queued, 1);
+			continue;
+		}
+
+		long explored_now = __sync_add_and_fetch(&explored, 1);
+		mine++;
+		if (explored_now % RANK_SAMPLE == 0)
+		{
+			long error = open.rank(entry);
+			pthread_mutex_lock(&lock);
+			rank_samples++;
+			rank_total += error;
+			rank_max = std::max(rank_max, error);
+			pthread_mutex_unlock(&lock);
+		}
+		if (explored_now % 5000 == 0 && options.log)
+		{
+			pthread_mutex_lock(&lock);
+			*options.log << "...explored " << explored_now << " nodes..." << std::endl;
+			pthread_mutex_unlock(&lock);
+		}
+		int goals = current_state.state.boxes.count_and(own.goals);
+		if (goals > my_best_goals || (goals == my_best_goals && current_state.hscore < my_best_hscore))
+		{
+			my_best = entry.ref;
+			my_best_goals = goals;
+			my_best_hscore = current_state.hscore;
+		}
+
+		if (own.is_goal(current_state.state))
+		{
+			pthread_mutex_lock(&lock);
+			if (MultiQueue::order(entry) < goal_order || goal == NO_PARENT)
+			{
+				goal = entry.ref;
+				goal_order = MultiQueue::order(entry);
+			}
+			if (greedy)
+				stop = true;
+			pthread_mutex_unlock(&lock);
+			__sync_fetch_and_sub(&queued, 1);
+			continue;
+		}
+
+		//stop every thread if the search reached a limit of the solve
+		int reached = reached_limit(explored_now, mine);
+		if (reached != LIMIT_NONE)
+		{
+			pthread_mutex_lock(&lock);
+			if (limit == LIMIT_NONE)
+				limit = reached;
+			stop = true;
+			pthread_mutex_unlock(&lock);
+			__sync_fetch_and_sub(&queued, 1);
+			break;
+		}
+
+		gen_valid_states(own, current_state, smode, valid_states);
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < valid_states.size(); i++)
+			if (insert(own, valid_states[i], entry.ref, random, my_duplicates, my_stale))
+				my_generated++;
+		__sync_fetch_and_sub(&queued, 1);
+	}
+
+	pthread_mutex_lock(&lock);
+	generated += my_generated;
+	duplicates += my_duplicates;
+	stale_queued += my_stale;
+	deadlocks_learned += own.deadlocks_learned;
+	deadlocks_pruned += own.deadlocks_pruned;
+	if (my_best != NO_PARENT && (my_best_goals > best_goals ||
+	 (my_best_goals == best_goals && my_best_hscore < best_hscore)))
+	{
+		best = my_best;
+		best_goals = my_best_goals;
+		best_hscore = my_best_hscore;
+	}
+	pthread_mutex_unlock(&lock);
+} //void ParallelSearch<B>::run()
+
+/* Function used to fill in a State from a node, with the moves from the
+ *  root, following parents from shard to shard.
+ *
+ * Preconditions: reference of the node, State object to fill
+ * Postconditions: node filled in
+ */
+template <class B>
+void ParallelSearch<B>::fill(const uint64_t ref, State &node) const
+{
+	Successor<B> found;
+	std::string path;
+	shards[ref >> 32]->arena.load((uint32_t)ref, found);
+	for (uint64_t at = ref; at != NO_PARENT; )
+	{
+		const NodeShard &shard = *shards[at >> 32];
+		path.insert(0, compact_moves(shard.arena.move_list((uint32_t)at)));
+		at = shard.parent[(uint32_t)at];
+	}
+	node.state_str = kernel.unload(found.state);
+	node.move_list.clear();
+	for (std::string::size_type i = 0; i < path.size(); i++)
+		node.move_list.append(1, path[i]) += ", ";
+	node.depth = found.depth;
+	node.moves = found.moves;
+	node.pushes = found.pushes;
+	node.total_cost = found.total_cost;
+	node.hscore = found.hscore;
+} //void ParallelSearch<B>::fill(const uint64_t ref, State &node) const
+
+/* Function used to run the search on its threads and report it.
+ *
+ * Preconditions: initial State object of the search, SearchStat object
+ *  to fill in
+ * Postconditions: returns false if no thread could be started, else
+ *  report filled in
+ */
+template <class B>
+bool ParallelSearch<B>::search(const State &initial_state, SearchStat &report)
+{
+	Successor<B> root;
+	std::vector<pthread_t> threads;
+	long root_duplicates = 0, root_stale = 0;
+	uint64_t random = 0x9E3779B97F4A7C15ULL;
+
+	gettimeofday(&start, NULL);
+	level = initial_state.state_str;
+	kernel.load(initial_state.state_str, root.state);
+	root.key = root.state;
+	root.depth = initial_state.depth;
+	root.moves = initial_state.moves;
+	root.pushes = initial_state.pushes;
+	root.total_cost = initial_state.total_cost;
+	root.hscore = initial_state.hscore;
+	if (kernel.keyed())
+		kernel.set_key(root);
+	insert(kernel, root, NO_PARENT, random, root_duplicates, root_stale);
+
+	for (int i = 0; i < options.threads; i++)
+	{
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, start_thread, this) == 0)
+			threads.push_back(thread);
+	}
+	if (threads.empty())
+		return false;
+	if (options.log)
+	{
+		pthread_mutex_lock(&lock);
+		*options.log << "  Parallel search: " << threads.size() << " threads, "
+			<< open.queues() << " queues" << std::endl;
+		pthread_mutex_unlock(&lock);
+	}
+	for (std::vector<pthread_t>::size_type i = 0; i < threads.size(); i++)
+		pthread_join(threads[i], NULL);
+
+	report.node_count = generated + 1;
+	report.rep_node_count = duplicates;
+	report.explored_count = explored;
+	report.fringe_node = open.size() - stale_queued;
+	report.limit = goal == NO_PARENT ? limit : (int)LIMIT_NONE;
+	report.node.state_str = "NULL";
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	report.arena_nodes = 0;
+	report.arena_bytes = 0;
+	for (std::vector<NodeShard *>::size_type i = 0; i < shards.size(); i++)
+	{
+		report.arena_nodes += shards[i]->arena.size();
+		report.arena_bytes += shards[i]->arena.bytes();
+	}
+	report.rank_samples = rank_samples;
+	report.rank_error = rank_samples > 0 ? (double)rank_total / rank_samples : 0;
+	report.rank_error_max = rank_max;
+	kernel.deadlocks_learned += deadlocks_learned;
+	kernel.deadlocks_pruned += deadlocks_pruned;
+	if (goal != NO_PARENT)
+		fill(goal, report.node);
+	else if (limit != LIMIT_NONE && best != NO_PARENT)
+	{
+		fill(best, report.best);
+		report.best_goals = best_goals;
+	}
+	return true;
+} //bool ParallelSearch<B>::search(const State &initial_state, SearchStat &report)
+
+/* Function used to run greedy best first search or A* search on
+ *  options.threads threads, see ParallelSearch.
+ *
+ * Preconditions: Kernel and symmetries of the level, a State object for
+ *  initial state of level, SearchStat object to fill in
+ * Postconditions: returns false if no thread could be started, so the
+ *  search is left to run on one, else report filled in
+ */
+template <class B>
+bool parallel(const Kernel<B> &kernel, const LevelSymmetry &symmetry, State &initial_state,
+ SearchStat &report)
+{
+	ParallelSearch<B> search(kernel, symmetry);
+	if (search.search(initial_state, report))
+		return true;
+	if (kernel.options.log)
+		*kernel.options.log << "  Could not start " << kernel.options.threads
+			<< " threads, searching on one" << std::endl;
+	return false;
+} //bool parallel(const Kernel<B> &kernel, const LevelSymmetry &symmetry, State &initial_state, SearchStat &report)
+
+/* Function used to run a search algorithm with the kernels compiled for
+ *  a board size.
+ * 
+ * Preconditions: State object for initial state of level, symmetries and
+ *  analysis of the level, options of the solve, the NodeArena to store
+ *  the nodes in, and the pattern database and visited set kept by the
+ *  Solver
+ * Postconditions: Returns a SearchStat object for search results stats
+ */
+template <class B>
+SearchStat run_search(State &init_state, const LevelSymmetry &symmetry,
+ const LevelAnalysis &analysis, const SolverOptions &options, NodeArena &arena,
+ PatternDb &patterns, VisitedSet &visited, StateTable &table, std::string &error)
+{
+	Kernel<B> kernel(init_state.state_str, symmetry, options, analysis);
+	std::string pattern_error;
+
+	//heuristics function 3 is the only one using the pattern database
+	if (options.pattern_boxes > 0 && (options.search == ARA ||
+	 (options.search == BEAM && options.beam_heuristic == 3)))
+	{
+		if (load_patterns(kernel, patterns, options, pattern_error))
+			kernel.patterns = &patterns;
+		else if (options.log)
+			*options.log << "  " << pattern_error << ", searching without it" << std::endl;
+	}
+
+	if (options.visited != visited_mode(options) && options.log)
+		*options.log << "  The fingerprint filter is only used by depth first and greedy best"
+			<< " first search, using the exact visited set" << std::endl;
+	if (options.log)
+		*options.log << "  Board kernel: " << (int)B::WIDTH << "x" << (int)B::HEIGHT
+			<< " (" << (int)B::WORDS << " bitboard words, " << bit_kernels.name
+			<< " bit kernels)" << std::endl;
+	SearchStat report;
+	//searches that can be distributed or threaded run in one process, on
+	//one thread, if the workers or threads cannot be started
+	bool searched = false, layered = false, threaded = false;
+	if (options.frontier_layers > 0 && (options.search == BFS || options.search == ASH1 ||
+	 options.search == ASH2))
+	{
+		report = frontier(kernel, init_state, options.search, arena);
+		searched = layered = true;
+	}
+	else if (options.processes > 1 && (options.search == BFS || options.search == UCS ||
+	 options.search == ASH1 || options.search == ASH2))
+		searched = distributed(kernel, init_state, arena, report);
+	else if (options.threads > 1 && (options.search == GBFSH1 || options.search == GBFSH2 ||
+	 options.search == ASH1 || options.search == ASH2))
+		searched = threaded = parallel(kernel, symmetry, init_state, report);
+	if (!searched)
+	switch (options.search)
+	{
+		case BFS:
+			report = bfs(kernel, init_state, arena, visited);
+			break;
+		case DFS:
+			report = dfs(kernel, init_state, arena, visited);
+			break;
+		case UCS:
+			report = ucs(kernel, init_state, arena);
+			break;
+		case ARA:
+			report = ara(kernel, init_state, arena);
+			break;
+		case BEAM:
+			report = beam(kernel, init_state, arena);
+			break;
+		case GBFSH1:
+		case GBFSH2:
+			report = gbfs(kernel, init_state, options.search, arena, visited);
+			break;
+		case RETRO:
+			report = retro(kernel, init_state, table, error);
+			break;
+		default:
+			report = as(kernel, init_state, options.search, arena);
+	}
+	report.deadlocks_learned = kernel.deadlocks_learned;
+	report.deadlocks_pruned = kernel.deadlocks_pruned;
+	if (!layered)
+		report.frontier_nodes = report.frontier_bytes = 0;
+	if (options.search != RETRO)
+		report.table_states = report.table_bytes = 0;
+	if (!threaded)
+	{
+		report.rank_samples = report.rank_error_max = 0;
+		report.rank_error = 0;
+	}
+	//searches scanning their lists leave the visited set empty
+	report.visited_states = report.visited_bytes = 0;
+	if (!searched && visited.mode() != VISITED_SCAN && (options.search == BFS ||
+	 options.search == DFS || options.search == GBFSH1 || options.search == GBFSH2))
+	{
+		report.visited_states = visited.size();
+		report.visited_bytes = visited.bytes();
+	}
+	return report;
+} //SearchStat run_search(State &init_state, const LevelSymmetry &symmetry, const LevelAnalysis &analysis, const SolverOptions &options, NodeArena &arena, PatternDb &patterns, VisitedSet &visited, StateTable &table, std::string &error)
+
+/* Function used to check if a level fits a board size, every line of the
+ *  level on a board row.
+ * 
+ * Preconditions: width of the longest line and number of lines of a level
+ * Postconditions: returns true if the level fits the board
+ */
+template <class B>
+bool fits_board(const int width, const int height)
+{
+	return width <= B::WIDTH && height <= B::HEIGHT;
+} //bool fits_board(const int width, const int height)
+
+/* Function used to choose the smallest board size a level fits, so small
+ *  levels are searched with fewer bitboard words.  Levels larger than
+ *  256x256 do not fit any board.
+ * 
+ * Preconditions: level string, int references to store the width of the
+ *  longest line and the number of lines in
+ * Postconditions: returns the board_size of the level, or BOARD_NONE
+ */
+int choose_board(const std::string &level, int &width, int &height)
+{
+	std::stringstream ss(level);
+	std::string line;
+
+	width = height = 0;
+	//lines are used as they are, trailing spaces included
+	while (getline(ss, line, '\n'))
+	{
+		if ((int)line.size() > width)
+			width = line.size();
+		height++;
+	}
+	if (fits_board<Board64>(width, height))
+		return BOARD64;
+	if (fits_board<Board128>(width, height))
+		return BOARD128;
+	if (fits_board<Board256>(width, height))
+		return BOARD256;
+	if (fits_board<Board1024>(width, height))
+		return BOARD1024;
+	if (fits_board<Board4096>(width, height))
+		return BOARD4096;
+	if (fits_board<Board16384>(width, height))
+		return BOARD16384;
+	if (fits_board<Board65536>(width, height))
+		return BOARD65536;
+	return BOARD_NONE;
+} //int choose_board(const std::string &level, int &width, int &height)
+
+/* Function used to run a search algorithm with the kernels of the board
+ *  size the level fits.
+ * 
+ * Preconditions: State object for initial state of level, symmetries and
+ *  analysis of the level, options of the solve, the NodeArena to store
+ *  the nodes in, the pattern database, visited set and state table kept
+ *  by the Solver, and a string to store an error in
+ * Postconditions: Returns a SearchStat object for search results stats,
+ *  error set if the level fits no board or has no state table
+ */
+SearchStat solve_level(State &init_state, const LevelSymmetry &symmetry,
+ const LevelAnalysis &analysis, const SolverOptions &options, NodeArena &arena,
+ PatternDb &patterns, VisitedSet &visited, StateTable &table, std::string &error)
+{
+	SearchStat report;
+	int width, height;
+
+	switch (choose_board(init_state.state_str, width, height))
+	{
+		case BOARD64:
+			return run_search<Board64>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD128:
+			return run_search<Board128>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD256:
+			return run_search<Board256>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD1024:
+			return run_search<Board1024>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD4096:
+			return run_search<Board4096>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD16384:
+			return run_search<Board16384>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+		case BOARD65536:
+			return run_search<Board65536>(init_state, symmetry, analysis, options, arena, patterns,
+			 visited, table, error);
+	}
+	std::stringstream ss;
+	ss << "Level is " << width << "x" << height << ", larger than the largest board of 256x256.";
+	error = ss.str();
+	report.limit = LIMIT_NONE;
+	report.best.state_str = "NULL";
+	report.best_goals = 0;
+	report.bound = 0;
+	report.beam_width = 0;
+	report.deadlocks_learned = report.deadlocks_pruned = 0;
+	report.visited_states = report.visited_bytes = 0;
+	report.frontier_nodes = report.frontier_bytes = 0;
+	report.table_states = report.table_bytes = 0;
+	report.rank_samples = report.rank_error_max = 0;
+	report.rank_error = 0;
+	report.rep_node_count = 0;
+	report.fringe_node = 0;
+	report.explored_count = 0;
+	report.node_count = 0;
+	report.node.state_str = "NULL";
+	report.arena_nodes = 0;
+	report.arena_bytes = 0;
+	return report;
+} //SearchStat solve_level(State &init_state, const LevelSymmetry &symmetry, const LevelAnalysis &analysis, const SolverOptions &options, NodeArena &arena, PatternDb &patterns, VisitedSet &visited, StateTable &table, std::string &error)
+
+/* Solution cache file layout.  The file starts with a CacheHeader, followed
+ *  by CACHE_SLOTS fixed size CacheSlot records used as an open addressing
+ *  hash table.  Solutions are stored with one char per move ('u', 'r', 'd',
+ *  'l') instead of the comma seperated move list.  A key of 0 marks an
+ *  empty slot.
+ */
+const char CACHE_MAGIC[8] = {'S', 'K', 'B', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t CACHE_VERSION = 1;
+const uint32_t CACHE_SLOTS = 1024;
+const uint32_t CACHE_PROBES = 8;
+const int CACHE_MAX_MOVES = 4064;
+
+struct CacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t slot_count;
+	char reserved[4080];
+}; //struct CacheHeader
+
+struct CacheSlot
+{
+	uint64_t key;
+	int32_t search_choice;
+	int32_t length;
+	int32_t moves;
+	int32_t pushes;
+	int32_t node_count;
+	int32_t explored_count;
+	char move_str[CACHE_MAX_MOVES];
+}; //struct CacheSlot
+
+/* SolutionCache holds the open file and the mapping of a solution cache.
+ *  The file is shared between solver processes through MAP_SHARED, and
+ *  access is serialized with flock, shared for lookups and exclusive for
+ *  stores.
+ */
+struct SolutionCache
+{
+	int fd;
+	CacheHeader *header;
+	CacheSlot *slots;
+	size_t map_size;
+}; //struct SolutionCache
+
+/* Function used to compute the solution cache key of a level.  The key is
+ *  a 64 bit FNV-1a hash of the canonical level, the search algorithm and
+ *  the move and push costs used by that algorithm, and every other option
+ *  that can change the solution found: macro moves, the weights of
+ *  anytime repairing A*, the width, heuristics and retry of beam search,
+ *  the pattern database, the visited set and its filter rate, and the
+ *  processes and threads searching.  A solution found with weaker options
+ *  is then never served to a solve with stronger ones.  Rotated and
+ *  mirrored copies of a level share a key, and solutions are stored in
+ *  canonical orientation.
+ * 
+ * Preconditions: string representing a level, options of the solve, int
+ *  reference to store the transform to canonical orientation in
+ * Postconditions: returns a non zero 64 bit key
+ */
+uint64_t level_key(const std::string &level, const SolverOptions &options, int &transform)
+{
+	std::stringstream ss;
+	std::string text;
+	uint64_t hash = 14695981039346656037ULL;
+	int move_cost, push_cost;
+
+	cost_model(options.costs, options.search, move_cost, push_cost);
+	ss << canonical_level(level, transform) << '\0' << options.search << ':'
+		<< options.costs.mode << ':' << move_cost << ',' << push_cost
+		<< (options.macro_moves ? ":m" : "") << ":ara" << options.ara_weight << ','
+		<< options.ara_step << ":beam" << options.beam_width << ',' << options.beam_heuristic
+		<< (options.beam_retry ? ",r" : "") << ":pdb" << options.pattern_boxes
+		<< ":visited" << options.visited;
+	if (options.visited == VISITED_FILTER)
+		ss << ',' << options.filter_rate;
+	ss << ":procs" << options.processes << ":threads" << options.threads << ','
+		<< options.queue_factor;
+	text = ss.str();
+	for (std::string::size_type i = 0; i < text.size(); i++)
+	{
+		hash ^= (unsigned char)text[i];
+		hash *= 1099511628211ULL;
+	}
+	//0 is used to mark empty slots
+	if (hash == 0)
+		hash = 1;
+	return hash;
+} //uint64_t level_key(const std::string &level, const SolverOptions &options, int &transform)
+
+/* Function used to replay a compact move string on a level.  Each move is
+ *  checked the same way gen_valid_states checks it, so a move into a wall
+ *  or a push into a wall or box makes the replay fail.
+ * 
+ * Preconditions: string representing a level, string of compact moves, and
+ *  a State object to store the final state in
+ * Postconditions: returns true and sets end_state if all moves are valid,
+ *  otherwise returns false
+ */
+bool replay_moves(const std::string &level, const std::string &moves, State &end_state)
+{
+	std::stringstream ss(level);
+	std::vector<std::string> rows;
+	std::string line;
+	int x = -1, y = -1;
+
+	end_state.move_list = "";
+	end_state.moves = end_state.pushes = end_state.depth =
+	end_state.total_cost = end_state.hscore = 0;
+
+	while (getline(ss, line, '\n'))
+	{
+		std::string::size_type pos = line.find_first_of("@+");
+		if (pos != std::string::npos)
+		{
+			x = pos;
+			y = rows.size();
+		}
+		rows.push_back(line);
+	}
+	if (x < 0)
+		return false;
+
+	for (std::string::size_type i = 0; i < moves.size(); i++)
+	{
+		int dx = 0, dy = 0;
+		switch (moves[i])
+		{
+			case 'u': dy = -1; break;
+			case 'r': dx = 1; break;
+			case 'd': dy = 1; break;
+			case 'l': dx = -1; break;
+			default: return false;
+		}
+		int nx = x + dx, ny = y + dy;
+		int bx = nx + dx, by = ny + dy;
+		if (ny < 0 || ny >= (int)rows.size() || nx < 0 || nx >= (int)rows[ny].size())
+			return false;
+		char next = rows[ny][nx];
+		if (next == '$' || next == '*')
+		{
+			//box has to be pushed onto an empty floor or an empty goal
+			if (by < 0 || by >= (int)rows.size() || bx < 0 || bx >= (int)rows[by].size())
+				return false;
+			char beyond = rows[by][bx];
+			if (beyond != ' ' && beyond != '.')
+				return false;
+			rows[by][bx] = (beyond == '.') ? '*' : '$';
+			next = (next == '*') ? '.' : ' ';
+			end_state.pushes++;
+		}
+		else if (next == ' ' || next == '.')
+			end_state.moves++;
+		else
+			return false;
+		rows[y][x] = (rows[y][x] == '+') ? '.' : ' ';
+		rows[ny][nx] = (next == '.') ? '+' : '@';
+		x = nx;
+		y = ny;
+		end_state.move_list.push_back(moves[i]);
+		end_state.move_list.append(", ");
+		end_state.depth++;
+	}
+
+	end_state.state_str = "";
+	for (std::vector<std::string>::size_type i = 0; i < rows.size(); i++)
+		end_state.state_str.append(rows[i]) += "\n";
+	return true;
+} //bool replay_moves(const std::string &level, const std::string &moves, State &end_state)
+
+/* Function used to unmap and close a solution cache.
+ * 
+ * Preconditions: SolutionCache object
+ * Postconditions: mapping and file are released
+ */
+void cache_close(SolutionCache &cache)
+{
+	if (cache.header != NULL)
+		munmap(cache.header, cache.map_size);
+	if (cache.fd >= 0)
+		close(cache.fd);
+	cache.header = NULL;
+	cache.slots = NULL;
+	cache.fd = -1;
+} //void cache_close(SolutionCache &cache)
+
+/* Function used to open or create a solution cache file and map it into
+ *  memory.  A new or empty file is sized and given a header while holding
+ *  an exclusive lock, so processes starting at the same time agree on the
+ *  layout.
+ * 
+ * Preconditions: SolutionCache object to set up, path of the cache file,
+ *  string to store the reason in if it can not be opened
+ * Postconditions: returns true if the cache is ready to use, otherwise
+ *  false with error set
+ */
+bool cache_open(SolutionCache &cache, const char *path, std::string &error)
+{
+	struct stat st;
+	cache.map_size = sizeof(CacheHeader) + CACHE_SLOTS * sizeof(CacheSlot);
+	cache.header = NULL;
+	cache.slots = NULL;
+	error = std::string("can not open ") + path;
+	cache.fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (cache.fd < 0)
+		return false;
+
+	flock(cache.fd, LOCK_EX);
+	if (fstat(cache.fd, &st) == 0 && st.st_size == 0)
+	{
+		CacheHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.version = CACHE_VERSION;
+		header.slot_count = CACHE_SLOTS;
+		if (ftruncate(cache.fd, cache.map_size) != 0 ||
+		 pwrite(cache.fd, &header, sizeof(header), 0) != sizeof(header))
+		{
+			flock(cache.fd, LOCK_UN);
+			close(cache.fd);
+			return false;
+		}
+	}
+	else if (fstat(cache.fd, &st) != 0 || st.st_size != (off_t)cache.map_size)
+	{
+		error = std::string("solution cache ") + path + " has an unknown size";
+		flock(cache.fd, LOCK_UN);
+		close(cache.fd);
+		return false;
+	}
+	flock(cache.fd, LOCK_UN);
+
+	void *map = mmap(NULL, cache.map_size, PROT_READ | PROT_WRITE, MAP_SHARED, cache.fd, 0);
+	if (map == MAP_FAILED)
+	{
+		close(cache.fd);
+		return false;
+	}
+	cache.header = (CacheHeader *)map;
+	cache.slots = (CacheSlot *)((char *)map + sizeof(CacheHeader));
+	if (memcmp(cache.header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+	 cache.header->version != CACHE_VERSION || cache.header->slot_count != CACHE_SLOTS)
+	{
+		error = std::string("solution cache ") + path + " is not a valid cache file";
+		cache_close(cache);
+		return false;
+	}
+	error.clear();
+	return true;
+} //bool cache_open(SolutionCache &cache, const char *path, std::string &error)
+
+/* Function used to find a solution in the cache.  The slot is copied out
+ *  while holding a shared lock, so a store from another process can not
+ *  be seen half written.
+ * 
+ * Preconditions: open SolutionCache object, cache key, and a CacheSlot
+ *  object to copy the entry into
+ * Postconditions: returns true if an entry with the key was found
+ */
+bool cache_lookup(SolutionCache &cache, const uint64_t key, CacheSlot &entry)
+{
+	bool found = false;
+	flock(cache.fd, LOCK_SH);
+	for (uint32_t i = 0; i < CACHE_PROBES; i++)
+	{
+		CacheSlot &slot = cache.slots[(key + i) % CACHE_SLOTS];
+		if (slot.key == key)
+		{
+			memcpy(&entry, &slot, sizeof(CacheSlot));
+			found = true;
+			break;
+		}
+		if (slot.key == 0)
+			break;
+	}
+	flock(cache.fd, LOCK_UN);
+	return found;
+} //bool cache_lookup(SolutionCache &cache, const uint64_t key, CacheSlot &entry)
+
+/* Function used to store a solution in the cache.  The first slot that is
+ *  empty or holds the same key is used.  If all probed slots are taken,
+ *  the home slot of the key is overwritten.  Solutions too long for a slot
+ *  are not stored.
+ * 
+ * Preconditions: open SolutionCache object, cache key, transform to the
+ *  canonical orientation, search algo, and the SearchStat object of a
+ *  successful search
+ * Postconditions: solution written to the cache file
+ */
+void cache_store(SolutionCache &cache, const uint64_t key, const int transform,
+ const int search_choice, const SearchStat &stat)
+{
+	std::string moves = transform_moves(compact_moves(stat.node.move_list), transform);
+	if (moves.size() > (std::string::size_type)CACHE_MAX_MOVES)
+		return;
+
+	flock(cache.fd, LOCK_EX);
+	CacheSlot *target = &cache.slots[key % CACHE_SLOTS];
+	for (uint32_t i = 0; i < CACHE_PROBES; i++)
+	{
+		CacheSlot &slot = cache.slots[(key + i) % CACHE_SLOTS];
+		if (slot.key == key || slot.key == 0)
+		{
+			target = &slot;
+			break;
+		}
+	}
+	//key written last so a reader never sees a key with a partial entry
+	target->key = 0;
+	target->search_choice = search_choice;
+	target->length = moves.size();
+	target->moves = stat.node.moves;
+	target->pushes = stat.node.pushes;
+	target->node_count = stat.node_count;
+	target->explored_count = stat.explored_count;
+	memset(target->move_str, 0, sizeof(target->move_str));
+	memcpy(target->move_str, moves.data(), moves.size());
+	target->key = key;
+	flock(cache.fd, LOCK_UN);
+} //void cache_store(SolutionCache &cache, const uint64_t key, const int transform, const int search_choice, const SearchStat &stat)
+
+/* Function used to replay a compact move string and keep every state
+ *  along the way, the initial state first.
+ * 
+ * Preconditions: LevelAnalysis of the level, level string, compact move
+ *  string of valid moves
+ * Postconditions: returns the state strings, one more than the moves
+ */
+std::vector<std::string> solution_states(const LevelAnalysis &la, const std::string &level,
+ const std::string &moves)
+{
+	const std::string order = "urdl";
+	const CostModel costs = {COST_DEFAULT, 1, 1};
+	std::vector<std::string> states;
+	State cur_state;
+	int player = level.find_first_of("@+");
+
+	cur_state.state_str = level;
+	cur_state.moves = cur_state.pushes = cur_state.total_cost = 0;
+	states.push_back(level);
+	for (std::string::size_type i = 0; i < moves.size(); i++)
+	{
+		macro_step(la, costs, cur_state, player, order.find(moves[i]), NONE);
+		states.push_back(cur_state.state_str);
+	}
+	return states;
+} //std::vector<std::string> solution_states(const LevelAnalysis &la, const std::string &level, const std::string &moves)
+
+/* Function used to find the shortest walk of the player between 2 cells
+ *  with the boxes left where they are, using a breadth first search.
+ * 
+ * Preconditions: LevelAnalysis of the level, state string, start and end
+ *  cells of the player
+ * Postconditions: returns the compact moves of the walk, which is empty
+ *  if the cells are the same
+ */
+std::string shortest_walk(const LevelAnalysis &la, const std::string &str, const int from,
+ const int to)
+{
+	const std::string order = "urdl";
+	std::vector<int> parent(str.size(), -1), parent_dir(str.size(), -1);
+	std::deque<int> frontier;
+	std::string path;
+
+	parent[from] = from;
+	frontier.push_back(from);
+	while (!frontier.empty() && parent[to] < 0)
+	{
+		int cell = frontier.front();
+		frontier.pop_front();
+		for (int dir = 0; dir < 4; dir++)
+		{
+			int next = cell_step(la, cell, dir);
+			if (next < 0 || parent[next] >= 0 ||
+			 (str[next] != ' ' && str[next] != '.' && str[next] != '@' && str[next] != '+'))
+				continue;
+			parent[next] = cell;
+			parent_dir[next] = dir;
+			frontier.push_back(next);
+		}
+	}
+	for (int cell = to; cell != from; cell = parent[cell])
+		path.push_back(order[parent_dir[cell]]);
+	std::reverse(path.begin(), path.end());
+	return path;
+} //std::string shortest_walk(const LevelAnalysis &la, const std::string &str, const int from, const int to)
+
+/* Function used to replace each run of moves between pushes with the
+ *  shortest walk between the same cells.  The boxes do not move during
+ *  the run, so the state after it is the same.
+ * 
+ * Preconditions: LevelAnalysis of the level, level string, compact move
+ *  string of a solution, and an OptimizeStat object
+ * Postconditions: returns the solution with shortened walks
+ */
+std::string shorten_walks(const LevelAnalysis &la, const std::string &level,
+ const std::string &moves, OptimizeStat &stat)
+{
+	const std::string order = "urdl";
+	std::vector<std::string> states = solution_states(la, level, moves);
+	std::string result;
+	std::string::size_type start = 0;
+
+	for (std::string::size_type i = 0; i <= moves.size(); i++)
+	{
+		//a run ends at a push, or at the end of the solution
+		if (i < moves.size())
+		{
+			int next = cell_step(la, states[i].find_first_of("@+"), order.find(moves[i]));
+			if (states[i][next] != '$' && states[i][next] != '*')
+				continue;
+		}
+		int from = states[start].find_first_of("@+");
+		int to = states[i].find_first_of("@+");
+		std::string walk = shortest_walk(la, states[start], from, to);
+		if (walk.size() < i - start)
+			stat.walks_shortened++;
+		else
+			walk = moves.substr(start, i - start);
+		result.append(walk);
+		if (i < moves.size())
+			result.push_back(moves[i]);
+		start = i + 1;
+	}
+	return result;
+} //std::string shorten_walks(const LevelAnalysis &la, const std::string &level, const std::string &moves, OptimizeStat &stat)
+
+/* Function used to search for a shorter way between 2 states of a
+ *  solution, using a breadth first search limited to fewer moves than the
+ *  solution uses between them.  The last window of a solution may end on
+ *  any goal state, since where the player stands once the boxes are on
+ *  the goals does not matter.
+ * 
+ * Preconditions: LevelAnalysis of the level, start and end state strings,
+ *  true if any goal state ends the window, most moves allowed, an
+ *  OptimizeStat object, start time and time budget of the optimizer
+ * Postconditions: returns true and sets path to the compact moves of the
+ *  shortest way if one within max_depth moves is found
+ */
+bool window_search(const LevelAnalysis &la, const std::string &from, const std::string &to,
+ const bool any_goal, const int max_depth, std::string &path, OptimizeStat &stat,
+ const timeval &start, const double budget)
+{
+	const CostModel costs = {COST_DEFAULT, 1, 1};
+	std::deque<State> frontier;
+	std::set<std::string> visited;
+	State first;
+
+	first.state_str = from;
+	first.move_list = "";
+	first.moves = first.pushes = first.total_cost = first.depth = 0;
+	frontier.push_back(first);
+	visited.insert(from);
+	while (!frontier.empty())
+	{
+		State cur_state = frontier.front();
+		frontier.pop_front();
+		if (cur_state.depth >= max_depth)
+			break;
+		if ((++stat.node_count % 1024) == 0 && seconds_since(start) > budget)
+		{
+			stat.timed_out = true;
+			return false;
+		}
+		int player = cur_state.state_str.find_first_of("@+");
+		for (int dir = 0; dir < 4; dir++)
+		{
+			State next = cur_state;
+			int next_player = player;
+			if (!macro_step(la, costs, next, next_player, dir, NONE) ||
+			 !visited.insert(next.state_str).second)
+				continue;
+			next.depth++;
+			if (next.state_str == to || (any_goal && is_goal(next)))
+			{
+				path = compact_moves(next.move_list);
+				return true;
+			}
+			frontier.push_back(next);
+		}
+	}
+	return false;
+} //bool window_search(const LevelAnalysis &la, const std::string &from, const std::string &to, const bool any_goal, const int max_depth, std::string &path, OptimizeStat &stat, const timeval &start, const double budget)
+
+/* Function used to shorten a solution found by any search algorithm.
+ *  Moves made after the first goal state are cut, walks between pushes
+ *  are made as short as possible, then windows of the solution are
+ *  searched again for shorter ways between their first and last states,
+ *  starting with windows of 4 moves and doubling up to 64 moves.  After a
+ *  window is shortened, the walks are shortened again and the windows
+ *  start over.  The result is replayed and only used if
+ *  it is valid, reaches the goal, and is no longer than the solution.
+ * 
+ * Preconditions: level string, compact move string of a solution, time
+ *  budget in seconds, and an OptimizeStat object
+ * Postconditions: returns the optimized compact move string
+ */
+std::string optimize_solution(const std::string &level, const std::string &moves,
+ const double budget, OptimizeStat &stat)
+{
+	timeval start;
+	std::string best = moves;
+	State end_state;
+	LevelAnalysis la;
+	bool improved = true;
+
+	gettimeofday(&start, NULL);
+	stat.walks_shortened = stat.windows_searched = stat.windows_shortened = 0;
+	stat.node_count = 0;
+	stat.timed_out = false;
+	analyze_level(level, la);
+
+	while (improved && !stat.timed_out)
+	{
+		improved = false;
+		std::vector<std::string> states = solution_states(la, level, best);
+		//moves after the boxes are all on goals are wasted
+		for (std::string::size_type i = 0; i + 1 < states.size(); i++)
+		{
+			State reached;
+			reached.state_str = states[i];
+			if (is_goal(reached))
+			{
+				best.erase(i);
+				break;
+			}
+		}
+		best = shorten_walks(la, level, best, stat);
+		states = solution_states(la, level, best);
+		for (int width = 4; width <= 64 && !improved && !stat.timed_out; width *= 2)
+		{
+			for (int i = 0; i + 1 < (int)states.size() && !stat.timed_out; i += width / 2)
+			{
+				int j = std::min(i + width, (int)states.size() - 1);
+				std::string path;
+				stat.windows_searched++;
+				if (window_search(la, states[i], states[j], j + 1 == (int)states.size(), j - i - 1,
+				 path, stat, start, budget))
+				{
+					best = best.substr(0, i) + path + best.substr(j);
+					stat.windows_shortened++;
+					improved = true;
+					break;
+				}
+			}
+		}
+	}
+
+	if (!replay_moves(level, best, end_state) || !is_goal(end_state) ||
+	 best.size() > moves.size())
+		return moves;
+	return best;
+} //std::string optimize_solution(const std::string &level, const std::string &moves, const double budget, OptimizeStat &stat)
+
+/* Function used to time the player reachability flood fill against a
+ *  breadth first search over cells.  States are collected by expanding
+ *  the level breadth first, without checking for duplicates, and both
+ *  functions are run over all of them several times.  Their regions are
+ *  compared, and the time per state of each is reported.
+ * 
+ * Preconditions: State object for initial state of level, stream to print
+ *  the results to
+ * Postconditions: benchmark results printed
+ */
+template <class B>
+void bench_reach(const State &init_state, std::ostream &out)
+{
+	const typename std::vector< Successor<B> >::size_type STATE_COUNT = 20000;
+	const int PASSES = 20;
+	const SolverOptions options;
+	const LevelAnalysis analysis = LevelAnalysis();
+	Kernel<B> kernel(init_state.state_str, LevelSymmetry(), options, analysis);
+	std::vector< Successor<B> > states, valid_states;
+	Successor<B> root;
+	Bitboard<B> region, check;
+	timeval start;
+	double fill_time, bfs_time;
+	long cells = 0;
+
+	kernel.load(init_state.state_str, root.state);
+	root.depth = root.moves = root.pushes = root.total_cost = root.hscore = 0;
+	states.push_back(root);
+	for (typename std::vector< Successor<B> >::size_type i = 0;
+	 i < states.size() && states.size() < STATE_COUNT; i++)
+	{
+		gen_valid_states(kernel, states[i], NONE, valid_states);
+		states.insert(states.end(), valid_states.begin(), valid_states.end());
+	}
+
+	for (typename std::vector< Successor<B> >::size_type i = 0; i < states.size(); i++)
+	{
+		reachable(kernel, states[i].state, region);
+		reachable_bfs(kernel, states[i].state, check);
+		if (memcmp(region.word, check.word, sizeof(region.word)) != 0)
+		{
+			out << "  Flood fill and breadth first search differ on state "
+				<< i << ":" << std::endl << kernel.unload(states[i].state);
+			return;
+		}
+		cells += region.count_and(region);
+	}
+
+	gettimeofday(&start, NULL);
+	for (int pass = 0; pass < PASSES; pass++)
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < states.size(); i++)
+			reachable(kernel, states[i].state, region);
+	fill_time = seconds_since(start);
+	gettimeofday(&start, NULL);
+	for (int pass = 0; pass < PASSES; pass++)
+		for (typename std::vector< Successor<B> >::size_type i = 0; i < states.size(); i++)
+			reachable_bfs(kernel, states[i].state, check);
+	bfs_time = seconds_since(start);
+
+	out << "REACHABILITY BENCHMARK:" << std::endl;
+	out << "  Board kernel: " << (int)B::WIDTH << "x" << (int)B::HEIGHT
+		<< " (" << (int)B::WORDS << " bitboard words, " << bit_kernels.name
+		<< " bit kernels)" << std::endl;
+	out << "    # of states: " << states.size() << ", "
+		<< cells / (long)states.size() << " reachable cells on average" << std::endl;
+	out << "    flood fill: " << fill_time * 1e9 / (PASSES * states.size())
+		<< " ns per state" << std::endl;
+	out << "    breadth first search: " << bfs_time * 1e9 / (PASSES * states.size())
+		<< " ns per state" << std::endl;
+	out << "    speedup: " << bfs_time / fill_time << "x" << std::endl;
+} //void bench_reach(const State &init_state, std::ostream &out)
+
+/* Function used to read the -cost option.  Accepted values are "moves",
+ *  "pushes", or weights for a move and a push seperated by a comma, such
+ *  as "1,5".
+ * 
+ * Preconditions: option value string, CostModel object to set
+ * Postconditions: returns true and sets costs if value is valid
+ */
+bool parse_cost_model(const std::string &text, CostModel &costs)
+{
+	int move_weight, push_weight;
+	char extra;
+	if (text == "moves")
+		costs.mode = COST_MOVES;
+	else if (text == "pushes")
+		costs.mode = COST_PUSHES;
+	else if (sscanf(text.c_str(), "%d,%d%c", &move_weight, &push_weight, &extra) == 2 &&
+	 move_weight >= 0 && push_weight >= 0)
+	{
+		costs.mode = COST_WEIGHTED;
+		costs.move_weight = move_weight;
+		costs.push_weight = push_weight;
+	}
+	else
+		return false;
+	return true;
+} //bool parse_cost_model(const std::string &text, CostModel &costs)
+
+/* Function used to read the -visited option.  Accepted values are "scan",
+ *  "exact" and "filter".
+ * 
+ * Preconditions: option value string, visited_mode to set
+ * Postconditions: returns true and sets mode if value is valid
+ */
+bool parse_visited_mode(const std::string &text, int &mode)
+{
+	if (text == "scan")
+		mode = VISITED_SCAN;
+	else if (text == "exact")
+		mode = VISITED_EXACT;
+	else if (text == "filter")
+		mode = VISITED_FILTER;
+	else
+		return false;
+	return true;
+} //bool parse_visited_mode(const std::string &text, int &mode)
+
+/* Function used to describe the optimality criterion a search algorithm
+ *  orders its nodes by under the cost model, and whether a solution
+ *  found is sure to satisfy it.
+ * 
+ * Preconditions: options of the solve, SearchStat of the search
+ * Postconditions: returns the description to print
+ */
+std::string optimality(const SolverOptions &options, const SearchStat &stat)
+{
+	const int search_choice = options.search;
+	std::stringstream ss;
+	std::string reason;
+	int move_cost, push_cost;
+
+	cost_model(options.costs, search_choice, move_cost, push_cost);
+	switch (search_choice)
+	{
+		case BFS:
+		case RETRO:
+			ss << "fewest moves (pushes included)";
+			break;
+		case UCS:
+		case ASH1:
+		case ASH2:
+			if (options.costs.mode == COST_MOVES)
+				ss << "fewest moves (pushes included), then fewest pushes";
+			else if (options.costs.mode == COST_PUSHES)
+				ss << "fewest pushes, then fewest moves";
+			else
+				ss << "lowest cost, " << move_cost << " per move and "
+					<< push_cost << " per push";
+			if (search_choice == ASH1)
+				reason = "heuristics function 1 is not admissible";
+			break;
+		case ARA:
+			ss << "lowest cost, " << move_cost << " per move and " << push_cost << " per push";
+			//a search stopped early only knows how close its solution is
+			if (stat.limit != LIMIT_NONE)
+			{
+				std::stringstream within;
+				within << "search stopped by a limit, within " << stat.bound << " of it";
+				reason = within.str();
+			}
+			break;
+		default:
+			return "none, search algorithm is not optimal";
+	}
+	//the state table holds every state, macro moves or not
+	if (options.macro_moves && search_choice != RETRO)
+		reason = "macro moves skip states";
+	if (reason.empty())
+		ss << " (satisfied)";
+	else
+		ss << " (not guaranteed, " << reason << ")";
+	return ss.str();
+} //std::string optimality(const SolverOptions &options, const SearchStat &stat)
+
+/* Function used to name a search algorithm, as printed above its results.
+ * 
+ * Preconditions: int representing search algo
+ * Postconditions: returns the title of the search algorithm
+ */
+std::string search_title(const int search_choice)
+{
+	switch (search_choice)
+	{
+		case BFS:
+			return "BREADTH FIRST SEARCH";
+		case DFS:
+			return "DEPTH FIRST SEARCH";
+		case UCS:
+			return "UNIFORM COST SEARCH";
+		case GBFSH1:
+			return "GREEDY BEST FIRST SEARCH, HEURISTICS FUNCTION 1";
+		case GBFSH2:
+			return "GREEDY BEST FIRST SEARCH, HEURISTICS FUNCTION 2";
+		case ASH1:
+			return "A* SEARCH, HEURISTICS FUNCTION 1";
+		case ASH2:
+			return "A* SEARCH, HEURISTICS FUNCTION 2";
+		case ARA:
+			return "ANYTIME REPAIRING A* SEARCH";
+		case BEAM:
+			return "BEAM SEARCH";
+		case RETRO:
+			return "RETROGRADE STATE TABLE";
+	}
+	return "Unrecognized choice";
+} //std::string search_title(const int search_choice)
+
+/* Function used to name a solve_status, as the daemon reports it.
+ * 
+ * Preconditions: int representing a solve_status
+ * Postconditions: returns the name of the status
+ */
+const char *status_name(const int status)
+{
+	const char *names[] = {"solved", "unsolvable", "exhausted", "error"};
+	if (status < STATUS_SOLVED || status > STATUS_ERROR)
+		return "error";
+	return names[status];
+} //const char *status_name(const int status)
+
+/* Function used to name the limit that stopped a search.
+ * 
+ * Preconditions: int representing a limit_kind
+ * Postconditions: returns the name of the limit
+ */
+const char *limit_name(const int limit)
+{
+	const char *names[] = {"none", "time", "nodes", "memory", "cancel", "width"};
+	if (limit < LIMIT_NONE || limit > LIMIT_WIDTH)
+		return "none";
+	return names[limit];
+} //const char *limit_name(const int limit)
+
+/* Data is what a Solver keeps between solves: the loaded level trimmed to
+ *  the cells the player can reach, its symmetries and analysis, the
+ *  solution cache, the node arena and visited set reused by every search,
+ *  and the pattern database and state table of the last level searched
+ *  with one.
+ */
+struct Solver::Data
+{
+	std::string board;
+	LevelSymmetry symmetry;
+	LevelAnalysis analysis;
+	bool analyzed;
+	SolutionCache cache;
+	bool cache_open;
+	NodeArena arena;
+	VisitedSet visited;
+	PatternDb patterns;
+	StateTable table;
+
+	Data() : analyzed(false), cache_open(false)
+	{
+		cache.fd = -1;
+		cache.header = NULL;
+		cache.slots = NULL;
+		cache.map_size = 0;
+	}
+}; //struct Solver::Data
+
+Solver::Solver() : data(new Data)
+{
+	//bitboard operations use the widest vectors the CPU has, chosen for
+	//the whole process, so Solvers are made before threads are started
+	select_bit_kernels();
+}
+
+Solver::~Solver()
+{
+	close_cache();
+	close_patterns(data->patterns);
+	close_table(data->table);
+	delete data;
+}
+
+/* Function used to load a level to solve.  The level is in the text form
+ *  of a level file, without the size line, each line ending in '\n'.
+ *  Loading the level already loaded keeps what was worked out for it.
+ * 
+ * Preconditions: level string
+ * Postconditions: returns true if the level has a player, and the level
+ *  is loaded
+ */
+bool Solver::load_level(const std::string &level)
+{
+	if (level.find_first_of("@+") == std::string::npos)
+		return false;
+	//the symmetries and analysis of the level are kept warm
+	if (level == level_str)
+		return true;
+	level_str = level;
+	//searches run on the cells the player can reach
+	data->board = trim_level(level_str);
+	//symmetric copies of states are treated as duplicates
+	data->symmetry = find_symmetry(data->board);
+	data->analyzed = false;
+	return true;
+} //bool Solver::load_level(const std::string &level)
+
+/* Function used to open a solution cache file shared with other solvers.
+ * 
+ * Preconditions: path of the cache file, string to store an error in
+ * Postconditions: returns true if the cache is open, otherwise false with
+ *  error set
+ */
+bool Solver::open_cache(const char *path, std::string &error)
+{
+	close_cache();
+	data->cache_open = cache_open(data->cache, path, error);
+	return data->cache_open;
+} //bool Solver::open_cache(const char *path, std::string &error)
+
+void Solver::close_cache()
+{
+	if (data->cache_open)
+		cache_close(data->cache);
+	data->cache_open = false;
+}
+
+/* Function used to shorten the solution of a solve by the optimizer,
+ *  if the options give it a time budget, whether the solution was found
+ *  by a search or in the solution cache.
+ * 
+ * Preconditions: level string searched, options of the solve, solved
+ *  SolveResult object
+ * Postconditions: optimized, optimized_node, optimize and optimize_time
+ *  of result set
+ */
+void optimize_result(const std::string &level, const SolverOptions &options, SolveResult &result)
+{
+	timeval start;
+
+	if (options.optimize_budget <= 0 || !result.solved)
+		return;
+	std::string moves = compact_moves(result.stat.node.move_list);
+	gettimeofday(&start, NULL);
+	std::string optimized = optimize_solution(level, moves, options.optimize_budget,
+	 result.optimize);
+	result.optimize_time = seconds_since(start);
+	result.optimized = replay_moves(level, optimized, result.optimized_node);
+} //void optimize_result(const std::string &level, const SolverOptions &options, SolveResult &result)
+
+/* Function used to answer a solve from the solution cache.  A cached
+ *  solution is turned back from canonical orientation, then replayed on
+ *  the level and only used if it reaches the goal state, so hash
+ *  collisions or a damaged file fall back to searching.  Only searches
+ *  not stopped by a limit are stored, so the optimality is the one of the
+ *  search, and the optimizer runs on a hit as it does after a search.
+ * 
+ * Preconditions: SolveResult object to fill
+ * Postconditions: returns true and sets result on a hit, otherwise false
+ */
+bool Solver::lookup(SolveResult &result)
+{
+	timeval start;
+	CacheSlot entry;
+	State end_state;
+	int transform;
+
+	if (!data->cache_open || data->board.empty())
+		return false;
+	gettimeofday(&start, NULL);
+	uint64_t key = level_key(data->board, opts, transform);
+	if (!cache_lookup(data->cache, key, entry) || entry.search_choice != opts.search ||
+	 entry.length < 0 || entry.length > CACHE_MAX_MOVES)
+		return false;
+	std::string moves = transform_moves(std::string(entry.move_str, entry.length),
+	 transform, true);
+	if (!replay_moves(data->board, moves, end_state) || !is_goal(end_state))
+		return false;
+
+	result = SolveResult();
+	result.status = STATUS_SOLVED;
+	result.solved = result.from_cache = true;
+	result.stat.node = end_state;
+	result.stat.node_count = entry.node_count;
+	result.stat.explored_count = entry.explored_count;
+	result.optimality = optimality(opts, result.stat);
+	result.run_time = seconds_since(start);
+	optimize_result(data->board, opts, result);
+	return true;
+} //bool Solver::lookup(SolveResult &result)
+
+/* Function used to search the loaded level with the options set.  The
+ *  solution found is shortened by the optimizer if it has a time budget,
+ *  and stored in the solution cache if one is open and the search was
+ *  not stopped by a limit, the optimized solution in place of the one
+ *  found if it costs no more under the cost model of the search.
+ * 
+ * Preconditions: a level is loaded
+ * Postconditions: returns the SolveResult of the search
+ */
+SolveResult Solver::search()
+{
+	SolveResult result;
+	State init_state;
+	timeval start;
+	std::ostream *log = opts.log;
+
+	init_state.state_str = data->board;
+	init_state.move_list = "";
+	init_state.moves = init_state.pushes = init_state.total_cost =
+	init_state.depth = init_state.hscore = 0;
+	if (data->board.empty())
+	{
+		result.error = "No level loaded.";
+		return result;
+	}
+
+	if (log && !data->symmetry.transforms.empty())
+		*log << "Level has " << data->symmetry.transforms.size()
+			<< " grid symmetries, merging symmetric states." << std::endl;
+
+	//tunnels and goal room used for macro moves
+	if (opts.macro_moves)
+	{
+		int tunnels = 0;
+		if (!data->analyzed)
+			analyze_level(data->board, data->analysis);
+		data->analyzed = true;
+		for (std::vector<char>::size_type i = 0; i < data->analysis.tunnel.size(); i++)
+			if (data->analysis.tunnel[i])
+				tunnels++;
+		if (log)
+		{
+			*log << "Macro moves: " << tunnels << " tunnel cells, ";
+			if (data->analysis.entrance >= 0)
+				*log << "goal room with " << data->analysis.packing_order.size()
+					<< " goals." << std::endl;
+			else
+				*log << "no goal room." << std::endl;
+		}
+	}
+
+	if (log)
+		*log << search_title(opts.search) << ":" << std::endl;
+	gettimeofday(&start, NULL);
+	result.stat = solve_level(init_state, data->symmetry, data->analysis, opts, data->arena,
+	 data->patterns, data->visited, data->table, result.error);
+	result.run_time = seconds_since(start);
+	result.solved = result.stat.node.state_str != "NULL";
+	if (!result.error.empty())
+		result.status = STATUS_ERROR;
+	else if (result.solved)
+		result.status = STATUS_SOLVED;
+	else if (result.stat.limit != LIMIT_NONE)
+		result.status = STATUS_EXHAUSTED;
+	else
+		result.status = STATUS_UNSOLVABLE;
+	result.optimality = optimality(opts, result.stat);
+	if (result.status == STATUS_EXHAUSTED)
+		result.optimality = "none, search stopped by a limit";
+
+	//shorten the solution found within the optimizer time budget
+	optimize_result(data->board, opts, result);
+
+	//store solution for later solves of the same level, unless a limit
+	//stopped the search before it was sure of it
+	if (data->cache_open && result.solved && result.stat.limit == LIMIT_NONE)
+	{
+		int transform, move_cost, push_cost;
+		uint64_t key = level_key(data->board, opts, transform);
+		SearchStat stored = result.stat;
+		const State &found = result.stat.node, &shorter = result.optimized_node;
+		//the optimizer shortens moves, which may take more pushes
+		cost_model(opts.costs, opts.search, move_cost, push_cost);
+		if (result.optimized && shorter.moves * move_cost + shorter.pushes * push_cost <=
+		 found.moves * move_cost + found.pushes * push_cost)
+			stored.node = shorter;
+		cache_store(data->cache, key, transform, opts.search, stored);
+	}
+	return result;
+} //SolveResult Solver::search()
+
+/* Function used to solve the loaded level, from the solution cache if it
+ *  holds a solution, otherwise by searching.
+ * 
+ * Preconditions: a level is loaded
+ * Postconditions: returns the SolveResult
+ */
+SolveResult Solver::solve()
+{
+	SolveResult result;
+	if (lookup(result))
+		return result;
+	return search();
+} //SolveResult Solver::solve()
+
+/* Function used to run the reachability benchmark on the loaded level
+ *  with the kernels of the board size it fits.
+ * 
+ * Preconditions: a level is loaded, stream to print the results to
+ * Postconditions: benchmark results printed
+ */
+void Solver::bench_reachability(std::ostream &out)
+{
+	State init_state;
+	int width, height;
+
+	init_state.state_str = data->board;
+	switch (choose_board(data->board, width, height))
+	{
+		case BOARD64:
+			bench_reach<Board64>(init_state, out);
+			break;
+		case BOARD128:
+			bench_reach<Board128>(init_state, out);
+			break;
+		case BOARD256:
+			bench_reach<Board256>(init_state, out);
+			break;
+		case BOARD1024:
+			bench_reach<Board1024>(init_state, out);
+			break;
+		case BOARD4096:
+			bench_reach<Board4096>(init_state, out);
+			break;
+		case BOARD16384:
+			bench_reach<Board16384>(init_state, out);
+			break;
+		case BOARD65536:
+			bench_reach<Board65536>(init_state, out);
+			break;
+		default:
+			out << "  Level is " << width << "x" << height
+				<< ", larger than the largest board of 256x256." << std::endl;
+	}
+} //void Solver::bench_reachability(std::ostream &out)
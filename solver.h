@@ -0,0 +1,321 @@
+/*  Author: Tony Ling
+ *  Summary: Sokoban solver library.  A Solver loads a level from memory,
+ *   runs one of the search algorithms on it with the options chosen, and
+ *   returns a SolveResult with the solution and search stats.  A Solver
+ *   keeps its solution cache and node arena from one solve to the next,
+ *   so many levels can be solved in one process.  skb.cpp is the command
+ *   line program built on it.
+ *
+ *  Sokoban level character key:
+ *   	(empty) 	Empty floor
+ * 	#	(hash)  	Wall
+ * 	.	(period)	Empty goal
+ * 	@	(at)    	Player on floor
+ * 	+	(plus)		Player on goal
+ * 	$	(dollar)	Box on floor
+ * 	*	(asterisk)	Box on goal
+ */
+#ifndef SKB_SOLVER_H
+#define SKB_SOLVER_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+enum search_mode {NONE, UCS, GBFSH1, GBFSH2, ASH1, ASH2, BFS, DFS, ARA, BEAM, RETRO};
+enum cost_mode {COST_DEFAULT, COST_MOVES, COST_PUSHES, COST_WEIGHTED};
+enum limit_kind {LIMIT_NONE, LIMIT_TIME, LIMIT_NODES, LIMIT_MEMORY, LIMIT_CANCEL, LIMIT_WIDTH};
+enum solve_status {STATUS_SOLVED, STATUS_UNSOLVABLE, STATUS_EXHAUSTED, STATUS_ERROR};
+enum visited_mode {VISITED_SCAN, VISITED_EXACT, VISITED_FILTER};
+
+/* CostModel holds the cost model chosen with the -cost option for uniform
+ *  cost search and A* search.  Weights are only used by COST_WEIGHTED.
+ */
+struct CostModel
+{
+	int mode;
+	int move_weight;
+	int push_weight;
+}; //struct CostModel
+
+/* States contain the level, how many moves/pushes and move list to get
+ * to that state, and how deep that state is in node terms.
+ */
+struct State
+{
+	std::string state_str;
+	std::string move_list;
+	int depth;
+	int moves;
+	int pushes;
+	int total_cost;
+	int hscore;
+}; //struct State
+
+/* SearchStat used to count search algorithm information, such as amount
+ * of nodes, duplicate nodes, fringe nodes and explored nodes, and the
+ * nodes and bytes held by the search's node arena.  limit is the limit
+ * that stopped the search, if any, and best is then the best node it
+ * explored, with best_goals boxes on goals.  bound is only set by anytime
+ * repairing A* search: the solution costs at most bound times the lowest
+ * cost, 1 if it is optimal.  beam_width is the width of the last pass of
+ * beam search.  deadlocks_learned counts the box patterns the search
+ * proved unsolvable, and deadlocks_pruned the states it dropped as dead,
+ * both 0 without a DeadlockTable.  visited_states and visited_bytes are
+ * the states in the visited set of breadth first, depth first and greedy
+ * best first search and the bytes it took, both 0 if the search scanned
+ * its lists instead.  frontier_nodes and frontier_bytes are the most
+ * nodes frontier search held at once and the bytes they took with the
+ * states pushes reached, and its arena only holds the relays to rebuild
+ * the path from.  table_states and table_bytes are the states in the
+ * state table of retrograde search and the bytes it takes, and node_count
+ * is then the table entries read.  Greedy best first and A* search on
+ * more than one thread count the queued nodes better than a sample of the
+ * nodes they explore, rank_samples of them, with rank_error the mean count
+ * and rank_error_max the largest, all 0 on one thread.
+ */
+struct SearchStat
+{
+	State node;
+	int node_count;
+	int rep_node_count;
+	int fringe_node;
+	int explored_count;
+	uint32_t arena_nodes;
+	long arena_bytes;
+	int limit;
+	State best;
+	int best_goals;
+	double bound;
+	int beam_width;
+	int deadlocks_learned;
+	int deadlocks_pruned;
+	long visited_states;
+	long visited_bytes;
+	long frontier_nodes;
+	long frontier_bytes;
+	long table_states;
+	long table_bytes;
+	long rank_samples;
+	double rank_error;
+	long rank_error_max;
+}; //struct SearchStat
+
+/* OptimizeStat counts what the solution optimizer did.
+ */
+struct OptimizeStat
+{
+	int walks_shortened;
+	int windows_searched;
+	int windows_shortened;
+	long node_count;
+	bool timed_out;
+}; //struct OptimizeStat
+
+/* DeadlockTable remembers the patterns of a few boxes near each other,
+ *  with the region of the player, that small searches of only those boxes
+ *  proved unsolvable, or solvable, so a search does not prove them again
+ *  from other parents.  Entries are 64 bit fingerprints of the level, the
+ *  boxes and the player region, added with compare and swap, so Solvers
+ *  on any number of threads can share one table without a lock.  The
+ *  table holds 2^slot_bits entries and stops learning once full.
+ */
+class DeadlockTable
+{
+public:
+	enum verdict {UNKNOWN, DEAD, ALIVE};
+
+	explicit DeadlockTable(const int slot_bits = 20);
+	~DeadlockTable();
+	int find(const uint64_t key) const;
+	void add(const uint64_t key, const bool dead);
+	long size() const { return count; }
+	long bytes() const { return (long)(mask + 1) * sizeof(uint64_t); }
+
+private:
+	static const int PROBES = 16;
+	volatile uint64_t *slots;
+	uint64_t mask;
+	volatile long count;
+
+	DeadlockTable(const DeadlockTable &);
+	DeadlockTable &operator=(const DeadlockTable &);
+}; //class DeadlockTable
+
+/* SolverOptions are the choices of a solve: the search algorithm, the cost
+ *  model, macro moves, and the seconds the optimizer may run after the
+ *  search (0 to skip it).  The search stops early once it has run for
+ *  time_limit seconds, explored node_limit nodes, or its node arena, open
+ *  list, index and visited set hold memory_limit bytes, each unlimited if
+ *  0, or once *cancel is set by another thread.  Anytime repairing A*
+ *  search starts with its heuristics weighted by ara_weight and lowers
+ *  the weight by ara_step each pass, and calls improved, if set, with
+ *  each better solution it finds and its bound, passing improved_context
+ *  along.  Beam search keeps the beam_width best nodes of each depth by
+ *  heuristics function beam_heuristic (1, 2 or 3), and doubles the width
+ *  and searches again if it finds no solution and beam_retry is set.  If
+ *  deadlocks is set, every push is checked against the patterns it holds
+ *  and dropped if it leaves a dead one, and patterns not in it yet are
+ *  proven and added.
+ *  If pattern_boxes is 1 to 3, heuristics function 3 also scores states
+ *  by a pattern database of the costs of every set of that many boxes,
+ *  stored in and mapped from a file in pattern_dir, if it is set, so the
+ *  next solve of the level does not build it again.  RETRO builds the
+ *  state table of the level, the fewest moves to the goal from each of its
+ *  states, once, stored in pattern_dir as well, and answers every state of
+ *  the level from it, if the table fits memory_limit.  If processes is more
+ *  than 1, breadth first search, uniform cost search and A* search run on
+ *  that many worker processes forked for the search, each holding the
+ *  states of its share of the hash space.  Breadth first, depth first and
+ *  greedy best first search find duplicates by scanning their open and
+ *  closed lists with VISITED_SCAN, in an exact table of packed states
+ *  with VISITED_EXACT, or, for depth first and greedy best first search
+ *  only, in a filter of fingerprints with VISITED_FILTER, which takes a
+ *  new state as seen for about filter_rate of them.  The exact table is a
+ *  bitmap indexed by the rank of each state instead if one bit for every
+ *  state of the level fits in dense_limit bytes, 0 to always hash.  If
+ *  frontier_layers is more than 0, breadth first search and A* search run
+ *  in one process as frontier search, keeping the closed nodes of only
+ *  that many layers before the one being expanded, or of as many as a
+ *  step can change the f score of A* by if that is more, and rebuilding
+ *  the path by searching again between relay nodes.  The states reached
+ *  by a push are kept until each state a push into them comes from has
+ *  made it.  If threads is more than 1, greedy best first search and A*
+ *  search run on that many threads, popping nodes from threads times
+ *  queue_factor heaps, each pop taking the better top of two random
+ *  heaps, so more heaps per thread wait less on locks and stray further
+ *  from best first order.  If log is set, what
+ *  the solver does is written to it as it runs: the level analysis, the
+ *  search title, the board kernel and progress every 5000 explored nodes.
+ */
+struct SolverOptions
+{
+	int search;
+	CostModel costs;
+	bool macro_moves;
+	double optimize_budget;
+	double time_limit;
+	long node_limit;
+	long memory_limit;
+	const volatile bool *cancel;
+	double ara_weight;
+	double ara_step;
+	void (*improved)(const State &solution, const double bound, void *context);
+	void *improved_context;
+	int beam_width;
+	int beam_heuristic;
+	bool beam_retry;
+	DeadlockTable *deadlocks;
+	int pattern_boxes;
+	const char *pattern_dir;
+	int processes;
+	int visited;
+	double filter_rate;
+	long dense_limit;
+	int frontier_layers;
+	int threads;
+	int queue_factor;
+	std::ostream *log;
+
+	SolverOptions() : search(BFS), macro_moves(false), optimize_budget(0), time_limit(0),
+	 node_limit(0), memory_limit(0), cancel(NULL), ara_weight(3), ara_step(0.5), improved(NULL),
+	 improved_context(NULL), beam_width(1000), beam_heuristic(1), beam_retry(false), deadlocks(NULL),
+	 pattern_boxes(0), pattern_dir(NULL), processes(1), visited(VISITED_SCAN),
+	 filter_rate(0.001), dense_limit(16 << 20), frontier_layers(0), threads(1), queue_factor(2), log(NULL)
+	{
+		costs.mode = COST_DEFAULT;
+		costs.move_weight = costs.push_weight = 1;
+	}
+}; //struct SolverOptions
+
+/* SolveResult is what a solve returns.  status is a solve_status: solved,
+ *  unsolvable if the search ran out of states, exhausted if a limit
+ *  stopped it first, or error.  Anytime repairing A* search is solved if
+ *  it found a solution before a limit stopped it, with stat.limit set.  stat.node is the goal state, with the move
+ *  list of the solution, or "NULL" if none was found.  For a
+ *  solution from the cache, only the node and the node_count and
+ *  explored_count of the search that found it are set.  error is set if
+ *  the level could not be searched.  run_time is the seconds spent
+ *  searching, or looking up the cache.
+ */
+struct SolveResult
+{
+	int status;
+	bool solved;
+	bool from_cache;
+	std::string error;
+	SearchStat stat;
+	std::string optimality;
+	double run_time;
+	bool optimized;
+	State optimized_node;
+	OptimizeStat optimize;
+	double optimize_time;
+
+	SolveResult() : status(STATUS_ERROR), solved(false), from_cache(false), run_time(0), optimized(false),
+	 optimize_time(0)
+	{
+		stat.node.state_str = "NULL";
+		stat.node_count = stat.rep_node_count = stat.fringe_node = stat.explored_count = 0;
+		stat.arena_nodes = 0;
+		stat.arena_bytes = 0;
+		stat.limit = LIMIT_NONE;
+		stat.best.state_str = "NULL";
+		stat.best_goals = 0;
+		stat.bound = 0;
+		stat.beam_width = 0;
+		stat.deadlocks_learned = stat.deadlocks_pruned = 0;
+		stat.visited_states = stat.visited_bytes = 0;
+		stat.frontier_nodes = stat.frontier_bytes = 0;
+		stat.table_states = stat.table_bytes = 0;
+		stat.rank_samples = stat.rank_error_max = 0;
+		stat.rank_error = 0;
+		optimize.walks_shortened = optimize.windows_searched = optimize.windows_shortened = 0;
+		optimize.node_count = 0;
+		optimize.timed_out = false;
+	}
+}; //struct SolveResult
+
+/* Solver solves levels in memory.  A level is loaded with load_level, the
+ *  options are set through options(), and solve runs the search, checking
+ *  the solution cache first if one is open.  Searches run on the level
+ *  trimmed to the cells the player can reach, so the states of a result
+ *  are of the trimmed level, while level() is the level as loaded.  lookup and search are the
+ *  two halves of solve, for callers that report a cache hit differently.
+ *  A Solver is not shared between threads, but each thread can have its
+ *  own.
+ */
+class Solver
+{
+public:
+	Solver();
+	~Solver();
+	bool load_level(const std::string &level);
+	const std::string &level() const { return level_str; }
+	SolverOptions &options() { return opts; }
+	const SolverOptions &options() const { return opts; }
+	bool open_cache(const char *path, std::string &error);
+	void close_cache();
+	bool lookup(SolveResult &result);
+	SolveResult search();
+	SolveResult solve();
+	void bench_reachability(std::ostream &out);
+
+private:
+	struct Data;
+	std::string level_str;
+	SolverOptions opts;
+	Data *data;
+
+	Solver(const Solver &);
+	Solver &operator=(const Solver &);
+}; //class Solver
+
+bool parse_cost_model(const std::string &text, CostModel &costs);
+bool parse_visited_mode(const std::string &text, int &mode);
+std::string search_title(const int search_choice);
+const char *status_name(const int status);
+const char *limit_name(const int limit);
+std::string compact_moves(const std::string &move_list);
+
+#endif